@@ -7,48 +7,86 @@ static uint16_t ADC_read(const uint8_t PIN);
 /******************************************************************************
 * Funktionen new_TempSensor används för implementering av en temperatursensor 
 * ansluten till någon av analoga pinnar A0 - A5 via ett objekt av strukten
-* TempSensor. Ingående argument PIN utgör en pekare till aktuellt PIN-nummer. 
+* TempSensor. Ingående argument PIN utgör aktuellt PIN-nummer, medan model
+* utgör en pekare till sensorns modell för omvandling till temperatur. 
 * Ett objekt av strukten TempsSensor deklareras och döps till self, där sparas 
-* aktuellt PIN-nummer. AD-omvandlaren initieras sedan via anrop av statiska 
-* funktionen init_ADC. Sedan returneras objektet för användning.
+* aktuellt PIN-nummer och sensormodell. Kalibreringen sätts till neutral vid
+* start. AD-omvandlaren initieras sedan via anrop av statiska funktionen
+* init_ADC. Sedan returneras objektet för användning.
 ******************************************************************************/
-struct TempSensor new_TempSensor(const uint8_t PIN)
+struct TempSensor new_TempSensor(const uint8_t PIN, const struct SensorModel* model)
 {
 	struct TempSensor self;
 	self.PIN = PIN;
+	self.model = model;
+	self.calibration = new_SensorCalibration();
 	init_ADC();
 	return self;
 }
 
+/******************************************************************************
+* Funktionen TempSensor_convert används för att omvandla ett resultat från
+* AD-omvandlaren till temperatur mätt i tiondels grader Celcius. Först
+* beräknas temperaturen via sensorns modell, därefter korrigeras värdet
+* via sensorns kalibrering.
+******************************************************************************/
+int16_t TempSensor_convert(const struct TempSensor* self, const uint16_t ADC_result)
+{
+	const int16_t value = SensorModel_convert(self->model, ADC_result);
+	return SensorCalibration_apply(&self->calibration, value);
+}
+
+/******************************************************************************
+* Funktionen TempSensor_read används för att läsa av temperatursensorn och
+* returnera aktuell temperatur mätt i tiondels grader Celcius.
+******************************************************************************/
+int16_t TempSensor_read(const struct TempSensor* self)
+{
+	return TempSensor_convert(self, ADC_read(self->PIN));
+}
+
+/******************************************************************************
+* Funktionen TempSensor_calibrate används för tvåpunktskalibrering av en
+* temperatursensor. Ingående argument measured_low och measured_high utgör
+* avlästa temperaturer vid två referenspunkter (utan kalibrering), medan
+* actual_low och actual_high utgör verkliga temperaturer, samtliga mätta i
+* tiondels grader Celcius.
+******************************************************************************/
+void TempSensor_calibrate(struct TempSensor* self, const int16_t measured_low, const int16_t actual_low,
+	const int16_t measured_high, const int16_t actual_high)
+{
+	SensorCalibration_set(&self->calibration, measured_low, actual_low, measured_high, actual_high);
+	return;
+}
+
 /******************************************************************************
 * Funktionen print_temperature används för att läsa av rumstemperaturen och 
-* skriva till vår PC. Först läses temperatursensorn av och resultatet lagras 
-* i konstanten ADC_result. Därefter beräknas motsvarande analoga inspänning Uin 
-* med följande formel:
+* skriva till vår PC. Först läses temperaturen av i tiondels grader Celcius
+* via anrop av funktionen TempSensor_read. Sedan sammansätts textstycket
+* via anrop av funktionen TempSensor_format och transmitteras via
+* serial_print. Avläst temperatur (i tiondels grader) returneras,
+* exempelvis för lagring i historiken.
+******************************************************************************/
+int16_t print_temperature(const struct TempSensor* self)
+{
+	char text[SIZE];
+	const int16_t temperature = TempSensor_read(self);
+	TempSensor_format(temperature, text);
+	serial_print(text);
+	return temperature;
+}
 
-* input_voltage = Vcc * ADC_result / ADC_MAX,
-*
-* där ADC_result är resultatet från senaste AD-omvandling (0 - 1023).
-* Därefter beräknas motsvarande temperatur i grader Celcius via följande formel:
-*
-* temperatur = 100 * Uin - 50,
-*
-* där Uin är den beräknade analoga inspänningen (0 - 5 V).
-*
-* Temperaturen som beräknas lagras i konstanten temperature. Det värdet avrundas 
-* till närmsta heltal och lagras i konstanten rounded_temperature. Sedan 
-* transmitterras serial_print_integer, som möjliggör sammansättning av text och
-* heltal, samt seriell överföring. Med det klart så transmitteras 
-* textstycket: "Temperature: %ld degress Celcius\n".
-* %ld är en formatspecificerare för heltal och ersätts med avläst temperatur.
+/******************************************************************************
+* Funktionen TempSensor_format sammansätter textstycket "Temperature: %ld
+* degrees Celcius\n" i strängen text, som måste rymma SIZE tecken. Först
+* avrundas temperature, mätt i tiondels grader, till närmsta heltal och
+* lagras i konstanten rounded_temperature, som ersätter formatspecificeraren
+* %ld.
 ******************************************************************************/
-void print_temperature(const struct TempSensor* self)
+void TempSensor_format(const int16_t temperature, char* text)
 {
-	const uint16_t ADC_result = ADC_read(self->PIN);
-	const double input_voltage = VCC * (double)(ADC_result) / ADC_MAX; 
-	const double temperature = 100 * input_voltage - 50;
-	const int32_t rounded_temperature = (int32_t)(temperature + 0.5);
-	serial_print_integer("Temperature: %d degrees Celcius\n", rounded_temperature); 
+	const int16_t rounded_temperature = (temperature >= 0 ? temperature + 5 : temperature - 5) / 10;
+	snprintf(text, SIZE, "Temperature: %ld degrees Celcius\n", (long)rounded_temperature);
 	return;
 }
  
@@ -73,20 +111,49 @@ void print_temperature(const struct TempSensor* self)
  
   /******************************************************************************
 * Funktionen ADC_read används för att läsa av temperatursensorn och returnera 
-* resultatet. Först väljs analog kanal för avläsning, samtidigt som 
-* AD-omvandlaren sätts till att matas med intern matningsspänning. 
-* Därefter aktiveras AD-omvandlaren och startas med lägsta möjliga 
-* frekvens (125 kHz) för högsta möjliga precision. Därefter inväntar programmet
-* till att AD-omvandlingen är slutförd, vilket signaleras via AD-omvandlarens 
-* interrupt-flagga ADIF (ADC Interrupt Flag), som då blir ettställd. 
-* För att sedan återställa ADIF inför nästa AD-omvandlaren så ettställs denna, 
-* följt av att avläst resultat returneras vid återhoppet.
+* resultatet. Först startas AD-omvandlingen via anrop av funktionen
+* ADC_start. Därefter inväntar programmet till att AD-omvandlingen är
+* slutförd, varefter avläst resultat returneras via ADC_result.
  ******************************************************************************/
 static uint16_t ADC_read(const uint8_t PIN)
+{
+	ADC_start(PIN);
+	while (!ADC_ready());
+	return ADC_result();
+}
+
+/******************************************************************************
+* Funktionen ADC_start används för att starta en AD-omvandling utan att
+* invänta resultatet. Först väljs analog kanal för avläsning, samtidigt som
+* AD-omvandlaren sätts till att matas med intern matningsspänning. 
+* Därefter aktiveras AD-omvandlaren och startas med lägsta möjliga 
+* frekvens (125 kHz) för högsta möjliga precision.
+******************************************************************************/
+void ADC_start(const uint8_t PIN)
 {
 	ADMUX = (1 << REFS0) | PIN; 
 	ADCSRA = (1 << ADEN) | (1 << ADSC) | (1 << ADPS0) | (1 << ADPS1) | (1 << ADPS2); 
-	while ((ADCSRA & (1 << ADIF)) == 0); 
+	return;
+}
+
+/******************************************************************************
+* Funktionen ADC_ready returnerar true när påbörjad AD-omvandling är
+* slutförd, vilket signaleras via AD-omvandlarens interrupt-flagga ADIF
+* (ADC Interrupt Flag), som då blir ettställd. Funktionen används som
+* villkor vid väntan i protothreads (se Protothread.h).
+******************************************************************************/
+bool ADC_ready(void)
+{
+	return (ADCSRA & (1 << ADIF)) ? true : false;
+}
+
+/******************************************************************************
+* Funktionen ADC_result återställer ADIF inför nästa AD-omvandling genom
+* att denna ettställs, följt av att avläst resultat returneras. Funktionen
+* anropas när ADC_ready har returnerat true.
+******************************************************************************/
+uint16_t ADC_result(void)
+{
 	ADCSRA = (1 << ADIF); 
 	return ADC;
 }
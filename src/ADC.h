@@ -5,17 +5,20 @@
 // Inkluderingsdirektiv: 
 #include "definitions.h"
 #include "Serial.h"
+#include "SensorModel.h"
 
 /******************************************************************************
-* Formler för beräkning av temperatur:
+* Temperaturen beräknas utifrån resultatet från AD-omvandlingen via en
+* sensormodell (se SensorModel.h), bestående av en tabell av brytpunkter i
+* flashminnet där linjär interpolering sker med heltal. Därmed behövs ingen
+* flyttalsberäkning per avläsning, oavsett sensorns karakteristik. För den
+* linjära sensor som används som standard motsvarar modellen formlerna
 *
-* Analog inspänning Uin:
 * Uin = Vcc * ADC_result / ADC_max,
-* där ADC_result är resultatet från senaste AD-omvandling (0 - 1023).
-*
-* Temperatur temp i grader Celcius:
 * temp = 100 * Uin - 50,
-* där Uin är den beräknade analoga inspänningen (0 - 5 V).
+*
+* där ADC_result är resultatet från senaste AD-omvandling (0 - 1023) och
+* Uin är den beräknade analoga inspänningen (0 - 5 V).
 ******************************************************************************/
 
 #define VCC 5.0f // Matningsspänning 5 V.
@@ -40,15 +43,27 @@
 
 /******************************************************************************
 * Strukten TempSensor används för implementering av en temperatursensor
-* ansluten till en given analog PIN A0 - A5.
+* ansluten till en given analog PIN A0 - A5. Varje sensor refererar till en
+* sensormodell för omvandling av ADC-koder till temperatur, samt en
+* tvåpunktskalibrering som korrigerar modellens värden.
 ******************************************************************************/
 struct TempSensor 
 {
-	uint8_t PIN; // PIN-nummer för avläsning.
+	uint8_t PIN;					// PIN-nummer för avläsning.
+	const struct SensorModel* model;		// Sensormodell, brytpunkter lagrade i flashminnet.
+	struct SensorCalibration calibration;		// Tvåpunktskalibrering.
 };
 
 // Funktionsdeklarationer:
-struct TempSensor new_TempSensor(const uint8_t PIN);
-void print_temperature(const struct TempSensor* self); 
+struct TempSensor new_TempSensor(const uint8_t PIN, const struct SensorModel* model);
+int16_t TempSensor_read(const struct TempSensor* self);
+int16_t TempSensor_convert(const struct TempSensor* self, const uint16_t ADC_result);
+void TempSensor_calibrate(struct TempSensor* self, const int16_t measured_low, const int16_t actual_low,
+	const int16_t measured_high, const int16_t actual_high);
+int16_t print_temperature(const struct TempSensor* self);
+void TempSensor_format(const int16_t temperature, char* text);
+void ADC_start(const uint8_t PIN);
+bool ADC_ready(void);
+uint16_t ADC_result(void);
 
 #endif /* ADC_H_ */
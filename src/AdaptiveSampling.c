@@ -0,0 +1,130 @@
+// Inkluderingsdirektiv:
+#include "AdaptiveSampling.h"
+#include "Serial.h"
+#include <avr/pgmspace.h>
+
+#define ADAPTIVE_RATE_ONE (1L << ADAPTIVE_RATE_FRACTION)	// Takten 1 i fixpunkt.
+#define ADAPTIVE_MAX_DIFFERENCE 1000				// Största differens mätt i tiondels grader.
+
+// Statiska funktioner:
+static int32_t sample_rate(const int16_t difference, const uint32_t elapsed);
+static uint16_t next_scale(const struct AdaptiveSampling* self);
+
+/******************************************************************************
+* Funktionen new_AdaptiveSampling skapar en avstängd styrning med
+* skalfaktorn 1, där förändringstakten beräknas från andra avläsningen.
+******************************************************************************/
+struct AdaptiveSampling new_AdaptiveSampling(void)
+{
+	struct AdaptiveSampling self;
+	self.enabled = false;
+	self.initiated = false;
+	self.temperature = 0x00;
+	self.time = 0x00;
+	self.rate = 0x00;
+	self.scale = DYNAMIC_TIMER_SCALE_ONE;
+	return self;
+}
+
+/******************************************************************************
+* Funktionen AdaptiveSampling_update matar in en avläsning, mätt i tiondels
+* grader Celcius, och uppdaterar filtrerad förändringstakt samt
+* skalfaktorn. Funktionen returnerar true om skalfaktorn har ändrats, så
+* att den nya skalfaktorn skall tillämpas via DynamicTimer_set_scale.
+* Avläsningar med mindre än en millisekunds mellanrum ignoreras.
+******************************************************************************/
+bool AdaptiveSampling_update(struct AdaptiveSampling* self, const int16_t temperature)
+{
+	const uint32_t now = Clock_now();
+	const uint32_t elapsed = (now - self->time) / CLOCK_TICKS_PER_MS;
+
+	if (self->initiated && !elapsed) return false;
+
+	if (self->initiated)
+	{
+		const int32_t rate = sample_rate(temperature - self->temperature, elapsed);
+		self->rate += (rate - self->rate) / (1 << ADAPTIVE_RATE_SHIFT);
+	}
+
+	self->initiated = true;
+	self->temperature = temperature;
+	self->time = now;
+
+	const uint16_t scale = next_scale(self);
+	if (scale == self->scale) return false;
+	self->scale = scale;
+	return true;
+}
+
+/******************************************************************************
+* Funktionen AdaptiveSampling_enable aktiverar eller stänger av
+* styrningen. Skalfaktorn återställs till 1 i båda fallen, så att
+* styrningen startar från skattad fördröjningstid.
+******************************************************************************/
+void AdaptiveSampling_enable(struct AdaptiveSampling* self, const bool enabled)
+{
+	self->enabled = enabled;
+	self->scale = DYNAMIC_TIMER_SCALE_ONE;
+	return;
+}
+
+/******************************************************************************
+* Funktionen AdaptiveSampling_print skriver ut om styrningen är aktiverad,
+* filtrerad förändringstakt i grader per minut samt skalfaktorn i procent.
+******************************************************************************/
+void AdaptiveSampling_print(const struct AdaptiveSampling* self)
+{
+	const int32_t rate = self->rate / ADAPTIVE_RATE_ONE;
+	const uint32_t magnitude = (uint32_t)(rate < 0 ? -rate : rate);
+
+	serial_printf_P(PSTR("Adaptive: %s\n"), self->enabled ? "on" : "off");
+	serial_printf_P(PSTR("Rate: %s%lu.%lu C/min\n"), rate < 0 ? "-" : "",
+		(unsigned long)(magnitude / 10), (unsigned long)(magnitude % 10));
+	serial_printf_P(PSTR("Scale: %u%%\n"), (unsigned)((uint32_t)self->scale * 100 / DYNAMIC_TIMER_SCALE_ONE));
+	return;
+}
+
+/******************************************************************************
+* Funktionen sample_rate beräknar förändringstakten mellan två avläsningar
+* i tiondels grader per minut i fixpunkt, där difference utgör differensen
+* mellan avläsningarna och elapsed tiden mellan dem mätt i millisekunder.
+* Differensen minskas först med ADAPTIVE_DEADBAND och begränsas till
+* ADAPTIVE_MAX_DIFFERENCE, så att multiplikationen ryms i 32 bitar.
+******************************************************************************/
+static int32_t sample_rate(const int16_t difference, const uint32_t elapsed)
+{
+	int32_t change = difference < 0 ? -difference : difference;
+	change = change > ADAPTIVE_DEADBAND ? change - ADAPTIVE_DEADBAND : 0;
+	if (change > ADAPTIVE_MAX_DIFFERENCE) change = ADAPTIVE_MAX_DIFFERENCE;
+
+	const int32_t rate = (int32_t)((uint32_t)change * 60000UL * ADAPTIVE_RATE_ONE / elapsed);
+	return difference < 0 ? -rate : rate;
+}
+
+/******************************************************************************
+* Funktionen next_scale returnerar ny skalfaktor utifrån filtrerad
+* förändringstakt: halverad vid snabb förändring, ökad med en fjärdedel
+* vid stabil temperatur och annars oförändrad. Skalfaktorn är alltid 1 när
+* styrningen är avstängd.
+******************************************************************************/
+static uint16_t next_scale(const struct AdaptiveSampling* self)
+{
+	const int32_t rate = self->rate < 0 ? -self->rate : self->rate;
+	uint16_t scale = self->scale;
+
+	if (!self->enabled) return DYNAMIC_TIMER_SCALE_ONE;
+
+	if (rate > ADAPTIVE_RATE_HIGH * ADAPTIVE_RATE_ONE)
+	{
+		scale /= 2;
+		if (scale < ADAPTIVE_MIN_SCALE) scale = ADAPTIVE_MIN_SCALE;
+	}
+
+	else if (rate < ADAPTIVE_RATE_LOW * ADAPTIVE_RATE_ONE)
+	{
+		scale += scale / 4;
+		if (scale > ADAPTIVE_MAX_SCALE) scale = ADAPTIVE_MAX_SCALE;
+	}
+
+	return scale;
+}
@@ -0,0 +1,63 @@
+
+#ifndef ADAPTIVESAMPLING_H_
+#define ADAPTIVESAMPLING_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+#include "DynamicTimer.h"
+#include "Clock.h"
+
+/******************************************************************************
+* Strukten AdaptiveSampling styr den dynamiska timerns fördröjningstid
+* utifrån hur snabbt temperaturen ändras, så att avläsningar sker tätare
+* under snabba förlopp och glesare när temperaturen är stabil. Varje
+* avläsning matas in via AdaptiveSampling_update, varvid förändringstakten
+* beräknas i heltal:
+*
+* 1. Differensen mot föregående avläsning minskas med ADAPTIVE_DEADBAND
+*    tiondels grader, så att brus i enstaka steg hos AD-omvandlaren inte
+*    tolkas som en förändring.
+* 2. Förändringstakten beräknas i tiondels grader per minut i fixpunkt
+*    med ADAPTIVE_RATE_FRACTION decimalbitar, utifrån tiden mellan
+*    avläsningarna enligt klockan (se Clock.h).
+* 3. Takten filtreras via ett exponentiellt viktat glidande medelvärde med
+*    viktningen 1 / 2^ADAPTIVE_RATE_SHIFT för ny takt.
+*
+* Överstiger filtrerad takt (absolutbelopp) ADAPTIVE_RATE_HIGH halveras
+* skalfaktorn för fördröjningstiden, medan skalfaktorn ökas med en
+* fjärdedel när takten understiger ADAPTIVE_RATE_LOW. Skalfaktorn begränsas
+* till ADAPTIVE_MIN_SCALE - ADAPTIVE_MAX_SCALE i fixpunkt, där
+* DYNAMIC_TIMER_SCALE_ONE motsvarar 1, och tillämpas på fördröjningstiden
+* som skattas från knapptryckningarna via DynamicTimer_set_scale, vilken
+* även begränsar skalad fördröjningstid (se DynamicTimer.h).
+*
+* Styrningen är avstängd vid start, varvid skalfaktorn är 1, och aktiveras
+* via AdaptiveSampling_enable (konsolkommandot adapt). Förändringstakten
+* beräknas även när styrningen är avstängd.
+******************************************************************************/
+
+#define ADAPTIVE_DEADBAND 5		// Differens som ignoreras mätt i tiondels grader (ett steg hos AD-omvandlaren).
+#define ADAPTIVE_RATE_FRACTION 4	// Antal decimalbitar (fixpunkt) för förändringstakten.
+#define ADAPTIVE_RATE_SHIFT 2		// Viktning 1/4 för ny förändringstakt.
+#define ADAPTIVE_RATE_HIGH 10		// Snabb förändring mätt i tiondels grader per minut.
+#define ADAPTIVE_RATE_LOW 2		// Stabil temperatur mätt i tiondels grader per minut.
+#define ADAPTIVE_MIN_SCALE (DYNAMIC_TIMER_SCALE_ONE / 8)	// Kortaste fördröjningstid, 1/8 av skattad.
+#define ADAPTIVE_MAX_SCALE (DYNAMIC_TIMER_SCALE_ONE * 4)	// Längsta fördröjningstid, fyra gånger skattad.
+
+struct AdaptiveSampling
+{
+	bool enabled;			// Indikerar att styrningen är aktiverad.
+	bool initiated;			// Indikerar att en avläsning har matats in.
+	int16_t temperature;		// Föregående avläsning mätt i tiondels grader.
+	uint32_t time;			// Tidpunkt för föregående avläsning enligt klockan.
+	int32_t rate;			// Filtrerad förändringstakt i fixpunkt.
+	uint16_t scale;			// Aktuell skalfaktor för fördröjningstiden.
+};
+
+// Funktionsdeklarationer:
+struct AdaptiveSampling new_AdaptiveSampling(void);
+bool AdaptiveSampling_update(struct AdaptiveSampling* self, const int16_t temperature);
+void AdaptiveSampling_enable(struct AdaptiveSampling* self, const bool enabled);
+void AdaptiveSampling_print(const struct AdaptiveSampling* self);
+
+#endif /* ADAPTIVESAMPLING_H_ */
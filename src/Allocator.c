@@ -0,0 +1,301 @@
+// Inkluderingsdirektiv:
+#include "Allocator.h"
+#include "Serial.h"
+#include <string.h>
+
+#ifdef ENABLE_POOL_ALLOCATOR
+
+/******************************************************************************
+* Minnespoolerna lagras som statiska fält av pekare, vilket garanterar att
+* varje block är justerat för pekare och att varje block rymmer minst en
+* pekare, som används för att länka samman lediga block i en fri-lista.
+******************************************************************************/
+#define POOL_WORDS(size) ((size) / sizeof(void*))
+
+static void* pool16[POOL_BLOCKS_16][POOL_WORDS(16)];
+static void* pool32[POOL_BLOCKS_32][POOL_WORDS(32)];
+static void* pool64[POOL_BLOCKS_64][POOL_WORDS(64)];
+static void* pool128[POOL_BLOCKS_128][POOL_WORDS(128)];
+
+/******************************************************************************
+* Strukten PoolClass håller reda på en given blockstorlek. Lediga block som
+* har frigjorts länkas i en fri-lista, medan block som aldrig har använts tas
+* i tur och ordning via index next_unused. Därmed behövs ingen initiering av
+* fri-listan vid start och varje allokering sker i konstant tid.
+******************************************************************************/
+struct PoolClass
+{
+	void** start;			// Första block.
+	void** end;			// Adressen direkt efter sista block.
+	void* free_list;		// Första lediga frigjorda block.
+	uint8_t next_unused;		// Index för nästa block som aldrig har använts.
+	struct PoolClassStatistics statistics;
+};
+
+static struct PoolClass pool_classes[POOL_CLASSES] =
+{
+	{ pool16[0], pool16[POOL_BLOCKS_16], NULL, 0, { 16, POOL_BLOCKS_16, 0, 0, 0 } },
+	{ pool32[0], pool32[POOL_BLOCKS_32], NULL, 0, { 32, POOL_BLOCKS_32, 0, 0, 0 } },
+	{ pool64[0], pool64[POOL_BLOCKS_64], NULL, 0, { 64, POOL_BLOCKS_64, 0, 0, 0 } },
+	{ pool128[0], pool128[POOL_BLOCKS_128], NULL, 0, { 128, POOL_BLOCKS_128, 0, 0, 0 } },
+};
+
+static struct AllocatorStatistics pool_statistics = { 0, 0, 0 };
+
+// Statiska funktioner:
+static void* pool_allocate(const size_t size);
+static void* pool_reallocate(void* block, const size_t size);
+static void pool_deallocate(void* block);
+static struct PoolClass* pool_class_of(const void* block);
+static void* pool_class_take(struct PoolClass* self);
+
+const struct Allocator pool_allocator = { pool_allocate, pool_reallocate, pool_deallocate, &pool_statistics };
+
+#endif /* ENABLE_POOL_ALLOCATOR */
+
+static struct AllocatorStatistics heap_statistics = { 0, 0, 0 };
+
+// Statiska funktioner:
+static void* heap_allocate(const size_t size);
+static void* heap_reallocate(void* block, const size_t size);
+static void heap_deallocate(void* block);
+
+const struct Allocator heap_allocator = { heap_allocate, heap_reallocate, heap_deallocate, &heap_statistics };
+
+/******************************************************************************
+* Funktionen Allocator_print används för att skriva ut statistik för en
+* given allokerare.
+******************************************************************************/
+void Allocator_print(const struct Allocator* self)
+{
+	serial_print_unsigned("Allocated bytes: %lu\n", self->statistics->used_bytes);
+	serial_print_unsigned("High-water mark: %lu bytes\n", self->statistics->high_water_bytes);
+	serial_print_unsigned("Failed allocations: %lu\n", self->statistics->failures);
+	return;
+}
+
+/******************************************************************************
+* Funktionerna heap_allocate, heap_reallocate samt heap_deallocate utgör
+* wrappers för malloc, realloc och free. Varje block inleds av ett huvud
+* om sizeof(size_t) byte (två byte på mikrodatorn) som lagrar blockets
+* begärda storlek, så att använt minne kan räknas ned när blocket frigörs
+* eller omallokeras. Pekaren som returneras pekar direkt efter huvudet.
+* Använt minne, high-water mark samt misslyckade allokeringar räknas.
+******************************************************************************/
+static void* heap_allocate(const size_t size)
+{
+	return heap_reallocate(NULL, size);
+}
+
+static void* heap_reallocate(void* block, const size_t size)
+{
+	size_t* header = block ? (size_t*)block - 1 : NULL;
+	const size_t previous = header ? *header : 0x00;
+
+	if (!size)
+	{
+		heap_deallocate(block);
+		return NULL;
+	}
+
+	size_t* copy = size <= SIZE_MAX - sizeof(size_t) ? realloc(header, sizeof(size_t) + size) : NULL;
+
+	if (!copy)
+	{
+		heap_statistics.failures++;
+		return NULL;
+	}
+
+	*copy = size;
+	heap_statistics.used_bytes += size - previous;
+	if (heap_statistics.used_bytes > heap_statistics.high_water_bytes)
+		heap_statistics.high_water_bytes = heap_statistics.used_bytes;
+	return copy + 1;
+}
+
+static void heap_deallocate(void* block)
+{
+	if (!block) return;
+	size_t* header = (size_t*)block - 1;
+	heap_statistics.used_bytes -= *header;
+	free(header);
+	return;
+}
+
+#ifdef ENABLE_POOL_ALLOCATOR
+
+/******************************************************************************
+* Funktionen Pool_class_statistics returnerar statistik för blockstorlek
+* med angivet index (0 - POOL_CLASSES - 1).
+******************************************************************************/
+struct PoolClassStatistics Pool_class_statistics(const uint8_t index)
+{
+	return pool_classes[index].statistics;
+}
+
+/******************************************************************************
+* Funktionen Pool_print används för att skriva ut statistik för samtliga
+* minnespooler, följt av statistik per blockstorlek.
+******************************************************************************/
+void Pool_print(void)
+{
+	Allocator_print(&pool_allocator);
+
+	for (register uint8_t i = 0; i < POOL_CLASSES; i++)
+	{
+		const struct PoolClassStatistics* statistics = &pool_classes[i].statistics;
+		serial_print_unsigned("Pool %lu bytes: ", statistics->block_size);
+		serial_print_unsigned("%lu/", statistics->used);
+		serial_print_unsigned("%lu used, ", statistics->blocks);
+		serial_print_unsigned("high-water %lu, ", statistics->high_water);
+		serial_print_unsigned("exhausted %lu\n", statistics->exhausted);
+	}
+	return;
+}
+
+/******************************************************************************
+* Funktionen pool_allocate används för att allokera ett block om minst size
+* byte. Den minsta blockstorlek som rymmer size byte och har lediga block
+* används, vilket innebär att en större blockstorlek används ifall den
+* lämpligaste är slut. Eftersom antalet blockstorlekar är fast sker
+* allokeringen i konstant tid. Om inget block finns ledigt räknas en
+* misslyckad allokering och en nullpekare returneras.
+******************************************************************************/
+static void* pool_allocate(const size_t size)
+{
+	if (!size) return NULL;
+
+	for (register uint8_t i = 0; i < POOL_CLASSES; i++)
+	{
+		struct PoolClass* class = &pool_classes[i];
+		if (class->statistics.block_size < size) continue;
+
+		void* block = pool_class_take(class);
+		if (block) return block;
+		class->statistics.exhausted++;
+	}
+
+	pool_statistics.failures++;
+	return NULL;
+}
+
+/******************************************************************************
+* Funktionen pool_reallocate används för att omallokera ett block till minst
+* size byte. Om blocket redan rymmer size byte returneras samma block, såvida
+* inte ett ledigt block av mindre storlek också rymmer size byte, då
+* innehållet flyttas dit så att det större blocket frigörs. Annars allokeras
+* ett större block, befintligt innehåll kopieras och det gamla blocket
+* frigörs. Vid misslyckad allokering bibehålls det gamla blocket och en
+* nullpekare returneras, precis som för realloc. Ett block som inte tillhör
+* någon minnespool kan inte omallokeras, vilket räknas som en misslyckad
+* allokering.
+******************************************************************************/
+static void* pool_reallocate(void* block, const size_t size)
+{
+	if (!block) return pool_allocate(size);
+
+	if (!size)
+	{
+		pool_deallocate(block);
+		return NULL;
+	}
+
+	struct PoolClass* class = pool_class_of(block);
+
+	if (!class)
+	{
+		pool_statistics.failures++;
+		return NULL;
+	}
+
+	const uint8_t block_size = class->statistics.block_size;
+	void* copy = NULL;
+
+	if (size <= block_size)
+	{
+		for (struct PoolClass* smaller = pool_classes; smaller < class && !copy; smaller++)
+		{
+			if (smaller->statistics.block_size >= size) copy = pool_class_take(smaller);
+		}
+		if (!copy) return block;
+	}
+
+	else
+	{
+		copy = pool_allocate(size);
+		if (!copy) return NULL;
+	}
+
+	memcpy(copy, block, size < block_size ? size : block_size);
+	pool_deallocate(block);
+	return copy;
+}
+
+/******************************************************************************
+* Funktionen pool_deallocate används för att frigöra ett block, som läggs
+* först i fri-listan för aktuell blockstorlek. Nullpekare samt pekare som
+* inte tillhör någon minnespool ignoreras.
+******************************************************************************/
+static void pool_deallocate(void* block)
+{
+	struct PoolClass* class = pool_class_of(block);
+	if (!class) return;
+
+	*(void**)block = class->free_list;
+	class->free_list = block;
+	class->statistics.used--;
+	pool_statistics.used_bytes -= class->statistics.block_size;
+	return;
+}
+
+/******************************************************************************
+* Funktionen pool_class_of returnerar den blockstorlek som ett givet block
+* tillhör, vilket avgörs utifrån blockets adress. Om blocket inte tillhör
+* någon minnespool returneras en nullpekare.
+******************************************************************************/
+static struct PoolClass* pool_class_of(const void* block)
+{
+	for (register uint8_t i = 0; i < POOL_CLASSES; i++)
+	{
+		struct PoolClass* class = &pool_classes[i];
+		if ((void* const*)block >= class->start && (void* const*)block < class->end) return class;
+	}
+	return NULL;
+}
+
+/******************************************************************************
+* Funktionen pool_class_take används för att ta ett ledigt block från en
+* given blockstorlek. I första hand tas ett tidigare frigjort block från
+* fri-listan, annars tas nästa block som aldrig har använts. Statistiken
+* för blockstorleken och för minnespoolerna uppdateras. Om blockstorleken
+* är slut returneras en nullpekare.
+******************************************************************************/
+static void* pool_class_take(struct PoolClass* self)
+{
+	void* block = self->free_list;
+
+	if (block)
+	{
+		self->free_list = *(void**)block;
+	}
+
+	else if (self->next_unused < self->statistics.blocks)
+	{
+		block = self->start + (size_t)self->next_unused++ * POOL_WORDS(self->statistics.block_size);
+	}
+
+	else
+	{
+		return NULL;
+	}
+
+	if (++self->statistics.used > self->statistics.high_water)
+		self->statistics.high_water = self->statistics.used;
+
+	pool_statistics.used_bytes += self->statistics.block_size;
+	if (pool_statistics.used_bytes > pool_statistics.high_water_bytes)
+		pool_statistics.high_water_bytes = pool_statistics.used_bytes;
+	return block;
+}
+
+#endif /* ENABLE_POOL_ALLOCATOR */
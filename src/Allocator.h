@@ -0,0 +1,114 @@
+
+#ifndef ALLOCATOR_H_
+#define ALLOCATOR_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+
+/******************************************************************************
+* Strukten Allocator utgör ett gemensamt gränssnitt för minnesallokering,
+* så att dynamiska behållare (exempelvis Vector) kan använda valfri
+* minneskälla via en pekare till ett allokeringsobjekt. Två allokerare finns:
+*
+* heap_allocator: Använder avr-libc:s malloc, realloc och free, där varje
+* block inleds av blockets storlek. Heapen växer mot stacken och kollision
+* upptäcks inte av hårdvaran.
+*
+* pool_allocator: Använder statiska minnespooler med block av fast storlek
+* (16, 32, 64 och 128 byte), reserverade vid kompilering. Allokering och
+* frigöring sker i konstant tid via en fri-lista per blockstorlek, utan
+* fragmentering och utan att minnesåtgången kan växa in i stacken.
+*
+* Antalet block per storlek ställs in vid kompilering via makrona nedan,
+* exempelvis -DPOOL_BLOCKS_64=4. Med standardvärdena reserverar poolerna
+* 4 * 16 + 2 * 32 + 2 * 64 + 128 = 384 byte, alltså närmare en fjärdedel av
+* mikrodatorns 2 kB SRAM, oavsett hur mycket som faktiskt allokeras. Den
+* dynamiska timerns vektor behöver som mest 10 intervall (40 byte, plus
+* lika mycket för trimmat medelvärde). pool_allocator kompileras därför
+* enbart in då ENABLE_POOL_ALLOCATOR är definierad, då den även utgör
+* standardallokerare för behållare. Annars används heap_allocator, vars
+* minnesåtgång följer faktiska allokeringar.
+*
+* För varje allokerare förs statistik över använt minne, högsta använda
+* minne sedan start (high-water mark) samt antalet misslyckade allokeringar.
+* För heap_allocator räknas begärda byte, där varje block lagrar sin
+* storlek i ett huvud om två byte före blocket. För pool_allocator räknas
+* hela block.
+******************************************************************************/
+
+#ifdef ENABLE_POOL_ALLOCATOR
+
+#ifndef POOL_BLOCKS_16
+#define POOL_BLOCKS_16 4	// Antal block om 16 byte.
+#endif
+
+#ifndef POOL_BLOCKS_32
+#define POOL_BLOCKS_32 2	// Antal block om 32 byte.
+#endif
+
+#ifndef POOL_BLOCKS_64
+#define POOL_BLOCKS_64 2	// Antal block om 64 byte.
+#endif
+
+#ifndef POOL_BLOCKS_128
+#define POOL_BLOCKS_128 1	// Antal block om 128 byte.
+#endif
+
+#define POOL_CLASSES 4		// Antal blockstorlekar.
+
+#endif /* ENABLE_POOL_ALLOCATOR */
+
+/******************************************************************************
+* Strukten AllocatorStatistics lagrar statistik för en given allokerare.
+******************************************************************************/
+struct AllocatorStatistics
+{
+	uint16_t used_bytes;		// Antal byte som för tillfället är allokerade.
+	uint16_t high_water_bytes;	// Högsta antal allokerade byte sedan start.
+	uint16_t failures;		// Antal misslyckade allokeringar.
+};
+
+struct Allocator
+{
+	void* (*allocate)(const size_t size);			// Allokerar ett block om minst size byte.
+	void* (*reallocate)(void* block, const size_t size);	// Omallokerar ett block till minst size byte.
+	void (*deallocate)(void* block);			// Frigör ett block.
+	struct AllocatorStatistics* statistics;			// Pekare till allokerarens statistik.
+};
+
+#ifdef ENABLE_POOL_ALLOCATOR
+
+/******************************************************************************
+* Strukten PoolClassStatistics lagrar statistik för en given blockstorlek
+* i pool_allocator.
+******************************************************************************/
+struct PoolClassStatistics
+{
+	uint8_t block_size;	// Blockstorlek mätt i byte.
+	uint8_t blocks;		// Totalt antal block.
+	uint8_t used;		// Antal allokerade block.
+	uint8_t high_water;	// Högsta antal allokerade block sedan start.
+	uint16_t exhausted;	// Antal gånger blockstorleken var slut vid allokering.
+};
+
+#endif /* ENABLE_POOL_ALLOCATOR */
+
+// Allokerare:
+extern const struct Allocator heap_allocator;
+
+#ifdef ENABLE_POOL_ALLOCATOR
+extern const struct Allocator pool_allocator;
+#define DEFAULT_ALLOCATOR (&pool_allocator)
+#else
+#define DEFAULT_ALLOCATOR (&heap_allocator)
+#endif
+
+// Funktionsdeklarationer:
+void Allocator_print(const struct Allocator* self);
+
+#ifdef ENABLE_POOL_ALLOCATOR
+struct PoolClassStatistics Pool_class_statistics(const uint8_t index);
+void Pool_print(void);
+#endif
+
+#endif /* ALLOCATOR_H_ */
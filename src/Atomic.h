@@ -0,0 +1,142 @@
+
+#ifndef ATOMIC_H_
+#define ATOMIC_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+#include <util/atomic.h>
+
+/******************************************************************************
+* Verktyg för variabler som delas mellan avbrottsrutiner och huvudloopen.
+* ATmega328P läser och skriver en byte i taget, varför en variabel på flera
+* byte, exempelvis uint32_t, kan läsas halvt uppdaterad ifall ett avbrott
+* äger rum mitt i läsningen. Följande verktyg används beroende på vem som
+* skriver respektive läser:
+*
+* - Atomic_load32, Atomic_store32 samt Atomic_add32 läser respektive skriver
+*   ett enskilt 32-bitars värde med avbrott inaktiverade under ett fåtal
+*   klockcykler, via ATOMIC_BLOCK, och kan användas åt båda hållen.
+* - SeqCount (sekvensräknare) används då en avbrottsrutin skriver flera
+*   värden som huvudloopen läser som en helhet. Avbrottsrutinen räknar upp
+*   sekvensräknaren före och efter skrivningen, medan huvudloopen läser
+*   värdena utan att inaktivera avbrott och upprepar läsningen ifall
+*   sekvensräknaren har ändrats under tiden. Eftersom huvudloopen aldrig
+*   avbryter en avbrottsrutin är räknaren alltid jämn vid läsning.
+* - DOUBLE_BUFFER används då huvudloopen skriver flera värden som en
+*   avbrottsrutin läser. Huvudloopen skriver till den inaktiva bufferten och
+*   publicerar den sedan genom att räkna upp generationsräknaren (en byte,
+*   vilket sker atomärt), så att avbrottsrutinen alltid läser en komplett
+*   buffert utan att behöva vänta.
+*
+* Samtliga funktioner är inline, eftersom de enbart består av några få
+* instruktioner.
+******************************************************************************/
+
+#define COMPILER_BARRIER() __asm__ __volatile__ ("" ::: "memory")	// Förhindrar att kompilatorn flyttar minnesåtkomster förbi denna punkt.
+
+/******************************************************************************
+* Atomär läsning, skrivning samt addition av 32-bitars värden.
+******************************************************************************/
+static inline uint32_t Atomic_load32(const volatile uint32_t* address)
+{
+	uint32_t value;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		value = *address;
+	}
+	return value;
+}
+
+static inline void Atomic_store32(volatile uint32_t* address, const uint32_t value)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		*address = value;
+	}
+	return;
+}
+
+static inline void Atomic_add32(volatile uint32_t* address, const uint32_t value)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		*address += value;
+	}
+	return;
+}
+
+/******************************************************************************
+* Strukten SeqCount utgör en sekvensräknare, där udda värde indikerar att
+* skrivning pågår. Skrivning omges av SeqCount_write_begin samt
+* SeqCount_write_end, medan läsning sker enligt följande mönster:
+*
+* uint8_t sequence;
+* do
+* {
+*	sequence = SeqCount_read_begin(&self->sequence);
+*	kopiera delade värden...
+* } while (SeqCount_read_retry(&self->sequence, sequence));
+******************************************************************************/
+struct SeqCount
+{
+	volatile uint8_t sequence;	// Räknas upp två gånger per skrivning.
+};
+
+static inline struct SeqCount new_SeqCount(void)
+{
+	struct SeqCount self;
+	self.sequence = 0x00;
+	return self;
+}
+
+static inline void SeqCount_write_begin(struct SeqCount* self)
+{
+	self->sequence++;
+	COMPILER_BARRIER();
+	return;
+}
+
+static inline void SeqCount_write_end(struct SeqCount* self)
+{
+	COMPILER_BARRIER();
+	self->sequence++;
+	return;
+}
+
+static inline uint8_t SeqCount_read_begin(const struct SeqCount* self)
+{
+	uint8_t sequence;
+
+	do
+	{
+		sequence = self->sequence;
+	} while (sequence & 0x01);
+
+	COMPILER_BARRIER();
+	return sequence;
+}
+
+static inline bool SeqCount_read_retry(const struct SeqCount* self, const uint8_t sequence)
+{
+	COMPILER_BARRIER();
+	return self->sequence != sequence;
+}
+
+/******************************************************************************
+* Makrot DOUBLE_BUFFER deklarerar en dubbelbuffert för given datatyp med en
+* enda skrivare. Skrivaren hämtar den inaktiva bufferten via
+* DoubleBuffer_pending (vars innehåll först bör kopieras från aktuell
+* buffert via DoubleBuffer_prepare), fyller i den och publicerar den via
+* DoubleBuffer_publish. Läsaren hämtar aktuell buffert via
+* DoubleBuffer_current, samt kan upptäcka nya värden genom att jämföra
+* generationsräknaren med senast lästa generation.
+******************************************************************************/
+#define DOUBLE_BUFFER(type) struct { type buffers[2]; volatile uint8_t generation; }
+
+#define DoubleBuffer_init(buffer, value) do { (buffer)->buffers[0] = (value); (buffer)->buffers[1] = (value); (buffer)->generation = 0x00; } while (0)
+#define DoubleBuffer_current(buffer) (&(buffer)->buffers[(buffer)->generation & 0x01])
+#define DoubleBuffer_pending(buffer) (&(buffer)->buffers[((buffer)->generation + 1) & 0x01])
+#define DoubleBuffer_prepare(buffer) (*DoubleBuffer_pending(buffer) = *DoubleBuffer_current(buffer))
+#define DoubleBuffer_publish(buffer) do { COMPILER_BARRIER(); (buffer)->generation++; } while (0)
+
+#endif /* ATOMIC_H_ */
@@ -9,13 +9,16 @@
 * PIN (Arduino Uno)          I/O-port          PIN (ATmega328P)               *
 *     0 - 7                     D         Samma som PIN på Arduino Uno        *
 *     8 - 13                    B            PIN på Arduino Uno - 8           *
+*    14 - 19 (A0 - A5)          C            PIN på Arduino Uno - 14          *
 *******************************************************************************
 *
 * Först deklareras ett nytt objekt av strukten Button som döps till self.
 * Därefter undersöks vilket PIN-nummer som tryckknappen är ansluten till.
 * Om aktuellt PIN-nummer ligger mellan 0 - 7, är knappen ansluten till samma
 * PIN på I/O-port D. Annars om PIN-nummret ligger mellan 8 - 13, så är
-* tryckknappen ansluten till PIN 0 - 5 på I/O-port B. En intern pullup-resistor
+* tryckknappen ansluten till PIN 0 - 5 på I/O-port B. Annars om PIN-numret
+* ligger mellan 14 - 19 (analoga PINs A0 - A5), så är tryckknappen ansluten
+* till PIN 0 - 5 på I/O-port C. En intern pullup-resistor
 * på tryckknappens PIN aktiveras via ettställning av motsvarande bit i aktuellt 
 * PORT-register. Detta medför att tryckknappens insignal alltid är hög eller låg.
 ******************************************************************************/
@@ -25,7 +28,7 @@ struct Button new_Button(const uint8_t PIN)
 	
 	self.interrupt_enabled = false; // Sätter instansvariabeln interrupt_enabled till false. (inga PCI avbrott / avbrottsvektorer är möjliggjorda vid start).
 	
-	if (PIN >= 0 && PIN <= 7)		// Om ingående parameter (inmatad & önskad PIN vid detta funktionsanrop) är mellan 0 & 7 så sker raderna nedan:
+	if (PIN <= 7)			// Om ingående parameter (inmatad & önskad PIN vid detta funktionsanrop) är mellan 0 & 7 så sker raderna nedan:
 	{
 		self.io_port = IO_PORTD;	// Ger instansvariabeln / objektet self.io_port värdet av enumerationen("makrot") IO_port -> IO_PORTD.
 		self.PIN = PIN;
@@ -38,6 +41,13 @@ struct Button new_Button(const uint8_t PIN)
 		self.PIN = PIN - 8;			
 		PORTB |= (1 << self.PIN);	// Sätter önskad pin från self.PIN till "hög insignal" i PORTB.
 	}
+	
+	else if (PIN >= 14 && PIN <= 19)
+	{
+		self.io_port = IO_PORTC;
+		self.PIN = PIN - 14;
+		PORTC |= (1 << self.PIN);
+	}
 	return self;
 }
 
@@ -46,7 +56,8 @@ struct Button new_Button(const uint8_t PIN)
 * tryckknapp är nedtryckt. Om tryckknappen är ansluten till I/O-port B, så
 * läses motsvarande PIN från registret PINB och returneras. Annars om 
 * tryckknappen är ansluten till I/O-port D, så läses motsvarande PIN från 
-* registret PIND och returneras. Annars vid fel så returneras false.
+* registret PIND och returneras. På motsvarande sätt läses registret PINC
+* för I/O-port C. Annars vid fel så returneras false.
 ******************************************************************************/
 bool Button_is_pressed(struct Button* self)
 {
@@ -60,63 +71,56 @@ bool Button_is_pressed(struct Button* self)
 		return (PIND & (1 << self->PIN));	// Läser av respektive PIN som ligger lagrad i self.PIN, från registret PIND och returnerar detta. 
 	}
 	
+	else if (self->io_port == IO_PORTC)
+	{
+		return (PINC & (1 << self->PIN));
+	}
+	
 	return false;					// Vid fel / villkoren ovan ej uppfylls returneras false. 
 }
 
+/******************************************************************************
+* Funktionen Button_attach registrerar callbackfunktioner för tryckknappen,
+* där pressed anropas från avbrottsrutinen vid nedtryckning och released
+* vid släpp (se PinChange.h). Avbrott aktiveras separat via
+* Button_enable_interrupt.
+******************************************************************************/
+void Button_attach(struct Button* self, void (*pressed)(void), void (*released)(void))
+{
+	PinChange_attach(self->io_port, self->PIN, pressed, released);
+	return;
+}
+
 /******************************************************************************
 * Funktionen Button_enable_interrupt används för att aktivera PCI-avbrott på
 * en given PIN som en tryckknapp är ansluten till. Först aktiveras avbrott
 * globalt via ettställning av bit I (Interrupt Flag) i statusregistret SREG.
-* Därefter undersöks använd I/O-port. Om tryckknappen är ansluten till
-* I/O-port B, så ettställs biten PCIE0 (PIN Change Interrupt Enable 0) i
-* kontrollregistret PCICR (PIN Change Interrupt Control Register), följt av
-* att motsvarande PCI-avbrott aktiveras i maskregistret PCMSK0 (PIN Change
-* Mask Register 0). Annars om tryckknappen är ansluten till I/O-port D,
-* så ettställs biten PCIE2 (PIN Change Interrupt Enable 2) i kontrollregistret
-* PCICR (PIN Change Interrupt Control Register), följt av
-* att motsvarande PCI-avbrott aktiveras i maskregistret PCMSK2 (PIN Change
-* Mask Register 2). Slutligen sätts instansvariabeln interrupt_enabled till
-* true för att indikera att abrott nu är aktiverat.
+* Därefter sätts instansvariabeln interrupt_enabled till true för att
+* indikera att avbrott nu är aktiverat, följt av att motsvarande bit
+* ettställs i kontrollregistret PCICR (PIN Change Interrupt Control
+* Register) samt i I/O-portens maskregister PCMSK0 - PCMSK2 (PIN Change
+* Mask Register) via PinChange_enable. Om tryckknappen har tryckts ned
+* eller släppts medan avbrottet var inaktiverat anropas motsvarande
+* callbackfunktion direkt, vilken kan inaktivera avbrottet på nytt.
 ******************************************************************************/
 
 void Button_enable_interrupt(struct Button* self)
 {
-	asm("SEI");
-	
-	if (self->io_port == IO_PORTB)
-	{
-		PCICR |= (1 << PCIE0); 
-		PCMSK0 |= (1 << self->PIN);
-	}
-	
-	else if (self->io_port == IO_PORTD)
-	{
-		PCICR |= (1 << PCIE2); 
-		PCMSK2 |= (1 << self->PIN);
-	}
-	
+	ENABLE_INTERRUPTS;
 	self->interrupt_enabled = true;
+	PinChange_enable(self->io_port, self->PIN);
 	return;
 }
 
 /******************************************************************************
 * Funktionen Button_disable_interrupt används för att inaktivera avbrott för
 * en given PIN, där en tryckknapp är ansluten. Detta åstadkommes via
-* nollställning av motsvarande bit i någon av registren PCMSK0 (I/O-port B)
-* eller PCMSK2 (I/O-port D).
+* nollställning av motsvarande bit i I/O-portens maskregister PCMSK0 - 
+* PCMSK2 via PinChange_disable.
 ******************************************************************************/
 void Button_disable_interrupt(struct Button* self)
 {
-	if (self->io_port == IO_PORTB)
-	{
-		PCMSK0 &= ~(1 << self->PIN);
-	}
-	
-	else if (self->io_port == IO_PORTD)
-	{
-		PCMSK2 &= ~(1 << self->PIN);
-	}
-	
+	PinChange_disable(self->io_port, self->PIN);
 	self->interrupt_enabled = false;
 	return;
 }
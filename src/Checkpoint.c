@@ -0,0 +1,94 @@
+// Inkluderingsdirektiv:
+#include "Checkpoint.h"
+#include <stddef.h>
+#include <util/crc16.h>
+
+static struct DynamicTimerCheckpoint buffer;	// Kontrollpunkt som skrivs, behålls tills skrivningen är slutförd.
+static bool writing = false;			// Indikerar att buffer skrivs till EEPROM-minnet.
+static uint16_t saved_crc = 0x00;		// Kontrollsumma för senast sparade kontrollpunkt.
+static uint32_t last_check = 0x00;		// Tidpunkt för senaste kontroll mätt i sekunder.
+
+// Statiska funktioner:
+static uint16_t checksum(const struct DynamicTimerCheckpoint* checkpoint);
+static bool is_valid(const struct DynamicTimerCheckpoint* checkpoint);
+
+/******************************************************************************
+* Funktionen Checkpoint_restore läser kontrollpunkten från EEPROM-minnet och
+* återställer den dynamiska timerns tillstånd, förutsatt att kontrollsumman
+* är korrekt och att samtliga värden är giltiga. Kontrollsumman sparas, så
+* att en oförändrad kontrollpunkt inte skrivs om. Om kontrollpunkten
+* återställdes returneras true.
+******************************************************************************/
+bool Checkpoint_restore(struct DynamicTimer* timer)
+{
+	struct DynamicTimerCheckpoint checkpoint;
+	Eeprom_read(CHECKPOINT_ADDRESS, &checkpoint, sizeof(checkpoint));
+	if (!is_valid(&checkpoint)) return false;
+
+	if (!DynamicTimer_restore(timer, &checkpoint)) return false;
+	saved_crc = checkpoint.crc;
+	return true;
+}
+
+/******************************************************************************
+* Funktionen Checkpoint_process anropas från programmets huvudloop. När en
+* skrivning pågår inväntas att den slutförs. Annars skapas en ny
+* kontrollpunkt högst en gång per CHECKPOINT_PERIOD sekunder, vilken skrivs
+* ifall kontrollsumman skiljer sig från senast sparade kontrollpunkt. Om en
+* annan skrivning pågår görs ett nytt försök vid nästa anrop.
+******************************************************************************/
+void Checkpoint_process(const struct DynamicTimer* timer)
+{
+	if (writing)
+	{
+		if (!Eeprom_busy()) writing = false;
+		return;
+	}
+
+	const uint32_t now = Clock_seconds();
+	if (now - last_check < CHECKPOINT_PERIOD || Eeprom_busy()) return;
+	last_check = now;
+
+	struct DynamicTimerCheckpoint checkpoint;
+	DynamicTimer_checkpoint(timer, &checkpoint);
+	if (!checkpoint.required_interrupts) return;
+
+	checkpoint.crc = checksum(&checkpoint);
+	if (checkpoint.crc == saved_crc) return;
+
+	buffer = checkpoint;
+	writing = Eeprom_write(CHECKPOINT_ADDRESS, &buffer, sizeof(buffer));
+	if (writing) saved_crc = buffer.crc;
+	return;
+}
+
+/******************************************************************************
+* Funktionen checksum beräknar en CRC-16 för samtliga byte i en
+* kontrollpunkt utom kontrollsumman, med CHECKPOINT_VERSION som startvärde.
+******************************************************************************/
+static uint16_t checksum(const struct DynamicTimerCheckpoint* checkpoint)
+{
+	const uint8_t* data = (const uint8_t*)checkpoint;
+	uint16_t crc = CHECKPOINT_VERSION;
+
+	for (register uint8_t i = 0; i < sizeof(*checkpoint); i++)
+	{
+		if (i < offsetof(struct DynamicTimerCheckpoint, crc) || i >= offsetof(struct DynamicTimerCheckpoint, crc) + sizeof(checkpoint->crc))
+			crc = _crc16_update(crc, data[i]);
+	}
+
+	return crc;
+}
+
+/******************************************************************************
+* Funktionen is_valid kontrollerar kontrollsumman samt att strategi,
+* kapacitet, antal intervall och fördröjningstid är giltiga.
+******************************************************************************/
+static bool is_valid(const struct DynamicTimerCheckpoint* checkpoint)
+{
+	if (checksum(checkpoint) != checkpoint->crc) return false;
+	if (checkpoint->estimator > ESTIMATOR_QUANTILE) return false;
+	if (!checkpoint->capacity || checkpoint->capacity > MAX_CAPACITY) return false;
+	if (checkpoint->count > CHECKPOINT_INTERVALS) return false;
+	return checkpoint->required_interrupts ? true : false;
+}
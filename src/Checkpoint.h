@@ -0,0 +1,34 @@
+
+#ifndef CHECKPOINT_H_
+#define CHECKPOINT_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+#include "DynamicTimer.h"
+#include "EepromLog.h"
+
+/******************************************************************************
+* Kontrollpunkten lagrar den dynamiska timerns inlärda tillstånd (se
+* DynamicTimerCheckpoint i DynamicTimer.h) i EEPROM-minnets sista byte,
+* efter EEPROM-loggen, så att timern efter reset (exempelvis brown-out
+* eller watchdog) direkt återupptar inlärd fördröjningstid i stället för
+* standardvärdet 60 sekunder.
+*
+* Kontrollpunkten skyddas av en CRC-16, vars startvärde utgörs av
+* CHECKPOINT_VERSION, så att en kontrollpunkt med annat format ignoreras.
+* Från huvudloopen kontrolleras högst en gång per CHECKPOINT_PERIOD
+* sekunder om tillståndet har ändrats sedan senast sparade kontrollpunkt
+* (jämförelse av kontrollsumman), där kontrollpunkten enbart skrivs vid
+* ändring. Skrivningen sker asynkront (se Eeprom.h), där enbart ändrade
+* byte skrivs. Därmed skrivs EEPROM-minnet högst en gång per period.
+******************************************************************************/
+
+#define CHECKPOINT_ADDRESS (EEPROM_LOG_ADDRESS + EEPROM_LOG_SIZE)	// Adress i EEPROM-minnet.
+#define CHECKPOINT_PERIOD 60					// Minsta tid mellan skrivningar mätt i sekunder.
+#define CHECKPOINT_VERSION 0x0002				// Formatets version, startvärde för CRC-16.
+
+// Funktionsdeklarationer:
+bool Checkpoint_restore(struct DynamicTimer* timer);
+void Checkpoint_process(const struct DynamicTimer* timer);
+
+#endif /* CHECKPOINT_H_ */
@@ -0,0 +1,89 @@
+// Inkluderingsdirektiv:
+#include "Clock.h"
+#include <util/atomic.h>	// Bibliotek för atomära block (avbrott inaktiverade).
+
+static volatile uint32_t overflows = 0x00;	// Antal overflow sedan start.
+static uint32_t seconds = 0x00;			// Tid sedan start mätt i sekunder.
+static uint32_t last = 0x00;			// Klockans tid vid senaste anrop av Clock_seconds.
+static uint32_t remainder = 0x00;		// Uppräkningar som ännu inte utgör en hel sekund.
+
+/******************************************************************************
+* Funktionen init_clock används för att starta klockan. Timer 2 sätts i
+* Normal Mode med prescaler 64, följt av att overflow-avbrott aktiveras.
+* Avbrott aktiveras även globalt.
+******************************************************************************/
+void init_clock(void)
+{
+	TCCR2A = 0x00;
+	TCCR2B = (1 << CS22);
+	TIMSK2 |= (1 << TOIE2);
+	ENABLE_INTERRUPTS;
+	return;
+}
+
+/******************************************************************************
+* Funktionen Clock_overflow anropas från avbrottsrutinen för overflow på
+* Timer 2 och räknar upp antalet overflow.
+******************************************************************************/
+void Clock_overflow(void)
+{
+	overflows++;
+	return;
+}
+
+/******************************************************************************
+* Funktionen Clock_now returnerar aktuell tid mätt i klockans uppräkningar
+* (4 us). Antalet overflow och räknarregistret TCNT2 läses med avbrott
+* inaktiverade. Om ett overflow har skett som ännu inte har hanterats av
+* avbrottsrutinen (flaggan TOV2 är ettställd), vilket exempelvis är fallet
+* när funktionen anropas från en annan avbrottsrutin, så räknas detta med.
+* Kontrollen av TCNT2 säkerställer att ett overflow som sker mellan
+* avläsningarna inte räknas dubbelt.
+******************************************************************************/
+uint32_t Clock_now(void)
+{
+	uint32_t count;
+	uint8_t ticks;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		count = overflows;
+		ticks = TCNT2;
+		if ((TIFR2 & (1 << TOV2)) && ticks < 0xFF) count++;
+	}
+
+	return (count << 8) | ticks;
+}
+
+/******************************************************************************
+* Funktionen Clock_now16 returnerar de 16 minst signifikanta bitarna av
+* aktuell tid, vilket räcker för att mäta tidsintervall upp till 262 ms.
+******************************************************************************/
+uint16_t Clock_now16(void)
+{
+	return (uint16_t)Clock_now();
+}
+
+/******************************************************************************
+* Funktionen Clock_seconds returnerar tiden sedan start mätt i hela sekunder,
+* vilket till skillnad från Clock_now inte slår runt efter 4.8 timmar.
+* Tiden räknas upp med klockans uppräkningar sedan föregående anrop, där
+* resterande uppräkningar sparas till nästa anrop, så att tiden inte driver.
+* Funktionen måste därmed anropas minst en gång per 4.8 timmar.
+******************************************************************************/
+uint32_t Clock_seconds(void)
+{
+	uint32_t result;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		const uint32_t now = Clock_now();
+		remainder += now - last;
+		last = now;
+		seconds += remainder / CLOCK_TICKS_PER_S;
+		remainder %= CLOCK_TICKS_PER_S;
+		result = seconds;
+	}
+
+	return result;
+}
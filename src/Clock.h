@@ -0,0 +1,35 @@
+
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+
+/******************************************************************************
+* Klockan utgör en fritt löpande tidräknare för tidsmätning, implementerad
+* via Timer 2 i Normal Mode med prescaler 64. Därmed räknar Timer 2 upp var
+* fjärde mikrosekund (16 MHz / 64 = 250 kHz) och overflow sker efter 256
+* uppräkningar, det vill säga var 1.024:e millisekund. Vid varje overflow
+* räknas en mjukvaruräknare upp i avbrottsrutinen TIMER2_OVF_vect, vilket
+* tillsammans med räknarregistret TCNT2 bildar en 32-bitars tidsstämpel med
+* upplösningen 4 us, som slår runt efter cirka 4.8 timmar.
+*
+* För att ställa in prescaler 64 för Timer 2 så ettställs biten CS22 (Clock
+* Select 2 bit 2) i kontrollregistret TCCR2B. För att aktivera overflow-
+* avbrott ettställs biten TOIE2 i maskregistret TIMSK2. Övriga bitar i
+* TIMSK2 lämnas orörda, så att Timer 2:s compare-avbrott kan användas
+* samtidigt.
+******************************************************************************/
+
+#define CLOCK_TICK_US 4			// Tid mellan uppräkningar mätt i mikrosekunder.
+#define CLOCK_TICKS_PER_MS 250		// Antal uppräkningar per millisekund.
+#define CLOCK_TICKS_PER_S 250000UL	// Antal uppräkningar per sekund.
+
+// Funktionsdeklarationer:
+void init_clock(void);
+void Clock_overflow(void);
+uint32_t Clock_now(void);
+uint16_t Clock_now16(void);
+uint32_t Clock_seconds(void);
+
+#endif /* CLOCK_H_ */
@@ -0,0 +1,380 @@
+// Inkluderingsdirektiv:
+#include "Console.h"
+#include "Serial.h"
+#include "MemoryUsage.h"
+#include "Allocator.h"
+#include "Profiler.h"
+#include "CpuLoad.h"
+#include "TimerJitter.h"
+#include "Trace.h"
+#include "History.h"
+#include "EepromLog.h"
+#include "header.h"
+#include <string.h>
+
+// Statiska funktioner:
+static void command_help(const char* argument);
+static void command_mem(const char* argument);
+static void command_est(const char* argument);
+static void command_trace(const char* argument);
+static void command_hist(const char* argument);
+static void command_log(const char* argument);
+static void command_report(const char* argument);
+static void command_adapt(const char* argument);
+#ifdef ISR_PROFILER_ENABLED
+static void command_prof(const char* argument);
+#endif
+#ifdef CPU_LOAD_ENABLED
+static void command_load(const char* argument);
+#endif
+#ifdef TIMER_JITTER_ENABLED
+static void command_jitter(const char* argument);
+#endif
+
+/******************************************************************************
+* Tabell över tillgängliga kommandon, lagrad i flashminnet.
+******************************************************************************/
+static const struct ConsoleCommand commands[] PROGMEM =
+{
+	{ "help", command_help },
+	{ "mem", command_mem },
+	{ "est", command_est },
+	{ "trace", command_trace },
+	{ "hist", command_hist },
+	{ "log", command_log },
+	{ "report", command_report },
+	{ "adapt", command_adapt },
+#ifdef ISR_PROFILER_ENABLED
+	{ "prof", command_prof },
+#endif
+#ifdef CPU_LOAD_ENABLED
+	{ "load", command_load },
+#endif
+#ifdef TIMER_JITTER_ENABLED
+	{ "jitter", command_jitter },
+#endif
+};
+
+#define CONSOLE_COMMANDS (sizeof(commands) / sizeof(struct ConsoleCommand))
+
+static volatile char line[CONSOLE_LINE_SIZE];	// Mottagen kommandorad.
+static volatile uint8_t length = 0;		// Antalet mottagna tecken.
+static volatile bool line_ready = false;	// Indikerar att en hel kommandorad har tagits emot.
+
+/******************************************************************************
+* Funktionen Console_receive anropas från avbrottsrutinen för seriell
+* mottagning med mottaget tecken som ingående argument. Vid radslut
+* avslutas kommandoraden med ett nolltecken och flaggan line_ready sätts,
+* förutsatt att raden inte är tom. Övriga tecken lagras så länge plats
+* finns, överskjutande tecken ignoreras.
+******************************************************************************/
+void Console_receive(const char data)
+{
+	if (line_ready) return;
+
+	if (data == '\r' || data == '\n')
+	{
+		if (!length) return;
+		line[length] = '\0';
+		line_ready = true;
+	}
+
+	else if (length < CONSOLE_LINE_SIZE - 1)
+	{
+		line[length++] = data;
+	}
+
+	return;
+}
+
+/******************************************************************************
+* Funktionen Console_process anropas från programmets huvudloop. Om en hel
+* kommandorad har tagits emot delas den upp i namn och argument vid första
+* mellanslag, varefter motsvarande kommando söks i kommandotabellen och
+* exekveras. Slutligen återställs kommandoraden inför nästa kommando.
+******************************************************************************/
+void Console_process(void)
+{
+	if (!line_ready) return;
+
+	char* name = (char*)line;
+	char* argument = strchr(name, ' ');
+
+	if (argument)
+	{
+		*argument++ = '\0';
+	}
+
+	else
+	{
+		argument = name + strlen(name);
+	}
+
+	bool found = false;
+
+	for (register uint8_t i = 0; i < CONSOLE_COMMANDS && !found; i++)
+	{
+		if (strcmp_P(name, commands[i].name) == 0)
+		{
+			const ConsoleHandler handler = (ConsoleHandler)pgm_read_ptr(&commands[i].handler);
+			handler(argument);
+			found = true;
+		}
+	}
+
+	if (!found)
+		serial_print("Unknown command, type help for a list of commands.\n");
+
+	length = 0x00;
+	line_ready = false;
+	return;
+}
+
+/******************************************************************************
+* Kommandot help skriver ut namnen på samtliga tillgängliga kommandon.
+******************************************************************************/
+static void command_help(const char* argument)
+{
+	char name[CONSOLE_NAME_SIZE];
+	serial_print("Commands:");
+
+	for (register uint8_t i = 0; i < CONSOLE_COMMANDS; i++)
+	{
+		strcpy_P(name, commands[i].name);
+		serial_print(" ");
+		serial_print(name);
+	}
+
+	serial_print("\n");
+	return;
+}
+
+/******************************************************************************
+* Kommandot mem skriver ut aktuell minnesanvändning, följt av statistik för
+* standardallokeraren (minnespoolerna då ENABLE_POOL_ALLOCATOR är definierad).
+******************************************************************************/
+static void command_mem(const char* argument)
+{
+	MemoryUsage_print();
+#ifdef ENABLE_POOL_ALLOCATOR
+	Pool_print();
+#else
+	Allocator_print(&heap_allocator);
+#endif
+	return;
+}
+
+/******************************************************************************
+* Kommandot est väljer strategi för skattning av den dynamiska timerns
+* fördröjningstid: mean, trim, ewma, median eller qNN, där NN är önskad
+* kvantil i procent (exempelvis q75). Ny strategi tillämpas vid nästa
+* knapptryckning. Utan argument skrivs vald strategi ut.
+******************************************************************************/
+static void command_est(const char* argument)
+{
+	if (strcmp(argument, "mean") == 0) DynamicTimer_set_estimator(&timer1, ESTIMATOR_MEAN, 0);
+	else if (strcmp(argument, "trim") == 0) DynamicTimer_set_estimator(&timer1, ESTIMATOR_TRIMMED_MEAN, 0);
+	else if (strcmp(argument, "ewma") == 0) DynamicTimer_set_estimator(&timer1, ESTIMATOR_EWMA, 0);
+	else if (strcmp(argument, "median") == 0) DynamicTimer_set_estimator(&timer1, ESTIMATOR_MEDIAN, 0);
+
+	else if (argument[0] == 'q' && atoi(argument + 1) > 0 && atoi(argument + 1) < 100)
+	{
+		DynamicTimer_set_estimator(&timer1, ESTIMATOR_QUANTILE, (uint8_t)atoi(argument + 1));
+	}
+
+	else if (argument[0])
+	{
+		serial_print("Usage: est [mean|trim|ewma|median|qNN]\n");
+		return;
+	}
+
+	const struct DynamicTimerSettings settings = DynamicTimer_settings(&timer1);
+	serial_print("Estimator: ");
+	serial_print(IntervalEstimator_name(settings.estimator));
+	if (settings.estimator == ESTIMATOR_QUANTILE) serial_print_unsigned(" (%lu %%)", settings.quantile);
+	serial_print("\n");
+	return;
+}
+
+/******************************************************************************
+* Kommandot trace skriver ut spårbufferten, äldsta posten först. Med
+* argumentet clear töms bufferten i stället.
+******************************************************************************/
+static void command_trace(const char* argument)
+{
+	if (strcmp(argument, "clear") == 0)
+	{
+		Trace_clear();
+		serial_print("Trace cleared.\n");
+		return;
+	}
+
+	Trace_print();
+	return;
+}
+
+/******************************************************************************
+* Kommandot hist skriver ut lagrade temperaturer, äldsta mätvärdet först,
+* där ett mätvärde i taget avkodas och skrivs ut. Med argumentet clear
+* töms historiken i stället.
+******************************************************************************/
+static void command_hist(const char* argument)
+{
+	if (strcmp(argument, "clear") == 0)
+	{
+		History_clear();
+		serial_print("History cleared.\n");
+		return;
+	}
+
+	struct HistoryReader reader = new_HistoryReader();
+	struct HistorySample sample;
+
+	serial_printf_P(PSTR("History: %lu samples, %u bytes\n"), (unsigned long)History_samples(), History_bytes());
+	serial_print("Time (s), temperature (0.1 C):\n");
+
+	while (HistoryReader_next(&reader, &sample))
+	{
+		serial_printf_P(PSTR("%lu %d\n"), (unsigned long)sample.time, sample.value);
+	}
+
+	return;
+}
+
+/******************************************************************************
+* Kommandot log skriver ut mätvärden lagrade i EEPROM-loggen. Med argumentet
+* flush skrivs i stället mätvärden som ännu enbart finns i RAM till
+* EEPROM-minnet.
+******************************************************************************/
+static void command_log(const char* argument)
+{
+	if (strcmp(argument, "flush") == 0)
+	{
+		EepromLog_flush();
+		serial_print("EEPROM log flushed.\n");
+		return;
+	}
+
+	EepromLog_print();
+	return;
+}
+
+/******************************************************************************
+* Kommandot report väljer när temperaturavläsningar skrivs ut (se
+* TemperatureReport.h): "all" för samtliga avläsningar, alternativt
+* "change H S" för utskrift enbart vid ändring större än H tiondels grader
+* eller efter S sekunder utan utskrift (0 eller utelämnat för ingen
+* begränsning). Utan argument skrivs valt läge ut.
+******************************************************************************/
+static void command_report(const char* argument)
+{
+	if (strcmp(argument, "all") == 0)
+	{
+		TemperatureReport_set_all(&report);
+	}
+
+	else if (strncmp(argument, "change ", 7) == 0 && atoi(argument + 7) >= 0 && atoi(argument + 7) <= UINT8_MAX)
+	{
+		const char* heartbeat = strchr(argument + 7, ' ');
+		TemperatureReport_set_change(&report, (uint8_t)atoi(argument + 7), heartbeat ? (uint16_t)atol(heartbeat + 1) : 0);
+	}
+
+	else if (argument[0])
+	{
+		serial_print("Usage: report [all|change H S]\n");
+		return;
+	}
+
+	if (!report.on_change)
+	{
+		serial_print("Report: all samples\n");
+		return;
+	}
+
+	serial_printf_P(PSTR("Report: change > %u (0.1 C)\n"), report.hysteresis);
+	serial_printf_P(PSTR("Heartbeat: %u s\n"), report.heartbeat);
+	return;
+}
+
+/******************************************************************************
+* Kommandot adapt aktiverar ("on") eller stänger av ("off") adaptiv
+* avläsning (se AdaptiveSampling.h), varvid skalfaktorn för den dynamiska
+* timerns fördröjningstid återställs till 1. Därefter skrivs aktuellt
+* tillstånd ut, vilket även sker utan argument.
+******************************************************************************/
+static void command_adapt(const char* argument)
+{
+	if (strcmp(argument, "on") == 0 || strcmp(argument, "off") == 0)
+	{
+		AdaptiveSampling_enable(&adaptive, strcmp(argument, "on") == 0);
+		DynamicTimer_set_scale(&timer1, adaptive.scale);
+	}
+
+	else if (argument[0])
+	{
+		serial_print("Usage: adapt [on|off]\n");
+		return;
+	}
+
+	AdaptiveSampling_print(&adaptive);
+	return;
+}
+
+#ifdef ISR_PROFILER_ENABLED
+/******************************************************************************
+* Kommandot prof skriver ut profilerarens tabell över avbrottsrutiner.
+* Med argumentet reset nollställs tabellen i stället.
+******************************************************************************/
+static void command_prof(const char* argument)
+{
+	if (strcmp(argument, "reset") == 0)
+	{
+		Profiler_reset();
+		serial_print("ISR profile cleared.\n");
+		return;
+	}
+
+	Profiler_print();
+	return;
+}
+#endif
+
+#ifdef CPU_LOAD_ENABLED
+/******************************************************************************
+* Kommandot load skriver ut processorns belastning för de senaste
+* mätfönstren samt högsta belastning. Med argumentet reset nollställs
+* mätfönstren i stället.
+******************************************************************************/
+static void command_load(const char* argument)
+{
+	if (strcmp(argument, "reset") == 0)
+	{
+		CpuLoad_reset();
+		serial_print("CPU load cleared.\n");
+		return;
+	}
+
+	CpuLoad_print();
+	return;
+}
+#endif
+
+#ifdef TIMER_JITTER_ENABLED
+/******************************************************************************
+* Kommandot jitter skriver ut histogrammet över avvikelser mellan uppmätt
+* och nominell period för den dynamiska timern. Med argumentet reset
+* nollställs histogrammet i stället.
+******************************************************************************/
+static void command_jitter(const char* argument)
+{
+	if (strcmp(argument, "reset") == 0)
+	{
+		TimerJitter_reset();
+		serial_print("Timer jitter cleared.\n");
+		return;
+	}
+
+	TimerJitter_print();
+	return;
+}
+#endif
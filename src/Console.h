@@ -0,0 +1,42 @@
+
+#ifndef CONSOLE_H_
+#define CONSOLE_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+#include <avr/pgmspace.h>
+
+/******************************************************************************
+* Konsolen möjliggör enkla textkommandon via seriell överföring från PC,
+* exempelvis "mem" för utskrift av minnesanvändning. Mottagna tecken lagras
+* av avbrottsrutinen för seriell mottagning via anrop av Console_receive
+* tills ett radslut (\r eller \n) tas emot. Själva kommandot exekveras sedan
+* i programmets huvudloop via anrop av Console_process, så att utskrifter
+* inte sker i avbrottsrutinen. Tecken som tas emot medan ett kommando väntar
+* på att exekveras ignoreras.
+*
+* Ett kommando består av ett namn, eventuellt följt av ett mellanslag och
+* ett argument, som passeras till kommandots funktion. Kommandon lagras i
+* en tabell i flashminnet i Console.c.
+******************************************************************************/
+
+#define CONSOLE_LINE_SIZE 32		// Maximal längd på en kommandorad (inklusive nolltecken).
+#define CONSOLE_NAME_SIZE 8		// Maximal längd på ett kommandonamn (inklusive nolltecken).
+
+typedef void (*ConsoleHandler)(const char* argument);
+
+/******************************************************************************
+* Strukten ConsoleCommand kopplar samman ett kommandonamn med den funktion
+* som exekveras när kommandot tas emot.
+******************************************************************************/
+struct ConsoleCommand
+{
+	char name[CONSOLE_NAME_SIZE];	// Kommandots namn.
+	ConsoleHandler handler;		// Funktion som exekveras, argument passeras som parameter.
+};
+
+// Funktionsdeklarationer:
+void Console_receive(const char data);
+void Console_process(void);
+
+#endif /* CONSOLE_H_ */
@@ -0,0 +1,153 @@
+// Inkluderingsdirektiv:
+#include "CpuLoad.h"
+#include "Serial.h"
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+
+#ifdef CPU_LOAD_ENABLED
+
+#define CPU_LOAD_WINDOW_TICKS ((uint32_t)CPU_LOAD_WINDOW * CLOCK_TICKS_PER_MS)	// Mätfönstrets längd i uppräkningar.
+
+static volatile uint32_t isr_ticks = 0x00;		// Total tid i avbrottsrutiner.
+static uint32_t main_ticks = 0x00;			// Total tid i huvudloopen.
+static uint32_t loop_start = 0x00;			// Tidpunkt då pågående varv i huvudloopen startade.
+static uint32_t loop_isr = 0x00;			// Tid i avbrottsrutiner då pågående varv startade.
+static uint32_t window_start = 0x00;			// Tidpunkt då pågående mätfönster startade.
+static uint32_t window_isr = 0x00;			// Tid i avbrottsrutiner då pågående mätfönster startade.
+static uint32_t window_main = 0x00;			// Tid i huvudloopen då pågående mätfönster startade.
+static struct CpuLoadWindow windows[CPU_LOAD_WINDOWS];	// Senaste mätfönstren.
+static uint8_t next = 0x00;				// Index för nästa mätfönster.
+static uint8_t count = 0x00;				// Antal sparade mätfönster.
+static struct CpuLoadWindow peak;			// Mätfönstret med högst belastning.
+
+// Statiska funktioner:
+static void close_window(const uint32_t now, const uint32_t isr);
+static void print_window(const char* name, const struct CpuLoadWindow* window);
+
+/******************************************************************************
+* Funktionen CpuLoad_interrupt anropas via makrot CPU_LOAD_EXIT vid slutet
+* av en avbrottsrutin, där start utgör tidpunkten då rutinen startade.
+* Exekveringstiden läggs till total tid i avbrottsrutiner.
+******************************************************************************/
+void CpuLoad_interrupt(const uint16_t start)
+{
+	isr_ticks += (uint16_t)(Clock_now16() - start);
+	return;
+}
+
+/******************************************************************************
+* Funktionen CpuLoad_begin anropas vid början av funktionen loop och lagrar
+* starttiden samt tid i avbrottsrutiner, så att denna kan dras bort från
+* varvets längd.
+******************************************************************************/
+void CpuLoad_begin(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		loop_start = Clock_now();
+		loop_isr = isr_ticks;
+	}
+
+	return;
+}
+
+/******************************************************************************
+* Funktionen CpuLoad_end anropas vid slutet av funktionen loop. Varvets
+* längd, minus tid i avbrottsrutiner under varvet, läggs till total tid i
+* huvudloopen. Om pågående mätfönster har löpt ut stängs det.
+******************************************************************************/
+void CpuLoad_end(void)
+{
+	uint32_t now;
+	uint32_t isr;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		now = Clock_now();
+		isr = isr_ticks;
+	}
+
+	main_ticks += (now - loop_start) - (isr - loop_isr);
+	if (now - window_start >= CPU_LOAD_WINDOW_TICKS) close_window(now, isr);
+	return;
+}
+
+/******************************************************************************
+* Funktionen CpuLoad_reset nollställer sparade mätfönster samt högsta
+* belastning, varefter ett nytt mätfönster påbörjas.
+******************************************************************************/
+void CpuLoad_reset(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		window_start = Clock_now();
+		window_isr = isr_ticks;
+	}
+
+	window_main = main_ticks;
+	next = 0x00;
+	count = 0x00;
+	peak.isr = 0x00;
+	peak.main = 0x00;
+	return;
+}
+
+/******************************************************************************
+* Funktionen CpuLoad_print skriver ut sparade mätfönster, senaste fönstret
+* först, samt fönstret med högst belastning. Belastningen skrivs ut i
+* procent med en decimal.
+******************************************************************************/
+void CpuLoad_print(void)
+{
+	serial_printf_P(PSTR("CPU load, %u ms windows:\n"), CPU_LOAD_WINDOW);
+
+	for (register uint8_t i = 0; i < count; i++)
+	{
+		print_window(PSTR("   "), &windows[(next + CPU_LOAD_WINDOWS - 1 - i) % CPU_LOAD_WINDOWS]);
+	}
+
+	print_window(PSTR("peak"), &peak);
+	return;
+}
+
+/******************************************************************************
+* Funktionen close_window beräknar belastningen för pågående mätfönster i
+* promille av fönstrets faktiska längd, vilken kan överstiga
+* CPU_LOAD_WINDOW om huvudloopen har blockerats. Fönstret sparas och
+* högsta belastning uppdateras, varefter nästa fönster påbörjas.
+******************************************************************************/
+static void close_window(const uint32_t now, const uint32_t isr)
+{
+	const uint32_t scale = (now - window_start) / 1000;
+	struct CpuLoadWindow* window = &windows[next];
+
+	const uint32_t isr_load = (isr - window_isr) / scale;
+	const uint32_t main_load = (main_ticks - window_main) / scale;
+	window->isr = isr_load > 1000 ? 1000 : (uint16_t)isr_load;
+	window->main = main_load > 1000U - window->isr ? 1000U - window->isr : (uint16_t)main_load;
+
+	if (window->isr + window->main > peak.isr + peak.main) peak = *window;
+
+	next = (next + 1) % CPU_LOAD_WINDOWS;
+	if (count < CPU_LOAD_WINDOWS) count++;
+
+	window_start = now;
+	window_isr = isr;
+	window_main = main_ticks;
+	return;
+}
+
+/******************************************************************************
+* Funktionen print_window skriver ut ett mätfönster på en rad, där name
+* lagras i flashminnet.
+******************************************************************************/
+static void print_window(const char* name, const struct CpuLoadWindow* window)
+{
+	const uint16_t idle = 1000 - window->isr - window->main;
+	serial_print_P(name);
+	serial_printf_P(PSTR(" isr %u.%u%%, main %u.%u%%, idle %u.%u%%\n"),
+		window->isr / 10, window->isr % 10, window->main / 10, window->main % 10, idle / 10, idle % 10);
+	return;
+}
+
+#endif /* CPU_LOAD_ENABLED */
@@ -0,0 +1,73 @@
+
+#ifndef CPULOAD_H_
+#define CPULOAD_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+#include "Clock.h"
+
+/******************************************************************************
+* CpuLoad mäter processorns belastning uppdelad i tid i avbrottsrutiner,
+* tid i huvudloopen samt vilotid, mätt via klockan (se Clock.h) med
+* upplösningen 4 us:
+*
+* - Avbrottsrutiner: makrot CPU_LOAD_ENTER anropas vid början och makrot
+*   CPU_LOAD_EXIT vid slutet av varje avbrottsrutin, varvid rutinens
+*   exekveringstid summeras. Avbrottets svarstid samt rutinens in- och
+*   uthopp räknas därmed inte, och exekveringstiden för mycket korta
+*   avbrottsrutiner avrundas till hela uppräkningar.
+* - Huvudloopen: CpuLoad_begin anropas vid början och CpuLoad_end vid
+*   slutet av funktionen loop, där tid i avbrottsrutiner under tiden dras
+*   bort.
+* - Vilotid: återstående tid, det vill säga tid i viloläge (se main.c)
+*   samt mellan varven i huvudloopen.
+*
+* Belastningen beräknas i promille per mätfönster om CPU_LOAD_WINDOW
+* millisekunder, där de senaste CPU_LOAD_WINDOWS fönstren sparas, samt det
+* fönster med högst total belastning (avbrottsrutiner plus huvudloop)
+* sedan start eller senaste nollställning. Mätfönstren stängs från
+* huvudloopen via CpuLoad_end, varför ett fönster kan bli något längre om
+* huvudloopen blockeras.
+*
+* Precis som profileraren (se Profiler.h) kompileras mätningen enbart in i
+* debug-byggen. Vid release-byggen, där makrot NDEBUG är definierat, eller
+* ifall DISABLE_CPU_LOAD är definierat, expanderar makrona till ingenting.
+******************************************************************************/
+
+#if !defined(NDEBUG) && !defined(DISABLE_CPU_LOAD)
+#define CPU_LOAD_ENABLED
+#endif
+
+#define CPU_LOAD_WINDOW 1000	// Mätfönstrets längd mätt i millisekunder.
+#define CPU_LOAD_WINDOWS 8	// Antal sparade mätfönster.
+
+/******************************************************************************
+* Strukten CpuLoadWindow lagrar belastningen för ett mätfönster i promille,
+* där vilotiden utgör resterande del upp till 1000.
+******************************************************************************/
+struct CpuLoadWindow
+{
+	uint16_t isr;	// Andel tid i avbrottsrutiner.
+	uint16_t main;	// Andel tid i huvudloopen.
+};
+
+#ifdef CPU_LOAD_ENABLED
+#define CPU_LOAD_ENTER() const uint16_t cpu_load_start = Clock_now16()
+#define CPU_LOAD_EXIT() CpuLoad_interrupt(cpu_load_start)
+#define CPU_LOAD_BEGIN() CpuLoad_begin()
+#define CPU_LOAD_END() CpuLoad_end()
+#else
+#define CPU_LOAD_ENTER()
+#define CPU_LOAD_EXIT()
+#define CPU_LOAD_BEGIN()
+#define CPU_LOAD_END()
+#endif
+
+// Funktionsdeklarationer (enbart tillgängliga då mätningen är aktiverad):
+void CpuLoad_interrupt(const uint16_t start);
+void CpuLoad_begin(void);
+void CpuLoad_end(void);
+void CpuLoad_reset(void);
+void CpuLoad_print(void);
+
+#endif /* CPULOAD_H_ */
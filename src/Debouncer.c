@@ -0,0 +1,65 @@
+// Inkluderingsdirektiv:
+#include "Debouncer.h"
+
+/******************************************************************************
+* Strukten VerticalCounter lagrar filtrerad nivå samt räknarbitar för
+* samtliga PINs på en I/O-port.
+******************************************************************************/
+struct VerticalCounter
+{
+	uint8_t state;		// Filtrerad nivå per PIN.
+	uint8_t count0;		// Räknarens minst signifikanta bit per PIN.
+	uint8_t count1;		// Räknarens mest signifikanta bit per PIN.
+};
+
+static struct VerticalCounter counters[PIN_CHANGE_PORTS];	// Vertikala räknare per I/O-port.
+static struct TimerChannel tick;				// Compare-kanal som genererar avläsningarna.
+
+/******************************************************************************
+* Funktionen init_Debouncer anropas vid start efter att tryckknapparnas
+* callbackfunktioner har registrerats. Aktuella insignaler lagras som
+* filtrerad nivå och samtliga räknare nollställs, varefter periodisk
+* avläsning startas via compare-kanal B på Timer 2. Klockan måste vara
+* initierad (se Clock.h).
+******************************************************************************/
+void init_Debouncer(void)
+{
+	for (register uint8_t i = 0; i < PIN_CHANGE_PORTS; i++)
+	{
+		counters[i].state = PORT_PIN_REGISTER(i);
+		counters[i].count0 = 0xFF;
+		counters[i].count1 = 0xFF;
+	}
+
+	tick = new_TimerChannel(TIMER2, CHANNEL_B, DEBOUNCE_PERIOD, Debouncer_sample);
+	TimerChannel_on(&tick);
+	return;
+}
+
+/******************************************************************************
+* Funktionen Debouncer_sample anropas från avbrottsrutinen TIMER2_COMPB_vect
+* var DEBOUNCE_PERIOD:e millisekund. Varje I/O-ports insignaler läses en
+* gång och filtreras via portens vertikala räknare. För PINs som har
+* växlat nivå och har registrerade callbackfunktioner anropas pressed
+* respektive released via PinChange_dispatch.
+******************************************************************************/
+void Debouncer_sample(void)
+{
+	const uint32_t time = Clock_now() - (uint32_t)(DEBOUNCE_SAMPLES - 1) * DEBOUNCE_PERIOD * CLOCK_TICKS_PER_MS;
+
+	for (register uint8_t i = 0; i < PIN_CHANGE_PORTS; i++)
+	{
+		struct VerticalCounter* counter = &counters[i];
+		uint8_t delta = PORT_PIN_REGISTER(i) ^ counter->state;
+
+		counter->count0 = ~(counter->count0 & delta);
+		counter->count1 = counter->count0 ^ (counter->count1 & delta);
+		delta &= counter->count0 & counter->count1;
+		counter->state ^= delta;
+
+		delta &= PinChange_attached(i);
+		if (delta) PinChange_dispatch(i, delta, counter->state, time);
+	}
+
+	return;
+}
@@ -0,0 +1,43 @@
+
+#ifndef DEBOUNCER_H_
+#define DEBOUNCER_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+#include "PinChange.h"
+#include "TimerChannel.h"
+
+/******************************************************************************
+* Debouncer utgör ett alternativ till bouncetid via maskerade PCI-avbrott,
+* där en PIN är blind i 300 ms efter varje flank. I stället avläses
+* samtliga registrerade PINs (se PinChange_attach) periodiskt via
+* compare-kanal B på Timer 2, var DEBOUNCE_PERIOD:e millisekund. En ändrad
+* insignal godtas först när den har varit stabil under DEBOUNCE_SAMPLES
+* avläsningar i följd, det vill säga efter 4 ms, varefter registrerad
+* callbackfunktion för nedtryckning respektive släpp anropas via
+* PinChange_dispatch. Därmed hanteras även snabba knapptryckningar, där
+* både nedtryckning och släpp rapporteras.
+*
+* Filtreringen sker via vertikala räknare, där varje I/O-port har en
+* tvåbitars räknare per PIN lagrad som två byte (en byte per räknarbit).
+* Samtliga åtta PINs på en port filtreras därmed parallellt med ett fåtal
+* bitoperationer, oavsett antal tryckknappar:
+*
+* delta = sample ^ state		PINs vars avläsning skiljer sig från filtrerad nivå.
+* count0 = ~(count0 & delta)		Räknarna nollställs (värde 3) för PINs utan skillnad,
+* count1 = count0 ^ (count1 & delta)	övriga räknas ned ett steg.
+* toggle = delta & count0 & count1	PINs vars räknare har slagit runt växlar nivå.
+*
+* Händelsens tidpunkt (se PinChange_time) utgörs av tidpunkten för första
+* avläsningen med ny nivå. Debouncer aktiveras vid kompilering med makrot
+* ENABLE_SAMPLED_DEBOUNCE, varvid PCI-avbrott inte används för tryckknappar.
+******************************************************************************/
+
+#define DEBOUNCE_PERIOD 1	// Tid mellan avläsningar mätt i millisekunder.
+#define DEBOUNCE_SAMPLES 4	// Antal stabila avläsningar innan ny nivå godtas.
+
+// Funktionsdeklarationer:
+void init_Debouncer(void);
+void Debouncer_sample(void);
+
+#endif /* DEBOUNCER_H_ */
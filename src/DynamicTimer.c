@@ -1,6 +1,11 @@
 #include "DynamicTimer.h"
+#include <string.h>
 
 static inline size_t check_capacity(const size_t capacity);
+static inline uint32_t rescaled(uint32_t executed, uint32_t previous, const uint32_t required);
+static void apply_settings(struct DynamicTimer* self);
+static void set_required(struct DynamicTimer* self, const uint32_t required);
+static uint32_t scaled(const struct DynamicTimer* self, const uint32_t estimate);
 
 /************************************************************************
 * Funktionen används för att implementera en ny dynamisk timer.
@@ -12,11 +17,28 @@ struct DynamicTimer new_DynamicTimer(const TimerSelection timerSelection, const
 {
 	struct DynamicTimer self;				// Skapar objektet self av strukten DynamicTimer.
 	self.timer = new_Timer(timerSelection, 0x00);		// Initierar timern, av vid start.
+	self.pending_interrupts = 0x00;				// Ingen väntande fördröjningstid vid start.
+	self.scale = DYNAMIC_TIMER_SCALE_ONE;			// Skattad fördröjningstid används oskalad vid start.
+	self.min_interrupts = (uint32_t)(DYNAMIC_TIMER_MIN_PERIOD / self.timer.interrupt_time);	// Gränser för skalad fördröjningstid,
+	self.max_interrupts = (uint32_t)(DYNAMIC_TIMER_MAX_PERIOD / self.timer.interrupt_time);	// beräknade en gång för vald timerkrets.
 	self.interrupt_vector = new_Vector();			// Initierar tom dynamisk array.
 	self.interrupt_counter = 0x00;				// Avbrottsräknaren startar på noll.
 	self.capacity = check_capacity(capacity);		// Sparar kontrollerad kapacitet.
 	self.next = 0x00;					// Nästa element är första element vid start, på index noll.
+	self.sum = 0x00;					// Inga lagrade element vid start.
 	self.initiated = false;					// Timerns startvärde är false (av). Har ej startat förrän vi trycker på knappen.
+	self.estimator = new_IntervalEstimator(INTERVAL_ESTIMATOR);	// Strategi för skattning av fördröjningstiden.
+	self.sequence = new_SeqCount();				// Sekvensräknare för läsning från huvudloopen.
+	const struct DynamicTimerSettings settings = { INTERVAL_ESTIMATOR, self.estimator.quantile };
+	DoubleBuffer_init(&self.settings, settings);		// Inställningar vid start.
+	self.applied_settings = 0x00;				// Inställningarna vid start är redan tillämpade.
+	self.last_interval = 0x00;				// Inget intervall uppmätt vid start.
+	self.updates = 0x00;					// Ingen uppdatering vid start.
+	self.store_failures = 0x00;				// Inga misslyckade lagringar vid start.
+	self.reported_updates = 0x00;				// Ingen uppdatering att skriva ut vid start.
+	self.reported_failures = 0x00;				// Inga misslyckade lagringar att skriva ut vid start.
+	self.reported_capacity = self.capacity;			// Kapaciteten vid start skrivs inte ut.
+	self.reported_initiated = false;			// Start skrivs ut efter första knapptryckningen.
 	return self;						// Returnerar det färdiga objektet.
 }
 
@@ -66,76 +88,128 @@ void DynamicTimer_count(struct DynamicTimer* self)
 {
 	if (self->timer.enabled)
 	{
+		SeqCount_write_begin(&self->sequence);
 		self->timer.executed_interrupts++;
 		self->interrupt_counter++;
+		SeqCount_write_end(&self->sequence);
 	}
 }
 
 /************************************************************************
 * Indikerar ifall timern har löpt ut. 
 * Om timern inte är igång så returneras false, 
-* annars kontrolleras ifall timern har löpt ut.
+* annars kontrolleras ifall timern har löpt ut. Vid utlöpning tillämpas
+* en väntande fördröjningstid (se UPDATE_AT_EXPIRY), så att nästa period
+* har den nya längden.
 ************************************************************************/
 bool DynamicTimer_elapsed(struct DynamicTimer* self)
  {
 	if (!self->timer.required_interrupts) return false; 
-	return Timer_elapsed(&self->timer); 
+	if (!Timer_elapsed(&self->timer)) return false;
+	
+	if (self->pending_interrupts)
+	{
+		SeqCount_write_begin(&self->sequence);
+		self->timer.required_interrupts = self->pending_interrupts;
+		self->pending_interrupts = 0x00;
+		SeqCount_write_end(&self->sequence);
+	}
+	
+	return true;
  }
  
  /************************************************************************
  * DynamicTimer_clear används för att nollställa vektorn genom att
- * frigöra allokerat minne. 
+ * frigöra allokerat minne. Nollställningen sker med avbrott inaktiverade,
+ * så att funktionen även kan anropas från huvudloopen.
  ************************************************************************/ 
 void DynamicTimer_clear(struct DynamicTimer* self)
 {
-	Timer_reset(&self->timer);			// Nollställer timern.
-	Vector_clear(&self->interrupt_vector);		// Nollställer vektorn.
-	self->interrupt_counter = 0x00;			// Nollställer avbrottsräknaren.
-	self->next = 0x00;				// Nästa element vid start nollställs.
-	self->initiated = false;			// Dynamiska timern är ej initierad.
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		SeqCount_write_begin(&self->sequence);
+		Timer_reset(&self->timer);			// Nollställer timern.
+		self->pending_interrupts = 0x00;		// Ingen väntande fördröjningstid.
+		Vector_clear(&self->interrupt_vector);		// Nollställer vektorn.
+		IntervalEstimator_sync(&self->estimator, &self->interrupt_vector);
+		self->interrupt_counter = 0x00;			// Nollställer avbrottsräknaren.
+		self->next = 0x00;				// Nästa element vid start nollställs.
+		self->sum = 0x00;				// Summan av lagrade element nollställs.
+		self->initiated = false;			// Dynamiska timern är ej initierad.
+		SeqCount_write_end(&self->sequence);
+	}
 	return;
 }
 
 /************************************************************************
 * DynamicTimer_update används för att uppdatera tiden på en dynamisk timer.
+* Antalet avbrott sedan föregående knapptryckning utgör ett nytt intervall,
+* varefter avbrottsräknaren nollställs inför nästa uppräkning. Intervallet
+* lagras i vektorn ifall vald strategi kräver detta, där det äldsta
+* elementet skrivs över när vektorn är full. Slutligen skattas ny
+* fördröjningstid via den dynamiska timerns skattare, vilken skalas (se
+* DynamicTimer_set_scale) och tillämpas enligt DYNAMIC_TIMER_UPDATE (se
+* set_required). Inställningar som
+* har publicerats från huvudloopen tillämpas innan intervallet hanteras.
+* Funktionen anropas från avbrottsrutinen för tryckknappen. Intervallet,
+* summan av lagrade intervall samt misslyckade lagringar sparas inom
+* sekvensräknaren och skrivs ut från huvudloopen (se DynamicTimer_report),
+* så att avbrottsrutinen inte blockeras av utskrifter.
 ************************************************************************/
 void DynamicTimer_update(struct DynamicTimer* self)
 {
 	
 	if (!self->initiated)					// Om timern ej är startad, så nollställs samt startas den.
 	{
+		SeqCount_write_begin(&self->sequence);
 		self->interrupt_counter = 0x00;			// Nollställer räknaren.
-		self->initiated = true;				// Indikerar att timern är igång.
-		serial_print("Dynamic timer initiated!\n");
+		self->initiated = true;				// Indikerar att timern är igång, skrivs ut från huvudloopen.
+		SeqCount_write_end(&self->sequence);
 		return;
 	}
 	
-	if (self->interrupt_vector.elements < self->capacity)	// Om vektorn inte är full, lägg till det nya elementet längst bak (push).
-	{
-		Vector_push(&self->interrupt_vector, self->interrupt_counter);
-	}
-	else							// Annars skrivs det äldsta elementet över:	
-	{
-		Vector_set(&self->interrupt_vector, self->next, self->interrupt_counter);	
-		self->interrupt_counter = 0x00;			// Nollställer inför nästa uppräkning.
-	}
+	if (self->settings.generation != self->applied_settings)	// Tillämpar nya inställningar från huvudloopen.
+		apply_settings(self);
 	
+	SeqCount_write_begin(&self->sequence);
+	const uint32_t interval = self->interrupt_counter;	// Antalet avbrott sedan föregående knapptryckning.
+	self->interrupt_counter = 0x00;				// Nollställer inför nästa uppräkning.
+	self->last_interval = interval;				// Sparas för utskrift från huvudloopen.
+	self->updates++;
 	
-	if (++self->next > self->capacity) // Inkrementerar next, om dess värde är större än kapacieteten (Om nytt index hamnar utanför array), börja om från noll:
+	if (IntervalEstimator_uses_history(&self->estimator))
 	{
-		self->next = 0x00;	
+		if (self->interrupt_vector.elements < self->capacity)	// Om vektorn inte är full, lägg till det nya elementet längst bak (push).
+		{
+			if (Vector_push(&self->interrupt_vector, interval)) self->sum += interval;
+			else self->store_failures++;			// Skrivs ut från huvudloopen.
+		}
+		else							// Annars skrivs det äldsta elementet över:	
+		{
+			const uint32_t oldest = self->interrupt_vector.data[self->next];
+			IntervalEstimator_remove(&self->estimator, oldest);
+			Vector_set(&self->interrupt_vector, self->next, interval);	
+			self->sum += interval - oldest;
+		}
+		
+		if (++self->next >= self->capacity) // Inkrementerar next, om nytt index hamnar utanför arrayen, börja om från noll:
+		{
+			self->next = 0x00;	
+		}
 	}
 	
+	const uint32_t required = IntervalEstimator_update(&self->estimator, interval, &self->interrupt_vector);
+	set_required(self, scaled(self, required));
+	SeqCount_write_end(&self->sequence);
+	TRACE(TRACE_INTERVAL, Trace_interval(interval));
+	TRACE(TRACE_ESTIMATE, Trace_interval(required));
 	
-	// Beräknar genomsnittligt antal interrupt mellan knapptryckningar, avrundas till närmsta heltal:
-	const uint32_t average_interrupts = ((uint32_t)Vector_average(&self->interrupt_vector) + 0.5);
-	self->timer.required_interrupts = average_interrupts;
-	
-	serial_print("Dynamic timer updated!\n");
-	DynamicTimer_print(self);				// Skriver ut all information.
-	
-	if (self->interrupt_vector.elements > 9)
+	if (self->interrupt_vector.elements > 9 && self->capacity > 10)	// Begränsar kapaciteten en gång, utan utskrift vid varje uppdatering.
+	{
+		SeqCount_write_begin(&self->sequence);
 		DynamicTimer_set_capacity(self, 10);
+		SeqCount_write_end(&self->sequence);
+	}
 	return;
 }
 
@@ -145,7 +219,11 @@ void DynamicTimer_update(struct DynamicTimer* self)
 * kontrolleras via ett anrop av funktionen check_capacity. Dess returvärde 
 * tilldelas till instansvariabeln capacity. Om den nya kapaciteten understiger
 * storleken på den dynamiska timerns vektor, så placeras de nyaste värderna
-* längst fram i vektorn följt av en omallokering till den nya storleken.
+* längst fram i vektorn följt av en omallokering till den nya storleken,
+* varefter summan av lagrade element beräknas om. Funktionen anropas inom
+* sekvensräknaren från avbrottsrutinen (eller med avbrott inaktiverade)
+* och skriver inte ut något, utan ny kapacitet skrivs ut från huvudloopen
+* via DynamicTimer_report.
 ************************************************************************/
 void DynamicTimer_set_capacity(struct DynamicTimer* self, const size_t new_capacity)
 {
@@ -155,7 +233,6 @@ void DynamicTimer_set_capacity(struct DynamicTimer* self, const size_t new_capac
 	else if (new_capacity >= self->capacity)	// Om den nya kapaciteten är större än aktuell kapacitet, uppdatera medlemmen capacity:
 	{
 		self->capacity = new_capacity;
-		serial_print_unsigned("Vector capacity resized to %lu elements!\n", self->capacity);
 		return;
 	}
 	// Annars om den nya kapaciteten är mindre än tidigare, flytta de nyaste elementen längst fram i vektorn och ändra sedan storleken:
@@ -168,27 +245,344 @@ void DynamicTimer_set_capacity(struct DynamicTimer* self, const size_t new_capac
 	}
 	
 	Vector_resize(&self->interrupt_vector, new_capacity);		// Ändrar vektorns storlek till den nya kapaciteten.
+	Vector_shrink_to_fit(&self->interrupt_vector);			// Frigör minne som den mindre kapaciteten inte behöver.
+	IntervalEstimator_sync(&self->estimator, &self->interrupt_vector);
+	self->sum = Vector_sum(&self->interrupt_vector);		// Summan av kvarvarande element.
+	if (self->next >= new_capacity) self->next = 0x00;		// Nästa index måste ligga inom den nya kapaciteten.
 	
 	self->capacity = new_capacity;					// Uppdaterar kapaciteten till den nya:
-	serial_print_unsigned("Vector capacity resized to %lu elements!\n", self->capacity);
+	return;
+}
+
+/************************************************************************
+* DynamicTimer_set_estimator används för att byta strategi för skattning
+* av fördröjningstiden från huvudloopen. De nya inställningarna skrivs till
+* den inaktiva bufferten och publiceras, varefter de tillämpas av
+* avbrottsrutinen vid nästa knapptryckning. Aktuell fördröjningstid
+* behålls tills dess.
+************************************************************************/
+void DynamicTimer_set_estimator(struct DynamicTimer* self, const IntervalEstimatorType type, const uint8_t quantile)
+{
+	DoubleBuffer_prepare(&self->settings);
+	DoubleBuffer_pending(&self->settings)->estimator = type;
+	if (quantile) DoubleBuffer_pending(&self->settings)->quantile = quantile;
+	DoubleBuffer_publish(&self->settings);
+	return;
+}
+
+/************************************************************************
+* DynamicTimer_set_scale ställer in skalfaktorn för skattad
+* fördröjningstid i fixpunkt, där DYNAMIC_TIMER_SCALE_ONE motsvarar 1,
+* exempelvis för adaptiv avläsning (se AdaptiveSampling.h). Ny
+* fördröjningstid tillämpas direkt enligt DYNAMIC_TIMER_UPDATE, förutsatt
+* att en fördröjningstid har skattats. Funktionen anropas från huvudloopen.
+************************************************************************/
+void DynamicTimer_set_scale(struct DynamicTimer* self, const uint16_t scale)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		self->scale = scale;
+		
+		if (self->timer.required_interrupts && self->estimator.estimate)
+		{
+			SeqCount_write_begin(&self->sequence);
+			set_required(self, scaled(self, self->estimator.estimate));
+			SeqCount_write_end(&self->sequence);
+		}
+	}
+	
+	return;
+}
+
+/************************************************************************
+* DynamicTimer_settings returnerar senast publicerade inställningar,
+* vilka tillämpas senast vid nästa knapptryckning.
+************************************************************************/
+struct DynamicTimerSettings DynamicTimer_settings(const struct DynamicTimer* self)
+{
+	return *DoubleBuffer_current(&self->settings);
+}
+
+/************************************************************************
+* DynamicTimer_snapshot returnerar en konsistent kopia av den dynamiska
+* timerns värden. Kopieringen upprepas ifall en avbrottsrutin har
+* uppdaterat värdena under tiden, vilket upptäcks via sekvensräknaren,
+* så att avbrott aldrig behöver inaktiveras.
+************************************************************************/
+struct DynamicTimerSnapshot DynamicTimer_snapshot(const struct DynamicTimer* self)
+{
+	struct DynamicTimerSnapshot snapshot;
+	uint8_t sequence;
+	
+	do
+	{
+		sequence = SeqCount_read_begin(&self->sequence);
+		snapshot.interrupt_counter = self->interrupt_counter;
+		snapshot.executed_interrupts = self->timer.executed_interrupts;
+		snapshot.required_interrupts = self->timer.required_interrupts;
+		snapshot.pending_interrupts = self->pending_interrupts;
+		snapshot.elements = self->interrupt_vector.elements;
+		snapshot.capacity = self->capacity;
+		snapshot.next = self->next;
+		snapshot.sum = self->sum;
+		snapshot.estimator = self->estimator.type;
+		snapshot.last_interval = self->last_interval;
+		snapshot.updates = self->updates;
+		snapshot.store_failures = self->store_failures;
+		snapshot.initiated = self->initiated;
+	} while (SeqCount_read_retry(&self->sequence, sequence));
+	
+	return snapshot;
+}
+
+/************************************************************************
+* DynamicTimer_checkpoint kopierar den dynamiska timerns inlärda tillstånd
+* till en kontrollpunkt, där de senaste lagrade intervallen kopieras i
+* kronologisk ordning med början från index next ifall vektorn är full.
+* Kopieringen sker med avbrott inaktiverade, eftersom vektorn kan ändras
+* av avbrottsrutinen. En väntande fördröjningstid lagras i stället för
+* aktuell, eftersom den utgör senaste skattning. Kontrollsumman beräknas
+* inte här.
+************************************************************************/
+void DynamicTimer_checkpoint(const struct DynamicTimer* self, struct DynamicTimerCheckpoint* checkpoint)
+{
+	memset(checkpoint, 0, sizeof(*checkpoint));
+	
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		const size_t elements = self->interrupt_vector.elements;
+		const size_t count = elements < CHECKPOINT_INTERVALS ? elements : CHECKPOINT_INTERVALS;
+		const size_t first = elements < self->capacity ? 0 : self->next;
+		
+		checkpoint->required_interrupts = self->pending_interrupts ? self->pending_interrupts : self->timer.required_interrupts;
+		checkpoint->estimate = self->estimator.estimate;
+		checkpoint->ewma = self->estimator.ewma_initiated ? self->estimator.ewma : 0x00;
+		checkpoint->estimator = (uint8_t)self->estimator.type;
+		checkpoint->quantile = self->estimator.quantile;
+		checkpoint->count = (uint8_t)count;
+		checkpoint->capacity = (uint16_t)self->capacity;
+		
+		for (register size_t i = 0; i < count; i++)
+			checkpoint->intervals[i] = self->interrupt_vector.data[(first + elements - count + i) % elements];
+	}
+	
+	return;
+}
+
+/************************************************************************
+* DynamicTimer_restore återställer den dynamiska timerns inlärda tillstånd
+* från en kontrollpunkt, vilket görs vid start innan timern aktiveras.
+* Strategi och inställningar återställs, varefter lagrade intervall läggs
+* tillbaka i vektorn och skattningen återupptas. Fördröjningstiden gäller
+* direkt, medan nästa intervall mäts från första knapptryckningen.
+* Återställd kapacitet skrivs inte ut som ändrad (se DynamicTimer_report). Om
+* strategin eller kapaciteten ligger utanför tillåtet intervall (kapaciteten
+* måste vara 1 - MAX_CAPACITY) avvisas kontrollpunkten och false returneras,
+* utan att timerns tillstånd ändras. Annars returneras true.
+************************************************************************/
+bool DynamicTimer_restore(struct DynamicTimer* self, const struct DynamicTimerCheckpoint* checkpoint)
+{
+	if (checkpoint->estimator > ESTIMATOR_QUANTILE) return false;
+	if (!checkpoint->capacity || check_capacity(checkpoint->capacity) != checkpoint->capacity) return false;
+	const struct DynamicTimerSettings settings = { (IntervalEstimatorType)checkpoint->estimator, checkpoint->quantile };
 	
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		SeqCount_write_begin(&self->sequence);
+		DoubleBuffer_init(&self->settings, settings);
+		self->applied_settings = 0x00;
+		IntervalEstimator_set_type(&self->estimator, settings.estimator);
+		if (settings.estimator == ESTIMATOR_QUANTILE) IntervalEstimator_set_quantile(&self->estimator, settings.quantile);
+		IntervalEstimator_resume(&self->estimator, checkpoint->estimate, checkpoint->ewma);
+		
+		self->capacity = checkpoint->capacity;
+		Vector_clear(&self->interrupt_vector);
+		
+		for (register uint8_t i = 0; i < checkpoint->count && i < self->capacity; i++)
+			Vector_push(&self->interrupt_vector, checkpoint->intervals[i]);
+		
+		IntervalEstimator_sync(&self->estimator, &self->interrupt_vector);
+		self->next = self->interrupt_vector.elements % self->capacity;
+		self->sum = Vector_sum(&self->interrupt_vector);
+		self->timer.required_interrupts = checkpoint->required_interrupts;
+		self->timer.executed_interrupts = 0x00;
+		self->pending_interrupts = 0x00;
+		SeqCount_write_end(&self->sequence);
+	}
+	
+	self->reported_capacity = self->capacity;
+	LOG_INFO("Dynamic timer restored: %lu interrupts\n", (unsigned long)checkpoint->required_interrupts);
+	return true;
+}
+
+/************************************************************************
+* set_required tillämpar en ny fördröjningstid enligt DYNAMIC_TIMER_UPDATE.
+* Om ingen fördröjningstid har skattats tidigare startar första perioden
+* direkt vid knapptryckningen. Vid UPDATE_RESCALE skalas antalet
+* exekverade avbrott om till samma andel av den nya perioden (se
+* rescaled), vilket alltid understiger den nya fördröjningstiden. Därmed
+* löper timern aldrig ut direkt efter en uppdatering. Vid UPDATE_AT_EXPIRY lagras den
+* nya tiden i stället tills pågående period har löpt ut. Funktionen
+* anropas inom sekvensräknaren i DynamicTimer_update.
+************************************************************************/
+static void set_required(struct DynamicTimer* self, const uint32_t required)
+{
+	const uint32_t previous = self->timer.required_interrupts;
+	
+	if (!previous || !required)
+	{
+		self->timer.executed_interrupts = 0x00;
+		self->timer.required_interrupts = required;
+		self->pending_interrupts = 0x00;
+	}
+	else if (DYNAMIC_TIMER_UPDATE == UPDATE_AT_EXPIRY)
+	{
+		self->pending_interrupts = required != previous ? required : 0x00;
+	}
+	else
+	{
+		const uint32_t executed = self->timer.executed_interrupts < previous ? self->timer.executed_interrupts : previous - 1;
+		self->timer.executed_interrupts = rescaled(executed, previous, required);
+		self->timer.required_interrupts = required;
+	}
+	
+	return;
+}
+
+/************************************************************************
+* rescaled returnerar antalet exekverade avbrott omräknat till samma andel
+* av den nya fördröjningstiden required, där executed understiger
+* previous. Andelen executed / previous beräknas i fixpunkt (Q16) med
+* 32-bitars heltal, så att avbrottsrutinen inte behöver 64-bitars
+* division. Överstiger previous 16 bitar skiftas båda värdena först ned,
+* vilket ger ett relativt fel om högst 2^-15. Andelen begränsas till
+* 0xFFFF / 0x10000, varför resultatet alltid understiger required.
+* Multiplikationen delas upp i required:s övre och undre 16 bitar, så att
+* ingen mellanprodukt överstiger 32 bitar.
+************************************************************************/
+static inline uint32_t rescaled(uint32_t executed, uint32_t previous, const uint32_t required)
+{
+	while (previous > 0xFFFF)
+	{
+		previous >>= 1;
+		executed >>= 1;
+	}
+	
+	uint32_t ratio = (executed << 16) / previous;
+	if (ratio > 0xFFFF) ratio = 0xFFFF;
+	return (required >> 16) * ratio + (((required & 0xFFFF) * ratio) >> 16);
+}
+
+/************************************************************************
+* scaled returnerar skattad fördröjningstid multiplicerad med
+* skalfaktorn. Skalad fördröjningstid begränsas till intervallet
+* DYNAMIC_TIMER_MIN_PERIOD - DYNAMIC_TIMER_MAX_PERIOD, omräknat till antal
+* avbrott för timerns timerkrets vid initieringen, medan oskalad
+* fördröjningstid returneras oförändrad.
+************************************************************************/
+static uint32_t scaled(const struct DynamicTimer* self, const uint32_t estimate)
+{
+	if (self->scale == DYNAMIC_TIMER_SCALE_ONE) return estimate;
+	
+	const uint32_t required = (uint32_t)(((uint64_t)estimate * self->scale) / DYNAMIC_TIMER_SCALE_ONE);
+	if (required < self->min_interrupts) return self->min_interrupts;
+	if (required > self->max_interrupts) return self->max_interrupts;
+	return required;
+}
+
+/************************************************************************
+* apply_settings tillämpar publicerade inställningar från huvudloopen.
+* Om den nya strategin inte använder lagrade intervall töms vektorn, så att
+* inaktuella intervall inte används vid ett senare byte. Skattarens
+* sorterade kopia synkroniseras därefter med vektorn.
+************************************************************************/
+static void apply_settings(struct DynamicTimer* self)
+{
+	const struct DynamicTimerSettings* settings = DoubleBuffer_current(&self->settings);
+	self->applied_settings = self->settings.generation;
+	
+	SeqCount_write_begin(&self->sequence);
+	IntervalEstimator_set_type(&self->estimator, settings->estimator);
+	if (settings->estimator == ESTIMATOR_QUANTILE) IntervalEstimator_set_quantile(&self->estimator, settings->quantile);
+	
+	if (!IntervalEstimator_uses_history(&self->estimator))
+	{
+		Vector_clear(&self->interrupt_vector);
+		self->next = 0x00;
+		self->sum = 0x00;
+	}
+	
+	IntervalEstimator_sync(&self->estimator, &self->interrupt_vector);
+	SeqCount_write_end(&self->sequence);
+	TRACE(TRACE_ESTIMATOR, settings->estimator);
+	return;
+}
+
+/************************************************************************
+* DynamicTimer_report anropas från programmets huvudloop och skriver ut
+* händelser från avbrottsrutinen: att timern har startats, att kapaciteten
+* har ändrats samt att intervall inte kunde lagras. Därefter skrivs senast
+* uppmätta intervall samt den dynamiska timerns värden ut efter varje
+* uppdatering. Om flera uppdateringar har skett sedan föregående anrop
+* skrivs enbart den senaste ut.
+************************************************************************/
+void DynamicTimer_report(struct DynamicTimer* self)
+{
+	const struct DynamicTimerSnapshot snapshot = DynamicTimer_snapshot(self);
+	
+	if (snapshot.initiated != self->reported_initiated)
+	{
+		self->reported_initiated = snapshot.initiated;
+		if (snapshot.initiated) LOG_INFO("Dynamic timer initiated!\n");
+	}
+	
+	if (snapshot.capacity != self->reported_capacity)
+	{
+		self->reported_capacity = snapshot.capacity;
+		LOG_DEBUG("Vector capacity resized to %lu elements!\n", (unsigned long)snapshot.capacity);
+	}
+	
+	if (snapshot.store_failures != self->reported_failures)
+	{
+		LOG_ERROR("%u interval(s) could not be stored!\n", (unsigned)(uint8_t)(snapshot.store_failures - self->reported_failures));
+		self->reported_failures = snapshot.store_failures;
+	}
+	
+	if (snapshot.updates == self->reported_updates) return;
+	self->reported_updates = snapshot.updates;
+	
+	LOG_TRACE("Interval: %lu interrupts\n", (unsigned long)snapshot.last_interval);
+	LOG_DEBUG("Dynamic timer updated!\n");
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+	DynamicTimer_print(self);				// Skriver ut all information.
+#endif
 	return;
 }
 
 /************************************************************************
 * DynamicTimer_print används för att skriva ut information om en dynamisk
 * timer, bland annat aktuell fördröjningstid, antal lagrade element med 
-* även summan och genomsnittet av dessa.
+* även summan och genomsnittet av dessa. Samtliga värden läses via
+* DynamicTimer_snapshot, där summan räknas upp av avbrottsrutinen, så att
+* vektorn aldrig läses medan avbrottsrutinen ändrar den. Texten lagras i
+* flashminnet och funktionen kompileras enbart in då LOG_LEVEL är minst
+* LOG_LEVEL_DEBUG.
 ************************************************************************/
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
 void DynamicTimer_print(const struct DynamicTimer* self)
 {
-	serial_print("----------------------------------------------------------------------------------------------------------\n");
-	serial_print_unsigned("Capacity: %lu\n", self->capacity);						// skriver ut kapaciteten:
-	serial_print_unsigned("Number of elements: %lu\n", self->interrupt_vector.elements);			// Skriver ut antalet element i vektor:
-	serial_print_unsigned("Index of next element: %lu\n", self->next);					// Skriver ut index för nästa element:
-	serial_print_unsigned("Sum of stored elements: %lu\n", Vector_sum(&self->interrupt_vector));		// Skriver ut summan av alla element:
-	serial_print_unsigned("Average of stored elements: %lu\n", (uint32_t)(Vector_average(&self->interrupt_vector) + 0.5)); // Skriver ut genomsnittet av alla element. Avrundar till närmsta heltal:
-	serial_print_unsigned("Delay time: %lu ms\n", self->timer.required_interrupts * INTERRUPT_TIME);	// Skriver ut fördröjningstiden:
-	serial_print("---------------------------------------------------------------------------------------------------------\n\n");
+	const struct DynamicTimerSnapshot snapshot = DynamicTimer_snapshot(self);	// Konsistent kopia av värden som uppdateras av avbrottsrutiner.
+	serial_print_P(PSTR("----------------------------------------------------------------------------------------------------------\n"));
+	serial_printf_P(PSTR("Estimator: %s\n"), IntervalEstimator_name(snapshot.estimator));
+	serial_printf_P(PSTR("Capacity: %lu\n"), (unsigned long)snapshot.capacity);					// skriver ut kapaciteten:
+	serial_printf_P(PSTR("Number of elements: %lu\n"), (unsigned long)snapshot.elements);				// Skriver ut antalet element i vektor:
+	serial_printf_P(PSTR("Index of next element: %lu\n"), (unsigned long)snapshot.next);				// Skriver ut index för nästa element:
+	serial_printf_P(PSTR("Sum of stored elements: %lu\n"), (unsigned long)snapshot.sum);			// Skriver ut summan av alla element:
+	serial_printf_P(PSTR("Average of stored elements: %lu\n"), (unsigned long)(snapshot.elements ? (snapshot.sum + snapshot.elements / 2) / snapshot.elements : 0)); // Skriver ut genomsnittet av alla element. Avrundar till närmsta heltal:
+	serial_printf_P(PSTR("Delay time: %lu ms\n"), (unsigned long)(snapshot.required_interrupts * self->timer.interrupt_time));	// Skriver ut fördröjningstiden:
+	if (snapshot.pending_interrupts)	// Skriver ut väntande fördröjningstid:
+		serial_printf_P(PSTR("Next delay time: %lu ms\n"), (unsigned long)(snapshot.pending_interrupts * self->timer.interrupt_time));
+	serial_print_P(PSTR("---------------------------------------------------------------------------------------------------------\n\n"));
 	return;
 }
+#endif /* LOG_LEVEL >= LOG_LEVEL_DEBUG */
@@ -4,23 +4,142 @@
 #include "definitions.h"
 #include "Timer.h"
 #include "Vector.h"
-#include "Serial.h"
+#include "Log.h"
+#include "IntervalEstimator.h"
+#include "Atomic.h"
+#include "Trace.h"
 
 #define MAX_CAPACITY 256 			// Max antal element som kan lagras i dynamisk array.
+#define CHECKPOINT_INTERVALS 10			// Max antal lagrade intervall i en kontrollpunkt.
+
+/************************************************************************
+* DynamicTimerUpdate anger hur en ny fördröjningstid tillämpas när den
+* skattas mitt under en pågående period, så att mätningarna varken
+* tätnar (om den nya tiden understiger redan förfluten tid) eller glesnar
+* (om den pågående perioden förlängs):
+*
+* - UPDATE_RESCALE: förfluten tid skalas om proportionellt mot den nya
+*   fördröjningstiden, så att förfluten andel av perioden behålls.
+*   Förfluten andel beräknas i 32-bitars fixpunkt (Q16) utan 64-bitars
+*   division i avbrottsrutinen, med avrundning nedåt till helt antal
+*   avbrott.
+* - UPDATE_AT_EXPIRY: pågående period slutförs med föregående
+*   fördröjningstid, varefter den nya tiden gäller från nästa period.
+*
+* Den första skattade fördröjningstiden gäller alltid direkt, med
+* perioden startad vid knapptryckningen. Läge väljs vid kompilering via
+* makrot DYNAMIC_TIMER_UPDATE.
+************************************************************************/
+typedef enum DynamicTimerUpdate
+{
+	UPDATE_RESCALE,
+	UPDATE_AT_EXPIRY
+} DynamicTimerUpdate;
+
+#ifndef DYNAMIC_TIMER_UPDATE
+#define DYNAMIC_TIMER_UPDATE UPDATE_RESCALE	// Tillämpning av ny fördröjningstid.
+#endif
+
+#define DYNAMIC_TIMER_SCALE_ONE 256		// Skalfaktor 1 i fixpunkt (se DynamicTimer_set_scale).
+#define DYNAMIC_TIMER_MIN_PERIOD 1000UL		// Kortaste skalade fördröjningstid mätt i millisekunder.
+#define DYNAMIC_TIMER_MAX_PERIOD 600000UL	// Längsta skalade fördröjningstid mätt i millisekunder.
+
+/************************************************************************
+* Strukten DynamicTimerSettings lagrar inställningar som huvudloopen
+* ändrar (exempelvis via konsolen) och som tillämpas av avbrottsrutinen
+* vid nästa knapptryckning, via en dubbelbuffert (se Atomic.h).
+************************************************************************/
+struct DynamicTimerSettings
+{
+	IntervalEstimatorType estimator;	// Vald strategi för skattning av fördröjningstiden.
+	uint8_t quantile;			// Skattad kvantil i procent (ESTIMATOR_QUANTILE).
+};
+
+/************************************************************************
+* Strukten DynamicTimerSnapshot utgör en konsistent kopia av den dynamiska
+* timerns värden, vilka uppdateras av avbrottsrutiner, för läsning
+* utanför avbrottsrutiner (se DynamicTimer_snapshot).
+************************************************************************/
+struct DynamicTimerSnapshot
+{
+	uint32_t interrupt_counter;		// Antalet avbrott sedan senaste knapptryckning.
+	uint32_t executed_interrupts;		// Antalet avbrott sedan senaste mätning.
+	uint32_t required_interrupts;		// Aktuell fördröjningstid i antal avbrott.
+	uint32_t pending_interrupts;		// Fördröjningstid från nästa period, 0 om ingen.
+	size_t elements;			// Antalet lagrade intervall.
+	size_t capacity;			// Vektorns kapacitet.
+	size_t next;				// Index för nästa intervall.
+	uint32_t sum;				// Summan av lagrade intervall.
+	IntervalEstimatorType estimator;	// Använd strategi.
+	uint32_t last_interval;			// Senast uppmätta intervall.
+	uint8_t updates;			// Antal uppdateringar (räknas modulo 256).
+	uint8_t store_failures;			// Antal intervall som inte kunde lagras (räknas modulo 256).
+	bool initiated;				// Indikerar att timern har startats av en knapptryckning.
+};
+
+/************************************************************************
+* Strukten DynamicTimerCheckpoint utgör den dynamiska timerns inlärda
+* tillstånd, vilket lagras i EEPROM-minnet (se Checkpoint.h) så att
+* timern kan återupptas med inlärd fördröjningstid efter reset. Utöver
+* aktuell fördröjningstid lagras vald strategi, skattarens tillstånd samt
+* de senaste lagrade intervallen, äldsta intervallet först. Fälten är
+* ordnade så att strukten saknar utfyllnad (60 byte).
+************************************************************************/
+struct DynamicTimerCheckpoint
+{
+	uint32_t required_interrupts;		// Fördröjningstid i antal avbrott.
+	uint32_t estimate;			// Skattarens senaste skattning.
+	uint32_t ewma;				// Glidande medelvärde i fixpunkt, 0 om ej initierat.
+	uint8_t estimator;			// Vald strategi (IntervalEstimatorType).
+	uint8_t quantile;			// Skattad kvantil i procent.
+	uint8_t count;				// Antal lagrade intervall.
+	uint8_t reserved;			// Oanvänd, alltid 0.
+	uint16_t capacity;			// Vektorns kapacitet.
+	uint16_t crc;				// Kontrollsumma, beräknas av Checkpoint.c.
+	uint32_t intervals[CHECKPOINT_INTERVALS];	// Senaste intervallen, äldsta först.
+};
 
 /************************************************************************
 * Strukten DynamicTimer används för att implementera en dynamsisk timer
 * där antalet timergenerade avbrott räknas och implementeras för att 
-* skapa en genomsnittlig tid på timern.
+* skapa en genomsnittlig tid på timern. Fördröjningstiden skattas från
+* intervallen mellan knapptryckningar via en utbytbar strategi (se
+* IntervalEstimator.h), där intervallen enbart lagras i vektorn ifall
+* vald strategi kräver detta.
+*
+* Avbrottsrutinerna uppdaterar den dynamiska timerns värden inom en
+* sekvensräknare, så att huvudloopen kan läsa konsistenta värden via
+* DynamicTimer_snapshot utan att inaktivera avbrott. Summan av lagrade
+* intervall räknas upp av avbrottsrutinen, så att huvudloopen aldrig läser
+* vektorn. Avbrottsrutinerna skriver inte ut något, eftersom blockerande
+* utskrifter fördröjer övriga avbrott. Start, ändrad kapacitet samt
+* intervall som inte kunde lagras skrivs i stället ut från huvudloopen via
+* DynamicTimer_report, genom jämförelse med senast utskrivna värden.
 ************************************************************************/
 struct DynamicTimer
 {
 	struct Timer timer;			// Timerkrets, implementerar timerfunktionalitet.
+	uint32_t pending_interrupts;		// Fördröjningstid som tillämpas vid nästa utlöpning, 0 om ingen.
+	uint16_t scale;				// Skalfaktor för skattad fördröjningstid, DYNAMIC_TIMER_SCALE_ONE motsvarar 1.
+	uint32_t min_interrupts;		// DYNAMIC_TIMER_MIN_PERIOD i antal avbrott för vald timerkrets.
+	uint32_t max_interrupts;		// DYNAMIC_TIMER_MAX_PERIOD i antal avbrott för vald timerkrets.
 	struct Vector interrupt_vector; 	// Vektor, lagrar antalet interrupts mellan varje knapptryckning.
-	uint32_t interrupt_counter;		// Räknar anatalet timergenererade avbrott mellan knapptryckningar.
+	volatile uint32_t interrupt_counter;	// Räknar anatalet timergenererade avbrott mellan knapptryckningar.
 	size_t capacity;			// Vektorns kapacitet.
 	size_t next;				// Index för nästa element som skall läggas till. 
+	uint32_t sum;				// Summan av lagrade element.
 	bool initiated;				// indikerar ifall timer har blivit startad (Sker efter första knapptryckningen).
+	struct IntervalEstimator estimator;	// Skattar fördröjningstiden från intervallen mellan knapptryckningar.
+	struct SeqCount sequence;		// Sekvensräknare för värden som uppdateras av avbrottsrutiner.
+	DOUBLE_BUFFER(struct DynamicTimerSettings) settings;	// Inställningar från huvudloopen.
+	uint8_t applied_settings;		// Generation för senast tillämpade inställningar.
+	uint32_t last_interval;			// Senast uppmätta intervall, för utskrift från huvudloopen.
+	uint8_t updates;			// Räknar uppdateringar från avbrottsrutinen.
+	uint8_t store_failures;			// Räknar intervall som inte kunde lagras i vektorn.
+	uint8_t reported_updates;		// Senast utskrivna uppdatering, används enbart av huvudloopen.
+	uint8_t reported_failures;		// Senast utskrivna antal misslyckade lagringar, används enbart av huvudloopen.
+	size_t reported_capacity;		// Senast utskrivna kapacitet, används enbart av huvudloopen.
+	bool reported_initiated;		// Indikerar att start har skrivits ut, används enbart av huvudloopen.
 };	
 
 // Externa funktioner:
@@ -33,6 +152,13 @@ bool DynamicTimer_elapsed(struct DynamicTimer* self);
 void DynamicTimer_clear(struct DynamicTimer* self);
 void DynamicTimer_update(struct DynamicTimer* self);
 void DynamicTimer_set_capacity(struct DynamicTimer* self, const size_t new_capacity);
-void DynamicTimer_print(const struct DynamicTimer* self);
+void DynamicTimer_set_estimator(struct DynamicTimer* self, const IntervalEstimatorType type, const uint8_t quantile);
+void DynamicTimer_set_scale(struct DynamicTimer* self, const uint16_t scale);
+struct DynamicTimerSettings DynamicTimer_settings(const struct DynamicTimer* self);
+struct DynamicTimerSnapshot DynamicTimer_snapshot(const struct DynamicTimer* self);
+void DynamicTimer_checkpoint(const struct DynamicTimer* self, struct DynamicTimerCheckpoint* checkpoint);
+bool DynamicTimer_restore(struct DynamicTimer* self, const struct DynamicTimerCheckpoint* checkpoint);
+void DynamicTimer_report(struct DynamicTimer* self);
+void DynamicTimer_print(const struct DynamicTimer* self);	// Enbart tillgänglig då LOG_LEVEL är minst LOG_LEVEL_DEBUG.
 
 #endif /* DYNAMICTIMER_H_ */
@@ -0,0 +1,107 @@
+// Inkluderingsdirektiv:
+#include "Eeprom.h"
+#include <util/atomic.h>
+
+static const uint8_t* volatile source = 0x00;	// Data som skrivs, 0 då ingen skrivning pågår.
+static volatile uint16_t destination;		// Adress för nästa byte i EEPROM-minnet.
+static volatile uint8_t remaining;		// Antal återstående byte.
+
+// Statiska funktioner:
+static uint8_t read_byte(const uint16_t address);
+
+/******************************************************************************
+* Funktionen Eeprom_write påbörjar en asynkron skrivning av length byte från
+* bufferten data till given adress i EEPROM-minnet, vilket sker genom att
+* avbrott för EEPROM Ready aktiveras. Bufferten måste behållas oförändrad
+* tills skrivningen är slutförd. Om en skrivning redan pågår, alternativt
+* om data inte ryms i EEPROM-minnet, returneras false, annars true.
+******************************************************************************/
+bool Eeprom_write(const uint16_t address, const void* data, const uint8_t length)
+{
+	if ((uint32_t)address + length > EEPROM_SIZE) return false;
+	if (!length) return true;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if (source) return false;
+		source = (const uint8_t*)data;
+		destination = address;
+		remaining = length;
+		EECR |= (1 << EERIE);
+	}
+
+	return true;
+}
+
+/******************************************************************************
+* Funktionen Eeprom_busy returnerar true om en skrivning pågår.
+******************************************************************************/
+bool Eeprom_busy(void)
+{
+	return source ? true : false;
+}
+
+/******************************************************************************
+* Funktionen Eeprom_read läser length byte från given adress i EEPROM-minnet
+* till bufferten data. Läsningen sker med avbrott inaktiverade per byte, så
+* att adressregistret inte ändras av avbrottsrutinen under läsningen.
+******************************************************************************/
+void Eeprom_read(const uint16_t address, void* data, const uint8_t length)
+{
+	uint8_t* destination = (uint8_t*)data;
+
+	for (register uint8_t i = 0; i < length; i++)
+	{
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			destination[i] = read_byte(address + i);
+		}
+	}
+
+	return;
+}
+
+/******************************************************************************
+* Funktionen Eeprom_interrupt anropas från avbrottsrutinen EE_READY_vect när
+* EEPROM-minnet är redo. Byte som redan har önskat innehåll hoppas över,
+* varefter nästa byte som skiljer sig skrivs. När samtliga byte har
+* skrivits inaktiveras avbrottet.
+******************************************************************************/
+void Eeprom_interrupt(void)
+{
+	while (remaining)
+	{
+		const uint8_t data = *source;
+		const uint16_t address = destination;
+
+		source++;
+		destination++;
+		remaining--;
+
+		if (read_byte(address) != data)
+		{
+			EEDR = data;
+			EECR |= (1 << EEMPE);
+			EECR |= (1 << EEPE);
+			return;
+		}
+	}
+
+	EECR &= ~(1 << EERIE);
+	source = 0x00;
+	return;
+}
+
+/******************************************************************************
+* Funktionen read_byte läser en byte från given adress. Först inväntas att
+* en eventuell pågående skrivning slutförs (biten EEPE nollställs), varefter
+* adressen skrivs och läsning startas via biten EERE (EEPROM Read Enable).
+* Funktionen anropas med avbrott inaktiverade.
+******************************************************************************/
+static uint8_t read_byte(const uint16_t address)
+{
+	while (EECR & (1 << EEPE));
+	EEAR = address;
+	EECR |= (1 << EERE);
+	return EEDR;
+}
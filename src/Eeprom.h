@@ -0,0 +1,40 @@
+
+#ifndef EEPROM_H_
+#define EEPROM_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+
+/******************************************************************************
+* EEPROM-minnet (1 kB) skrivs asynkront via avbrottsrutinen EE_READY_vect,
+* vilken exekveras när EEPROM-minnet är redo för nästa skrivning. Varje
+* skrivning av en byte tar cirka 3.3 ms, varför en blockerande skrivning
+* av exempelvis 32 byte skulle stoppa programmet i över 100 ms. I stället
+* skrivs en byte per avbrott, medan programmet fortsätter exekvera.
+*
+* Innan en byte skrivs läses befintligt innehåll på adressen, där byten
+* hoppas över om innehållet redan är lika, vilket både sparar tid och
+* minskar slitaget på minnescellerna.
+*
+* Enbart en skrivning i taget kan pågå. Data som skrivs läses direkt från
+* anroparens buffert, som därmed måste behållas oförändrad tills
+* skrivningen är slutförd (se Eeprom_busy). Läsning sker blockerande, men
+* tar enbart ett fåtal klockcykler per byte efter att en eventuell
+* pågående skrivning av en enskild byte har slutförts.
+*
+* För att skriva en byte ettställs först biten EEMPE (EEPROM Master Write
+* Enable) och därefter biten EEPE (EEPROM Write Enable) i kontrollregistret
+* EECR inom fyra klockcykler, vilket sker med avbrott inaktiverade i
+* avbrottsrutinen. Avbrottet aktiveras via biten EERIE (EEPROM Ready
+* Interrupt Enable).
+******************************************************************************/
+
+#define EEPROM_SIZE 1024				// EEPROM-minnets storlek mätt i byte.
+
+// Funktionsdeklarationer:
+bool Eeprom_write(const uint16_t address, const void* data, const uint8_t length);
+bool Eeprom_busy(void);
+void Eeprom_read(const uint16_t address, void* data, const uint8_t length);
+void Eeprom_interrupt(void);
+
+#endif /* EEPROM_H_ */
@@ -0,0 +1,211 @@
+// Inkluderingsdirektiv:
+#include "EepromLog.h"
+#include "Serial.h"
+#include <stddef.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+#include <util/crc16.h>
+
+static struct EepromRecord current;		// Post som fylls med mätvärden.
+static struct EepromRecord pending;		// Fylld post som väntar på att skrivas.
+static volatile bool pending_full = false;	// Indikerar att pending ännu inte har skrivits.
+static bool writing = false;			// Indikerar att pending skrivs till EEPROM-minnet.
+static uint8_t slot = 0x00;			// Plats för nästa post som skrivs.
+static uint16_t sequence = 0x00;		// Sekvensnummer för nästa post.
+static volatile uint16_t dropped = 0x00;	// Antal mätvärden som inte kunde lagras.
+
+// Statiska funktioner:
+static bool close_record(void);
+static uint8_t checksum(const struct EepromRecord* record);
+static bool is_valid(const struct EepromRecord* record);
+static inline uint16_t slot_address(const uint8_t slot) { return EEPROM_LOG_ADDRESS + slot * sizeof(struct EepromRecord); }
+
+/******************************************************************************
+* Funktionen init_EepromLog anropas vid start för att hitta den senast
+* skrivna posten, vilket är den giltiga post vars sekvensnummer är högst
+* (jämfört med hänsyn till att sekvensnumret slår runt). Loggningen
+* fortsätter på platsen efter denna post med nästa sekvensnummer. Om
+* ingen giltig post finns påbörjas loggningen på första platsen.
+******************************************************************************/
+void init_EepromLog(void)
+{
+	struct EepromRecord record;
+	bool found = false;
+
+	for (register uint8_t i = 0; i < EEPROM_LOG_SLOTS; i++)
+	{
+		Eeprom_read(slot_address(i), &record, sizeof(record));
+		if (!is_valid(&record)) continue;
+
+		if (!found || (int16_t)(record.sequence - sequence) >= 0)
+		{
+			slot = (i + 1) % EEPROM_LOG_SLOTS;
+			sequence = record.sequence + 1;
+			found = true;
+		}
+	}
+
+	current.count = 0x00;
+	pending_full = false;
+	writing = false;
+	return;
+}
+
+/******************************************************************************
+* Funktionen EepromLog_append lagrar ett mätvärde value, mätt i tiondels
+* grader Celcius, i aktuell post i RAM tillsammans med aktuell tid. När
+* posten är full, alternativt om tiden sedan postens start inte ryms i 16
+* bitar, så stängs posten och skrivs sedan via EepromLog_process. Om
+* föregående post ännu inte har skrivits kan en full post inte stängas,
+* varvid mätvärdet räknas som förlorat. Funktionen kan anropas från
+* avbrottsrutiner.
+******************************************************************************/
+void EepromLog_append(const int16_t value)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		const uint32_t time = Clock_seconds();
+
+		if (current.count && (current.count >= EEPROM_LOG_SAMPLES || time - current.time > UINT16_MAX) && !close_record())
+		{
+			dropped++;
+			return;
+		}
+
+		if (!current.count) current.time = time;
+		current.samples[current.count].offset = (uint16_t)(time - current.time);
+		current.samples[current.count].value = value;
+		current.count++;
+
+		if (current.count >= EEPROM_LOG_SAMPLES) close_record();
+	}
+
+	return;
+}
+
+/******************************************************************************
+* Funktionen EepromLog_flush stänger aktuell post även om den inte är full,
+* så att lagrade mätvärden skrivs till EEPROM-minnet, exempelvis innan
+* matningsspänningen bryts.
+******************************************************************************/
+void EepromLog_flush(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if (current.count) close_record();
+	}
+
+	return;
+}
+
+/******************************************************************************
+* Funktionen EepromLog_process anropas från programmets huvudloop. Om en
+* stängd post väntar påbörjas en asynkron skrivning av posten, förutsatt
+* att ingen annan skrivning pågår. När skrivningen är slutförd flyttas
+* loggen fram till nästa plats.
+******************************************************************************/
+void EepromLog_process(void)
+{
+	if (!pending_full) return;
+
+	if (!writing)
+	{
+		writing = Eeprom_write(slot_address(slot), &pending, sizeof(pending));
+	}
+
+	else if (!Eeprom_busy())
+	{
+		slot = (slot + 1) % EEPROM_LOG_SLOTS;
+		writing = false;
+		pending_full = false;
+	}
+
+	return;
+}
+
+/******************************************************************************
+* Funktionen EepromLog_read läser posten med ett givet index, där index 0
+* utgör platsen som skrivs härnäst, det vill säga den äldsta posten när
+* samtliga platser är använda. Om posten är giltig returneras true.
+******************************************************************************/
+bool EepromLog_read(const uint8_t index, struct EepromRecord* record)
+{
+	Eeprom_read(slot_address((slot + index) % EEPROM_LOG_SLOTS), record, sizeof(*record));
+	return is_valid(record);
+}
+
+/******************************************************************************
+* Funktionen EepromLog_print skriver ut samtliga giltiga poster, äldsta
+* posten först, där varje mätvärde skrivs ut på en egen rad med postens
+* sekvensnummer, tidpunkt i sekunder sedan start samt temperaturen i
+* tiondels grader Celcius.
+******************************************************************************/
+void EepromLog_print(void)
+{
+	struct EepromRecord record;
+	uint8_t records = 0x00;
+
+	serial_printf_P(PSTR("EEPROM log: %u samples in RAM, %u dropped\n"), current.count, dropped);
+	serial_print("Sequence, time (s), temperature (0.1 C):\n");
+
+	for (register uint8_t i = 0; i < EEPROM_LOG_SLOTS; i++)
+	{
+		if (!EepromLog_read(i, &record)) continue;
+		records++;
+
+		for (register uint8_t j = 0; j < record.count; j++)
+		{
+			serial_printf_P(PSTR("%u %lu %d\n"), record.sequence,
+				(unsigned long)(record.time + record.samples[j].offset), record.samples[j].value);
+		}
+	}
+
+	serial_printf_P(PSTR("%u records\n"), records);
+	return;
+}
+
+/******************************************************************************
+* Funktionen close_record flyttar aktuell post till pending, där posten
+* tilldelas nästa sekvensnummer samt kontrollsumma. Om föregående post
+* ännu inte har skrivits returneras false. Funktionen anropas med avbrott
+* inaktiverade.
+******************************************************************************/
+static bool close_record(void)
+{
+	if (pending_full) return false;
+
+	pending = current;
+	pending.sequence = sequence++;
+	pending.checksum = checksum(&pending);
+	pending_full = true;
+	current.count = 0x00;
+	return true;
+}
+
+/******************************************************************************
+* Funktionen checksum beräknar en CRC-8 för samtliga byte i en post utom
+* kontrollsumman.
+******************************************************************************/
+static uint8_t checksum(const struct EepromRecord* record)
+{
+	const uint8_t* data = (const uint8_t*)record;
+	uint8_t crc = 0x00;
+
+	for (register uint8_t i = 0; i < sizeof(*record); i++)
+	{
+		if (i != offsetof(struct EepromRecord, checksum)) crc = _crc8_ccitt_update(crc, data[i]);
+	}
+
+	return crc;
+}
+
+/******************************************************************************
+* Funktionen is_valid kontrollerar att en post har giltigt antal mätvärden
+* samt korrekt kontrollsumma. Ett raderat EEPROM-minne (0xFF) ger ett
+* ogiltigt antal mätvärden.
+******************************************************************************/
+static bool is_valid(const struct EepromRecord* record)
+{
+	if (!record->count || record->count > EEPROM_LOG_SAMPLES) return false;
+	return checksum(record) == record->checksum;
+}
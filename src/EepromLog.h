@@ -0,0 +1,71 @@
+
+#ifndef EEPROMLOG_H_
+#define EEPROMLOG_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+#include "Eeprom.h"
+#include "Clock.h"
+
+/******************************************************************************
+* EEPROM-loggen lagrar uppmätta temperaturer i EEPROM-minnet, så att de
+* finns kvar efter att matningsspänningen har brutits. Mätvärden samlas
+* först i RAM i en post om EEPROM_LOG_SAMPLES mätvärden, vilken skrivs
+* asynkront (se Eeprom.h) när den är full, så att programmet aldrig
+* väntar på EEPROM-minnet.
+*
+* Poster skrivs i tur och ordning i EEPROM_LOG_SLOTS platser, där den
+* äldsta posten skrivs över när samtliga platser är använda. Därmed slits
+* samtliga platser lika mycket (wear leveling): vid ett mätvärde per minut
+* skrivs varje plats cirka var tredje timme, vilket motsvarar över 30 år
+* innan minnescellernas 100 000 skrivcykler har förbrukats.
+*
+* Varje post har ett sekvensnummer samt en kontrollsumma (CRC-8). Vid
+* start läses samtliga platser, där posten med högst sekvensnummer utgör
+* den senast skrivna posten, så att loggningen fortsätter på nästa plats.
+* Poster med felaktig kontrollsumma, exempelvis en post vars skrivning
+* avbröts av ett strömavbrott, hoppas över.
+*
+* Tidpunkter lagras i sekunder sedan start (se Clock_seconds), varför
+* tidpunkter från olika uppstarter inte är jämförbara, medan ordningen
+* framgår av sekvensnumren. EEPROM-minnets sista EEPROM_SIZE -
+* EEPROM_LOG_SIZE byte används av den dynamiska timerns kontrollpunkt
+* (se Checkpoint.h).
+******************************************************************************/
+
+#define EEPROM_LOG_ADDRESS 0				// Startadress för loggen i EEPROM-minnet.
+#define EEPROM_LOG_SLOTS 30				// Antal platser för poster.
+#define EEPROM_LOG_SAMPLES 6				// Antal mätvärden per post.
+#define EEPROM_LOG_SIZE (EEPROM_LOG_SLOTS * sizeof(struct EepromRecord))  // Loggens storlek mätt i byte.
+
+/******************************************************************************
+* Strukten EepromSample utgör ett mätvärde i en post, där tidpunkten anges
+* relativt postens starttid.
+******************************************************************************/
+struct EepromSample
+{
+	uint16_t offset;				// Tid sedan postens starttid mätt i sekunder.
+	int16_t value;					// Temperatur mätt i tiondels grader Celcius.
+};
+
+/******************************************************************************
+* Strukten EepromRecord utgör en post i loggen (32 byte).
+******************************************************************************/
+struct EepromRecord
+{
+	uint32_t time;					// Starttid mätt i sekunder sedan start.
+	uint16_t sequence;				// Sekvensnummer, räknas upp för varje post.
+	uint8_t count;					// Antal lagrade mätvärden.
+	uint8_t checksum;				// CRC-8 för övriga byte i posten.
+	struct EepromSample samples[EEPROM_LOG_SAMPLES];
+};
+
+// Funktionsdeklarationer:
+void init_EepromLog(void);
+void EepromLog_append(const int16_t value);
+void EepromLog_flush(void);
+void EepromLog_process(void);
+bool EepromLog_read(const uint8_t index, struct EepromRecord* record);
+void EepromLog_print(void);
+
+#endif /* EEPROMLOG_H_ */
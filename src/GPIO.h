@@ -3,6 +3,7 @@
 
 // Inkluderingsdirektiv: 
 #include "definitions.h"
+#include "PinChange.h"
 
 /******************************************************************************
 * Strukten Led används för implementering av lysdioder, som kan placeras på
@@ -18,14 +19,17 @@ struct Led
 
 /******************************************************************************
 * Strukten Button används för implementering av tryckknappar, som kan placeras 
-* på någon av digitala PINs 0 - 13 på Arduino Uno. Det finns möjlighet att
-* enkelt läsa av ifall tryckknappen är nedtryckt. Det finns också möjlighet 
-* att aktivera samt inaktivera PCI-avbrott på tryckknappens PIN.
+* på någon av digitala PINs 0 - 13 eller analoga PINs A0 - A5 (14 - 19) på
+* Arduino Uno. Det finns möjlighet att enkelt läsa av ifall tryckknappen är
+* nedtryckt. Det finns också möjlighet att aktivera samt inaktivera
+* PCI-avbrott på tryckknappens PIN, där callbackfunktioner för nedtryckning
+* respektive släpp registreras via Button_attach.
 * 
-* Avbrottsvektorer gällande PCI-avbrott för respektive I/O-port är följande:
+* Avbrottsvektorer gällande PCI-avbrott för respektive I/O-port är följande,
+* vilka samtliga anropar PinChange_interrupt (se PinChange.h):
 *
 * I/O-port B (PIN 8 - 13): PCINT0_vect
-* I/O-port C (PIN A0 - A5): PCINT1_vect - används dock inte för tryckknappar.
+* I/O-port C (PIN A0 - A5): PCINT1_vect
 * I/O-port D (PIN 0 - 7): PCINT2_vect
 ******************************************************************************/
 struct Button 
@@ -44,6 +48,7 @@ void Led_blink(struct Led* self, const uint16_t delay_time);
 
 struct Button new_Button(const uint8_t PIN); 
 bool Button_is_pressed(struct Button* self); 
+void Button_attach(struct Button* self, void (*pressed)(void), void (*released)(void));
 void Button_enable_interrupt(struct Button* self); 
 void Button_disable_interrupt(struct Button* self); 
 
@@ -0,0 +1,315 @@
+// Inkluderingsdirektiv:
+#include "History.h"
+#include <string.h>
+#include <util/atomic.h>
+
+#define HISTORY_NO_RUN HISTORY_DATA_SIZE			// Indikerar att aktuellt block saknar token för upprepningar.
+
+static struct HistoryBlock blocks[HISTORY_BLOCKS];	// Ringbufferten.
+static uint8_t head;					// Index för aktuellt block.
+static uint8_t used_blocks;				// Antal block som används.
+static uint16_t next_sequence;				// Sekvensnummer för nästa block.
+static uint8_t run = HISTORY_NO_RUN;			// Position för senaste token för upprepningar i aktuellt block.
+static uint32_t last_interval;				// Senaste intervall mätt i sekunder.
+static struct HistorySample last;			// Senast lagrade mätvärde.
+
+// Statiska funktioner:
+static void store(const uint32_t time, const int16_t value);
+static void start_block(const uint32_t time, const int16_t value);
+static uint8_t encode(uint8_t* destination, uint32_t number);
+static uint32_t decode(const struct HistoryBlock* block, uint8_t* position);
+static void load(struct HistoryReader* self);
+static inline uint32_t zigzag(const int32_t number) { return ((uint32_t)number << 1) ^ (uint32_t)(number >> 31); }
+static inline int32_t unzigzag(const uint32_t number) { return (int32_t)(number >> 1) ^ -(int32_t)(number & 1); }
+
+/******************************************************************************
+* Funktionen History_append lagrar ett nytt mätvärde value, mätt i tiondels
+* grader Celcius, tillsammans med aktuell tid. Om temperaturen och
+* intervallet är oförändrade räknas föregående token för upprepningar upp,
+* annars kodas differenserna och läggs till i aktuellt block. Om blocket
+* är fullt påbörjas ett nytt block, vilket skriver över det äldsta blocket
+* när ringbufferten är full. Mätvärdet lagras med avbrott inaktiverade, så
+* att funktionen kan anropas från både avbrottsrutiner och huvudloopen.
+******************************************************************************/
+void History_append(const int16_t value)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		store(Clock_seconds(), value);
+	}
+
+	return;
+}
+
+/******************************************************************************
+* Funktionen History_clear tömmer historiken. Tiden sedan start påverkas
+* inte.
+******************************************************************************/
+void History_clear(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		used_blocks = 0x00;
+		run = HISTORY_NO_RUN;
+	}
+
+	return;
+}
+
+/******************************************************************************
+* Funktionen History_samples returnerar antalet lagrade mätvärden.
+******************************************************************************/
+uint32_t History_samples(void)
+{
+	uint32_t samples = 0x00;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		for (register uint8_t i = 0; i < used_blocks; i++)
+		{
+			samples += blocks[(head + HISTORY_BLOCKS - i) % HISTORY_BLOCKS].count;
+		}
+	}
+
+	return samples;
+}
+
+/******************************************************************************
+* Funktionen History_bytes returnerar antalet byte som används av lagrade
+* mätvärden, inklusive blockens huvuden.
+******************************************************************************/
+uint16_t History_bytes(void)
+{
+	uint16_t bytes = 0x00;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		for (register uint8_t i = 0; i < used_blocks; i++)
+		{
+			bytes += HISTORY_BLOCK_SIZE - HISTORY_DATA_SIZE + blocks[(head + HISTORY_BLOCKS - i) % HISTORY_BLOCKS].used;
+		}
+	}
+
+	return bytes;
+}
+
+/******************************************************************************
+* Funktionen new_HistoryReader används för att skapa en läsare, som läser
+* lagrade mätvärden med början från äldsta blocket.
+******************************************************************************/
+struct HistoryReader new_HistoryReader(void)
+{
+	struct HistoryReader self;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		self.index = (head + HISTORY_BLOCKS + 1 - used_blocks) % HISTORY_BLOCKS;
+		self.sequence = next_sequence - used_blocks;
+	}
+
+	self.position = 0x00;
+	self.loaded = false;
+	self.run = 0x00;
+	self.interval = 0x00;
+	self.sample.time = 0x00;
+	self.sample.value = 0x00;
+	return self;
+}
+
+/******************************************************************************
+* Funktionen HistoryReader_next avkodar nästa mätvärde och lagrar det via
+* pekaren sample. Vid början av varje block kopieras blocket, varefter
+* blockets första mätvärde returneras från huvudet. Därefter avkodas en
+* token i taget, där återstående upprepningar räknas ned utan avkodning.
+* Om samtliga mätvärden har lästs returneras false, annars true.
+******************************************************************************/
+bool HistoryReader_next(struct HistoryReader* self, struct HistorySample* sample)
+{
+	if (self->run)
+	{
+		self->run--;
+	}
+
+	else if (!self->loaded || self->position >= self->block.used)
+	{
+		load(self);
+		if (!self->loaded) return false;
+
+		self->interval = 0x00;
+		self->sample.time = self->block.time;
+		self->sample.value = self->block.value;
+		*sample = self->sample;
+		return true;
+	}
+
+	else
+	{
+		const uint32_t token = decode(&self->block, &self->position);
+
+		if ((token & 0x03) == HISTORY_RUN)
+		{
+			self->run = (uint8_t)(token >> 2) - 1;
+		}
+
+		else
+		{
+			self->sample.value += (int16_t)unzigzag(token >> 2);
+
+			if ((token & 0x03) == HISTORY_IRREGULAR)
+			{
+				self->interval += (uint32_t)unzigzag(decode(&self->block, &self->position));
+			}
+		}
+	}
+
+	self->sample.time += self->interval;
+	*sample = self->sample;
+	return true;
+}
+
+/******************************************************************************
+* Funktionen store lagrar ett mätvärde med given tidpunkt, se History_append.
+******************************************************************************/
+static void store(const uint32_t time, const int16_t value)
+{
+	if (!used_blocks)
+	{
+		start_block(time, value);
+		return;
+	}
+
+	struct HistoryBlock* block = &blocks[head];
+	const int32_t delta = (int32_t)value - last.value;
+	const uint32_t interval = time - last.time;
+	const int32_t change = (int32_t)(interval - last_interval);
+
+	last.time = time;
+	last.value = value;
+
+	if (!delta && !change && run != HISTORY_NO_RUN && (block->data[run] >> 2) < HISTORY_RUN_MAX)
+	{
+		block->data[run] += 1 << 2;
+		block->count++;
+		return;
+	}
+
+	uint8_t token[10];
+	uint8_t length;
+
+	if (!delta && !change)
+	{
+		token[0] = (1 << 2) | HISTORY_RUN;
+		length = 1;
+	}
+
+	else
+	{
+		length = encode(token, (zigzag(delta) << 2) | (change ? HISTORY_IRREGULAR : HISTORY_REGULAR));
+		if (change) length += encode(token + length, zigzag(change));
+	}
+
+	if (block->used + length > HISTORY_DATA_SIZE)
+	{
+		start_block(time, value);
+		return;
+	}
+
+	run = !delta && !change ? block->used : HISTORY_NO_RUN;
+	memcpy(block->data + block->used, token, length);
+	block->used += length;
+	block->count++;
+	last_interval = interval;
+	return;
+}
+
+/******************************************************************************
+* Funktionen start_block påbörjar ett nytt block med ett givet mätvärde i
+* huvudet, där det äldsta blocket skrivs över när ringbufferten är full.
+* Föregående intervall nollställs, så att blocket kan avkodas fristående.
+******************************************************************************/
+static void start_block(const uint32_t time, const int16_t value)
+{
+	head = used_blocks ? (head + 1) % HISTORY_BLOCKS : 0x00;
+	if (used_blocks < HISTORY_BLOCKS) used_blocks++;
+
+	struct HistoryBlock* block = &blocks[head];
+	block->sequence = next_sequence++;
+	block->time = time;
+	block->value = value;
+	block->count = 1;
+	block->used = 0x00;
+
+	run = HISTORY_NO_RUN;
+	last_interval = 0x00;
+	last.time = time;
+	last.value = value;
+	return;
+}
+
+/******************************************************************************
+* Funktionen encode lagrar ett tal med variabel längd, sju bitar per byte
+* med minst signifikanta bitarna först, där högsta biten indikerar att
+* ytterligare en byte följer. Antalet lagrade byte returneras.
+******************************************************************************/
+static uint8_t encode(uint8_t* destination, uint32_t number)
+{
+	uint8_t length = 0x00;
+
+	while (number >= 0x80)
+	{
+		destination[length++] = (uint8_t)(number | 0x80);
+		number >>= 7;
+	}
+
+	destination[length++] = (uint8_t)number;
+	return length;
+}
+
+/******************************************************************************
+* Funktionen decode läser ett tal med variabel längd från given position i
+* ett block, varefter positionen flyttas fram. Läsningen avbryts vid
+* blockets slut.
+******************************************************************************/
+static uint32_t decode(const struct HistoryBlock* block, uint8_t* position)
+{
+	uint32_t number = 0x00;
+
+	for (register uint8_t shift = 0; *position < block->used && shift < 32; shift += 7)
+	{
+		const uint8_t data = block->data[(*position)++];
+		number |= (uint32_t)(data & 0x7F) << shift;
+		if (!(data & 0x80)) break;
+	}
+
+	return number;
+}
+
+/******************************************************************************
+* Funktionen load kopierar nästa block till läsaren med avbrott inaktiverade.
+* Om blocket har skrivits över fortsätter läsningen från äldsta kvarvarande
+* block. Om samtliga block har lästs nollställs loaded.
+******************************************************************************/
+static void load(struct HistoryReader* self)
+{
+	self->loaded = false;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if ((uint16_t)(next_sequence - self->sequence) > used_blocks)
+		{
+			self->index = (head + HISTORY_BLOCKS + 1 - used_blocks) % HISTORY_BLOCKS;
+			self->sequence = next_sequence - used_blocks;
+		}
+
+		if (self->sequence != next_sequence)
+		{
+			self->block = blocks[self->index];
+			self->index = (self->index + 1) % HISTORY_BLOCKS;
+			self->sequence++;
+			self->position = 0x00;
+			self->loaded = true;
+		}
+	}
+
+	return;
+}
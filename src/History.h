@@ -0,0 +1,104 @@
+
+#ifndef HISTORY_H_
+#define HISTORY_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+#include "Clock.h"
+
+/******************************************************************************
+* Historiken lagrar uppmätta temperaturer i komprimerat format i RAM, så att
+* mätvärden inte går förlorade när ingen PC är ansluten. Mätvärdena lagras
+* i en ringbuffert av block, där det äldsta blocket skrivs över när
+* bufferten är full. Varje block inleds av ett huvud med blockets
+* sekvensnummer samt första mätvärdet och dess tidpunkt i okomprimerat
+* format, följt av övriga mätvärden kodade som differenser:
+*
+* - Temperaturen lagras som differensen mot föregående mätvärde (mätt i
+*   tiondels grader Celcius).
+* - Tidpunkten lagras som differensen mellan aktuellt och föregående
+*   intervall (mätt i sekunder), vilket är noll vid regelbundna mätningar.
+*
+* Differenserna zig-zag-kodas, så att små negativa tal blir små positiva
+* tal (0, -1, 1, -2, ... blir 0, 1, 2, 3, ...), varefter de lagras med
+* variabel längd (sju bitar per byte, där högsta biten indikerar att
+* ytterligare en byte följer). Varje mätvärde inleds av en token, vars två
+* minst signifikanta bitar anger typen:
+*
+* - HISTORY_REGULAR: temperaturdifferensen följer i övriga bitar, intervallet
+*   är oförändrat. Oftast en byte per mätvärde.
+* - HISTORY_IRREGULAR: som ovan, men följt av intervallets differens.
+* - HISTORY_RUN: övriga bitar anger antalet upprepade mätvärden med samma
+*   temperatur och intervall (högst HISTORY_RUN_MAX). Upprepningar räknas
+*   upp i befintlig byte, så att en stabil temperatur kräver en byte per
+*   HISTORY_RUN_MAX mätvärden.
+*
+* Varje nytt mätvärde lagras i konstant tid, vilket kan ske från
+* avbrottsrutiner. Tidpunkter räknas i sekunder sedan start via
+* Clock_seconds (se Clock.h). Lagrade mätvärden läses ut ett i taget via
+* strukten HistoryReader utan att hela historiken avkodas på en gång,
+* exempelvis via konsolkommandot hist.
+******************************************************************************/
+
+#ifndef HISTORY_BLOCKS
+#define HISTORY_BLOCKS 12				// Antal block i ringbufferten.
+#endif
+
+#define HISTORY_BLOCK_SIZE 32				// Storlek per block mätt i byte (inklusive huvud).
+#define HISTORY_DATA_SIZE (HISTORY_BLOCK_SIZE - 11)	// Byte för kodade mätvärden per block.
+#define HISTORY_RUN_MAX 31				// Maximalt antal upprepningar per token.
+
+#define HISTORY_REGULAR 0x00				// Token för mätvärde med oförändrat intervall.
+#define HISTORY_IRREGULAR 0x01				// Token för mätvärde med ändrat intervall.
+#define HISTORY_RUN 0x02				// Token för upprepade mätvärden.
+
+/******************************************************************************
+* Strukten HistoryBlock utgör ett block i ringbufferten.
+******************************************************************************/
+struct HistoryBlock
+{
+	uint16_t sequence;				// Blockets sekvensnummer, räknas upp för varje nytt block.
+	uint32_t time;					// Första mätvärdets tidpunkt, mätt i sekunder sedan start.
+	int16_t value;					// Första mätvärdet, mätt i tiondels grader Celcius.
+	uint16_t count;					// Antal mätvärden i blocket.
+	uint8_t used;					// Antal använda byte i data.
+	uint8_t data[HISTORY_DATA_SIZE];		// Kodade mätvärden.
+};
+
+/******************************************************************************
+* Strukten HistorySample utgör ett avkodat mätvärde.
+******************************************************************************/
+struct HistorySample
+{
+	uint32_t time;					// Tidpunkt mätt i sekunder sedan start.
+	int16_t value;					// Temperatur mätt i tiondels grader Celcius.
+};
+
+/******************************************************************************
+* Strukten HistoryReader används för att läsa ut lagrade mätvärden, äldsta
+* mätvärdet först. Varje block kopieras med avbrott inaktiverade när
+* läsningen når blocket, så att nya mätvärden kan lagras under tiden. Om
+* ett block skrivs över innan det har lästs fortsätter läsningen från
+* äldsta kvarvarande block.
+******************************************************************************/
+struct HistoryReader
+{
+	struct HistoryBlock block;			// Kopia av aktuellt block.
+	uint8_t index;					// Index för nästa block i ringbufferten.
+	uint16_t sequence;				// Förväntat sekvensnummer för nästa block.
+	uint8_t position;				// Läsposition i aktuellt block.
+	bool loaded;					// Indikerar att ett block har kopierats.
+	uint8_t run;					// Återstående upprepningar av föregående mätvärde.
+	uint32_t interval;				// Föregående intervall mätt i sekunder.
+	struct HistorySample sample;			// Föregående mätvärde.
+};
+
+// Funktionsdeklarationer:
+void History_append(const int16_t value);
+void History_clear(void);
+uint32_t History_samples(void);
+uint16_t History_bytes(void);
+struct HistoryReader new_HistoryReader(void);
+bool HistoryReader_next(struct HistoryReader* self, struct HistorySample* sample);
+
+#endif /* HISTORY_H_ */
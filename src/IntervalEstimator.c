@@ -0,0 +1,432 @@
+// Inkluderingsdirektiv:
+#include "IntervalEstimator.h"
+
+#define ESTIMATOR_EWMA_LIMIT (UINT32_MAX >> (ESTIMATOR_EWMA_FRACTION + 1))	// Största intervall för EWMA.
+#define ESTIMATOR_P2_LIMIT (INT32_MAX >> (ESTIMATOR_P2_FRACTION + 1))		// Största intervall för P².
+#define ESTIMATOR_P2_ONE (1UL << 16)						// Ett steg för önskade positioner (fixpunkt).
+
+// Statiska funktioner:
+static uint32_t mean(const struct Vector* history, const uint32_t previous);
+static uint32_t trimmed_mean(struct IntervalEstimator* self, const struct Vector* history);
+static void insert_sorted(struct Vector* sorted, const uint32_t interval);
+static uint32_t ewma(struct IntervalEstimator* self, const uint32_t interval);
+static void new_P2Quantile(struct P2Quantile* self, const uint8_t percent);
+static uint32_t P2Quantile_increment(const uint8_t percent, const uint8_t i);
+static uint32_t P2Quantile_update(struct P2Quantile* self, const uint8_t percent, const uint32_t interval);
+static int32_t P2Quantile_parabolic(const struct P2Quantile* self, const uint8_t i, const int8_t direction);
+static int32_t P2Quantile_linear(const struct P2Quantile* self, const uint8_t i, const int8_t direction);
+static int32_t divide_rounded(const int64_t numerator, const int64_t denominator);
+
+/******************************************************************************
+* Funktionen new_IntervalEstimator returnerar en ny skattare med angiven
+* strategi, där ingen skattning ännu har gjorts.
+******************************************************************************/
+struct IntervalEstimator new_IntervalEstimator(const IntervalEstimatorType type)
+{
+	struct IntervalEstimator self;
+	self.type = type;
+	self.quantile = type == ESTIMATOR_MEDIAN ? 50 : ESTIMATOR_DEFAULT_QUANTILE;
+	self.ewma = 0x00;
+	self.ewma_initiated = false;
+	new_P2Quantile(&self.p2, self.quantile);
+	self.sorted = new_Vector();
+	self.estimate = 0x00;
+	return self;
+}
+
+/******************************************************************************
+* Funktionen IntervalEstimator_set_type byter strategi under körning. Den
+* nya strategins tillstånd nollställs, med undantag för senaste skattning,
+* som behålls tills den nya strategin har gjort en egen skattning. Den
+* sorterade kopian behålls (töms ifall den nya strategin inte behöver den)
+* och synkroniseras sedan via IntervalEstimator_sync.
+******************************************************************************/
+void IntervalEstimator_set_type(struct IntervalEstimator* self, const IntervalEstimatorType type)
+{
+	const uint8_t quantile = self->quantile;
+	const uint32_t estimate = self->estimate;
+	const struct Vector sorted = self->sorted;
+	*self = new_IntervalEstimator(type);
+	self->sorted = sorted;
+	if (type != ESTIMATOR_TRIMMED_MEAN) Vector_clear(&self->sorted);
+	if (type == ESTIMATOR_QUANTILE) IntervalEstimator_set_quantile(self, quantile);
+	self->estimate = estimate;
+	return;
+}
+
+/******************************************************************************
+* Funktionen IntervalEstimator_set_quantile väljer skattad kvantil i procent
+* (1 - 99) och nollställer kvantilskattningen.
+******************************************************************************/
+void IntervalEstimator_set_quantile(struct IntervalEstimator* self, const uint8_t percent)
+{
+	if (!percent || percent > 99) return;
+	self->quantile = percent;
+	new_P2Quantile(&self->p2, percent);
+	return;
+}
+
+/******************************************************************************
+* Funktionen IntervalEstimator_uses_history indikerar ifall vald strategi
+* beräknar skattningen från den dynamiska timerns lagrade intervall.
+******************************************************************************/
+bool IntervalEstimator_uses_history(const struct IntervalEstimator* self)
+{
+	return self->type == ESTIMATOR_MEAN || self->type == ESTIMATOR_TRIMMED_MEAN;
+}
+
+/******************************************************************************
+* Funktionen IntervalEstimator_update uppdaterar skattningen med ett nytt
+* intervall och returnerar den nya skattningen. För strategier som använder
+* lagrade intervall förutsätts att det nya intervallet redan har lagrats i
+* vektorn history, övriga strategier ignorerar vektorn.
+******************************************************************************/
+uint32_t IntervalEstimator_update(struct IntervalEstimator* self, const uint32_t interval, const struct Vector* history)
+{
+	if (self->type == ESTIMATOR_MEAN)
+	{
+		self->estimate = mean(history, self->estimate);
+	}
+
+	else if (self->type == ESTIMATOR_TRIMMED_MEAN)
+	{
+		insert_sorted(&self->sorted, interval);
+		self->estimate = trimmed_mean(self, history);
+	}
+
+	else if (self->type == ESTIMATOR_EWMA)
+	{
+		self->estimate = ewma(self, interval);
+	}
+
+	else
+	{
+		self->estimate = P2Quantile_update(&self->p2, self->quantile, interval);
+	}
+
+	return self->estimate;
+}
+
+/******************************************************************************
+* Funktionen IntervalEstimator_remove tar bort ett lagrat intervall ur den
+* sorterade kopian, vilket ska ske innan intervallet skrivs över i den
+* dynamiska timerns vektor. Övriga strategier ignorerar anropet.
+******************************************************************************/
+void IntervalEstimator_remove(struct IntervalEstimator* self, const uint32_t interval)
+{
+	if (self->type != ESTIMATOR_TRIMMED_MEAN) return;
+	struct Vector* sorted = &self->sorted;
+
+	for (size_t i = 0; i < sorted->elements && sorted->data[i] <= interval; i++)
+	{
+		if (sorted->data[i] != interval) continue;
+
+		for (size_t j = i + 1; j < sorted->elements; j++)
+			sorted->data[j - 1] = sorted->data[j];
+
+		sorted->elements--;
+		return;
+	}
+
+	return;
+}
+
+/******************************************************************************
+* Funktionen IntervalEstimator_sync bygger om den sorterade kopian från
+* lagrade intervall i vektorn history via insättningssortering. Anropas när
+* vektorn har ändrats på annat sätt än via IntervalEstimator_update samt
+* IntervalEstimator_remove. Övriga strategier tömmer kopian.
+******************************************************************************/
+void IntervalEstimator_sync(struct IntervalEstimator* self, const struct Vector* history)
+{
+	if (self->type != ESTIMATOR_TRIMMED_MEAN)
+	{
+		Vector_clear(&self->sorted);
+		return;
+	}
+
+	self->sorted.elements = 0;
+
+	for (size_t i = 0; i < history->elements; i++)
+		insert_sorted(&self->sorted, history->data[i]);
+
+	return;
+}
+
+/******************************************************************************
+* Funktionen IntervalEstimator_resume återupptar skattningen från ett
+* tidigare sparat tillstånd (se DynamicTimer_restore). Senaste skattningen
+* estimate gäller tills strategin har gjort en egen skattning: för median
+* och kvantil används den som skattning från föregående fönster, medan
+* glidande medelvärde fortsätter från ewma (om skilt från 0).
+******************************************************************************/
+void IntervalEstimator_resume(struct IntervalEstimator* self, const uint32_t estimate, const uint32_t ewma)
+{
+	self->estimate = estimate;
+	self->p2.previous = estimate;
+	self->ewma = ewma;
+	self->ewma_initiated = ewma ? true : false;
+	return;
+}
+
+/******************************************************************************
+* Funktionen IntervalEstimator_name returnerar namnet på en given strategi.
+******************************************************************************/
+const char* IntervalEstimator_name(const IntervalEstimatorType type)
+{
+	if (type == ESTIMATOR_MEAN) return "mean";
+	if (type == ESTIMATOR_TRIMMED_MEAN) return "trim";
+	if (type == ESTIMATOR_EWMA) return "ewma";
+	if (type == ESTIMATOR_MEDIAN) return "median";
+	return "quantile";
+}
+
+/******************************************************************************
+* Funktionen mean returnerar medelvärdet av lagrade intervall, avrundat till
+* närmsta heltal. Om inga intervall finns lagrade returneras föregående
+* skattning.
+******************************************************************************/
+static uint32_t mean(const struct Vector* history, const uint32_t previous)
+{
+	if (!history->elements) return previous;
+	return (uint32_t)(Vector_average(history) + 0.5);
+}
+
+/******************************************************************************
+* Funktionen trimmed_mean returnerar medelvärdet av lagrade intervall, där
+* de trim minsta respektive största intervallen exkluderas. Dessa ligger
+* först respektive sist i den sorterade kopian, varför enbart intervallen
+* däremellan summeras. Om kopian inte motsvarar lagrade intervall, exempelvis
+* då ett intervall inte kunde lagras, byggs den om från vektorn history.
+******************************************************************************/
+static uint32_t trimmed_mean(struct IntervalEstimator* self, const struct Vector* history)
+{
+	const size_t elements = history->elements;
+	if (elements < 3) return mean(history, self->estimate);
+	if (self->sorted.elements != elements) IntervalEstimator_sync(self, history);
+	if (self->sorted.elements != elements) return mean(history, self->estimate);
+
+	size_t trim = elements / ESTIMATOR_TRIM_DIVISOR;
+	if (!trim) trim = 1;
+
+	uint32_t sum = 0x00;
+
+	for (size_t i = trim; i < elements - trim; i++)
+		sum += self->sorted.data[i];
+
+	const size_t kept = elements - 2 * trim;
+	return (sum + kept / 2) / kept;
+}
+
+/******************************************************************************
+* Funktionen insert_sorted sätter in ett intervall i den sorterade kopian,
+* där större intervall flyttas ett steg bakåt.
+******************************************************************************/
+static void insert_sorted(struct Vector* sorted, const uint32_t interval)
+{
+	if (!Vector_push(sorted, interval)) return;
+	size_t i = sorted->elements - 1;
+
+	while (i > 0 && sorted->data[i - 1] > interval)
+	{
+		sorted->data[i] = sorted->data[i - 1];
+		i--;
+	}
+
+	sorted->data[i] = interval;
+	return;
+}
+
+/******************************************************************************
+* Funktionen ewma uppdaterar det exponentiellt viktade glidande medelvärdet,
+* lagrat i fixpunkt med ESTIMATOR_EWMA_FRACTION decimalbitar, enligt
+* ewma += (interval - ewma) / 2^ESTIMATOR_EWMA_SHIFT, där divisionen sker
+* via aritmetisk skift. Första intervallet används som startvärde.
+******************************************************************************/
+static uint32_t ewma(struct IntervalEstimator* self, const uint32_t interval)
+{
+	const uint32_t limited = interval > ESTIMATOR_EWMA_LIMIT ? ESTIMATOR_EWMA_LIMIT : interval;
+	const int32_t sample = (int32_t)(limited << ESTIMATOR_EWMA_FRACTION);
+
+	if (!self->ewma_initiated)
+	{
+		self->ewma = (uint32_t)sample;
+		self->ewma_initiated = true;
+	}
+
+	else
+	{
+		self->ewma = (uint32_t)((int32_t)self->ewma + ((sample - (int32_t)self->ewma) >> ESTIMATOR_EWMA_SHIFT));
+	}
+
+	return (self->ewma + (1UL << (ESTIMATOR_EWMA_FRACTION - 1))) >> ESTIMATOR_EWMA_FRACTION;
+}
+
+/******************************************************************************
+* Funktionen new_P2Quantile initierar markörerna för skattning av given
+* kvantil i procent, där önskade positioner 1, 1 + 2p, 1 + 4p, 3 + 2p samt 5
+* lagras i fixpunkt.
+******************************************************************************/
+static void new_P2Quantile(struct P2Quantile* self, const uint8_t percent)
+{
+	for (uint8_t i = 0; i < 5; i++)
+	{
+		self->heights[i] = 0x00;
+		self->positions[i] = i + 1;
+	}
+
+	self->desired[0] = ESTIMATOR_P2_ONE;
+	self->desired[1] = ESTIMATOR_P2_ONE + 4 * P2Quantile_increment(percent, 1);
+	self->desired[2] = ESTIMATOR_P2_ONE + 4 * P2Quantile_increment(percent, 2);
+	self->desired[3] = 3 * ESTIMATOR_P2_ONE + 4 * P2Quantile_increment(percent, 1);
+	self->desired[4] = 5 * ESTIMATOR_P2_ONE;
+	self->count = 0x00;
+	self->previous = 0x00;
+	return;
+}
+
+/******************************************************************************
+* Funktionen P2Quantile_increment returnerar ökningen av markör i:s önskade
+* position per observation i fixpunkt, alltså 0, p / 2, p, (1 + p) / 2
+* respektive 1, där p utgör skattad kvantil.
+******************************************************************************/
+static uint32_t P2Quantile_increment(const uint8_t percent, const uint8_t i)
+{
+	const uint32_t p = (percent * ESTIMATOR_P2_ONE + 50) / 100;
+	if (i == 0) return 0x00;
+	if (i == 1) return p / 2;
+	if (i == 2) return p;
+	if (i == 3) return (ESTIMATOR_P2_ONE + p) / 2;
+	return ESTIMATOR_P2_ONE;
+}
+
+/******************************************************************************
+* Funktionen P2Quantile_update lägger till ett intervall och returnerar
+* skattad kvantil. De fem första intervallen lagras sorterade via
+* insättningssortering, där kvantilen väljs direkt bland dessa, förutsatt
+* att ingen skattning finns från föregående fönster. Därefter
+* justeras markörernas positioner, varefter de tre mittersta markörernas
+* höjder korrigeras via parabolisk (alternativt linjär) interpolation ifall
+* deras positioner har avvikit minst ett steg från önskad position. Efter
+* ESTIMATOR_P2_WINDOW observationer startar skattningen om från början,
+* där senaste skattning gäller tills fem nya observationer har gjorts.
+* Intervall större än ESTIMATOR_P2_LIMIT begränsas, så att höjderna och
+* skillnaderna mellan dem ryms i 32 bitar.
+******************************************************************************/
+static uint32_t P2Quantile_update(struct P2Quantile* self, const uint8_t percent, const uint32_t interval)
+{
+	const uint32_t limited = interval > ESTIMATOR_P2_LIMIT ? ESTIMATOR_P2_LIMIT : interval;
+	const int32_t x = (int32_t)(limited << ESTIMATOR_P2_FRACTION);
+
+	if (self->count < 5)
+	{
+		uint8_t i = self->count++;
+
+		while (i > 0 && self->heights[i - 1] > x)
+		{
+			self->heights[i] = self->heights[i - 1];
+			i--;
+		}
+
+		self->heights[i] = x;
+		if (self->previous) return self->previous;
+		return (uint32_t)self->heights[(percent * (self->count - 1) + 50) / 100] >> ESTIMATOR_P2_FRACTION;
+	}
+
+	uint8_t k;
+
+	if (x < self->heights[0])
+	{
+		self->heights[0] = x;
+		k = 0;
+	}
+
+	else if (x >= self->heights[4])
+	{
+		self->heights[4] = x;
+		k = 3;
+	}
+
+	else
+	{
+		k = 0;
+		while (x >= self->heights[k + 1]) k++;
+	}
+
+	for (uint8_t i = k + 1; i < 5; i++)
+		self->positions[i]++;
+
+	for (uint8_t i = 0; i < 5; i++)
+		self->desired[i] += P2Quantile_increment(percent, i);
+
+	for (uint8_t i = 1; i < 4; i++)
+	{
+		const int32_t difference = (int32_t)(self->desired[i] - ((uint32_t)self->positions[i] << 16));
+
+		if ((difference >= (int32_t)ESTIMATOR_P2_ONE && self->positions[i + 1] - self->positions[i] > 1) ||
+			(difference <= -(int32_t)ESTIMATOR_P2_ONE && self->positions[i - 1] - self->positions[i] < -1))
+		{
+			const int8_t direction = difference > 0 ? 1 : -1;
+			const int32_t height = P2Quantile_parabolic(self, i, direction);
+
+			if (self->heights[i - 1] < height && height < self->heights[i + 1])
+				self->heights[i] = height;
+			else
+				self->heights[i] = P2Quantile_linear(self, i, direction);
+
+			self->positions[i] += direction;
+		}
+	}
+
+	const uint32_t estimate = ((uint32_t)self->heights[2] + (1UL << (ESTIMATOR_P2_FRACTION - 1))) >> ESTIMATOR_P2_FRACTION;
+
+	if (++self->count >= ESTIMATOR_P2_WINDOW)
+	{
+		new_P2Quantile(self, percent);
+		self->previous = estimate;
+	}
+
+	return estimate;
+}
+
+/******************************************************************************
+* Funktionen P2Quantile_parabolic returnerar markör i:s nya höjd enligt
+* P²-formeln, där formelns tre divisioner har slagits samman till en enda
+* division i 64 bitar:
+*
+* q + d * ((a + d) * (q+ - q) * a + (b - d) * (q - q-) * b) / (a * b * (a + b)),
+*
+* där a = n - n- samt b = n+ - n utgör avstånden till närliggande markörer.
+******************************************************************************/
+static int32_t P2Quantile_parabolic(const struct P2Quantile* self, const uint8_t i, const int8_t direction)
+{
+	const int32_t* q = self->heights;
+	const int16_t a = self->positions[i] - self->positions[i - 1];
+	const int16_t b = self->positions[i + 1] - self->positions[i];
+
+	const int64_t numerator = direction * ((int64_t)(a + direction) * (q[i + 1] - q[i]) * a +
+		(int64_t)(b - direction) * (q[i] - q[i - 1]) * b);
+	const int64_t denominator = (int64_t)a * b * (a + b);
+	return q[i] + divide_rounded(numerator, denominator);
+}
+
+/******************************************************************************
+* Funktionen P2Quantile_linear returnerar markör i:s nya höjd via linjär
+* interpolation mot närliggande markör i angiven riktning.
+******************************************************************************/
+static int32_t P2Quantile_linear(const struct P2Quantile* self, const uint8_t i, const int8_t direction)
+{
+	const int32_t* q = self->heights;
+	const int16_t distance = self->positions[i + direction] - self->positions[i];
+	return q[i] + divide_rounded(q[i + direction] - q[i], direction * distance);
+}
+
+/******************************************************************************
+* Funktionen divide_rounded returnerar kvoten av given täljare och positiv
+* nämnare, avrundad till närmsta heltal.
+******************************************************************************/
+static int32_t divide_rounded(const int64_t numerator, const int64_t denominator)
+{
+	if (numerator >= 0) return (int32_t)((numerator + denominator / 2) / denominator);
+	return -(int32_t)((-numerator + denominator / 2) / denominator);
+}
@@ -0,0 +1,107 @@
+
+#ifndef INTERVALESTIMATOR_H_
+#define INTERVALESTIMATOR_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+#include "Vector.h"
+
+/******************************************************************************
+* Strukten IntervalEstimator skattar typiskt intervall mellan knapptryckningar
+* (antal timergenererade avbrott), vilket den dynamiska timern använder som
+* fördröjningstid. Följande strategier stöds:
+*
+* - ESTIMATOR_MEAN: aritmetiskt medelvärde av lagrade intervall i den
+*   dynamiska timerns vektor (ursprunglig strategi).
+* - ESTIMATOR_TRIMMED_MEAN: medelvärde av lagrade intervall, där de
+*   ESTIMATOR_TRIM_DIVISOR:e delarna största respektive minsta intervallen
+*   (minst ett vardera vid minst tre intervall) exkluderas, så att enstaka
+*   långa pauser inte påverkar fördröjningstiden. Skattaren håller en
+*   sorterad kopia av lagrade intervall, där varje nytt intervall sätts in
+*   och varje överskrivet intervall tas bort (se IntervalEstimator_remove),
+*   så att varje uppdatering sker i linjär tid.
+* - ESTIMATOR_EWMA: exponentiellt viktat glidande medelvärde i fixpunkt, med
+*   viktningen 1 / 2^ESTIMATOR_EWMA_SHIFT för nytt intervall.
+* - ESTIMATOR_MEDIAN samt ESTIMATOR_QUANTILE: strömmande skattning av median
+*   respektive valfri kvantil via algoritmen P² (Jain & Chlamtac), där fem
+*   markörer uppdateras per intervall. Beräkningarna sker i heltal, där
+*   markörernas höjder lagras i fixpunkt med ESTIMATOR_P2_FRACTION
+*   decimalbitar och önskade positioner med 16 decimalbitar, eftersom
+*   mikrodatorn saknar flyttalsenhet. Efter ESTIMATOR_P2_WINDOW intervall
+*   startar skattningen om, så att den följer förändringar i takten och
+*   glömmer enstaka extrema intervall i stället för att omfatta samtliga
+*   intervall sedan start.
+*
+* Strategierna EWMA, median och kvantil använder konstant minne och behöver
+* inte den dynamiska timerns vektor, varför intervall enbart lagras i
+* vektorn för strategier där IntervalEstimator_uses_history returnerar true.
+* Strategi väljs vid kompilering via makrot INTERVAL_ESTIMATOR, alternativt
+* under körning via IntervalEstimator_set_type (konsolkommandot est). Som
+* standard används medelvärdet, precis som innan strategierna infördes.
+* Skattningen uppdateras från avbrottsrutinen för tryckknappen.
+*
+* Den sorterade kopian för ESTIMATOR_TRIMMED_MEAN måste synkroniseras via
+* IntervalEstimator_sync när den dynamiska timerns vektor ändras på annat
+* sätt än via ett nytt intervall, exempelvis vid tömning eller ändrad
+* kapacitet.
+******************************************************************************/
+
+#ifndef INTERVAL_ESTIMATOR
+#define INTERVAL_ESTIMATOR ESTIMATOR_MEAN		// Strategi vid start.
+#endif
+
+#define ESTIMATOR_EWMA_SHIFT 2				// Viktning 1/4 för nytt intervall.
+#define ESTIMATOR_EWMA_FRACTION 4			// Antal decimalbitar (fixpunkt) för EWMA.
+#define ESTIMATOR_TRIM_DIVISOR 8			// Exkluderar 1/8 av intervallen i vardera änden.
+#define ESTIMATOR_DEFAULT_QUANTILE 50			// Kvantil i procent vid start.
+#define ESTIMATOR_P2_WINDOW 32				// Antal observationer mellan omstarter av kvantilskattningen (högst 250).
+#define ESTIMATOR_P2_FRACTION 4				// Antal decimalbitar (fixpunkt) för markörernas höjder.
+
+typedef enum IntervalEstimatorType
+{
+	ESTIMATOR_MEAN,
+	ESTIMATOR_TRIMMED_MEAN,
+	ESTIMATOR_EWMA,
+	ESTIMATOR_MEDIAN,
+	ESTIMATOR_QUANTILE
+} IntervalEstimatorType;
+
+/******************************************************************************
+* Strukten P2Quantile lagrar markörerna för algoritmen P²: höjder (skattade
+* kvantiler) i fixpunkt, faktiska positioner samt önskade positioner med 16
+* decimalbitar. Ökningen av önskade positioner per observation beräknas
+* från skattad kvantil. De fem första observationerna lagras direkt i
+* heights och sorteras.
+******************************************************************************/
+struct P2Quantile
+{
+	int32_t heights[5];		// Markörernas höjder i fixpunkt.
+	uint8_t positions[5];		// Markörernas faktiska positioner.
+	uint32_t desired[5];		// Markörernas önskade positioner i fixpunkt.
+	uint8_t count;			// Antal observationer.
+	uint32_t previous;		// Skattning från föregående fönster, 0 om sådan saknas.
+};
+
+struct IntervalEstimator
+{
+	IntervalEstimatorType type;	// Vald strategi.
+	uint8_t quantile;		// Skattad kvantil i procent (ESTIMATOR_QUANTILE).
+	uint32_t ewma;			// Glidande medelvärde i fixpunkt.
+	bool ewma_initiated;		// Indikerar att glidande medelvärde har initierats.
+	struct P2Quantile p2;		// Tillstånd för median och kvantil.
+	struct Vector sorted;		// Sorterade intervall (ESTIMATOR_TRIMMED_MEAN).
+	uint32_t estimate;		// Senaste skattning.
+};
+
+// Funktionsdeklarationer:
+struct IntervalEstimator new_IntervalEstimator(const IntervalEstimatorType type);
+void IntervalEstimator_set_type(struct IntervalEstimator* self, const IntervalEstimatorType type);
+void IntervalEstimator_set_quantile(struct IntervalEstimator* self, const uint8_t percent);
+bool IntervalEstimator_uses_history(const struct IntervalEstimator* self);
+uint32_t IntervalEstimator_update(struct IntervalEstimator* self, const uint32_t interval, const struct Vector* history);
+void IntervalEstimator_remove(struct IntervalEstimator* self, const uint32_t interval);
+void IntervalEstimator_sync(struct IntervalEstimator* self, const struct Vector* history);
+void IntervalEstimator_resume(struct IntervalEstimator* self, const uint32_t estimate, const uint32_t ewma);
+const char* IntervalEstimator_name(const IntervalEstimatorType type);
+
+#endif /* INTERVALESTIMATOR_H_ */
@@ -39,7 +39,7 @@ struct Led new_Led(const uint8_t PIN)
 	struct Led self;			// Skapar en variabel/medlem av strukten Led som döps till self.
 	self.enabled = false;			// LED ges startvärdet false (släckt) vid initiering/start av denna funktion.
 	
-	if (PIN >= 0 && PIN <= 7)		// Om ingående parameter (inmatad & önskad PIN vid detta funktionsanrop) är mellan 0 & 7 så sker raderna nedan:
+	if (PIN <= 7)			// Om ingående parameter (inmatad & önskad PIN vid detta funktionsanrop) är mellan 0 & 7 så sker raderna nedan:
 	{
 		self.io_port = IO_PORTD;	// Ger instansvariabeln / objektet self.io_port värdet av enumerationen("makrot") IO_port -> IO_PORTD.
 		self.PIN = PIN;
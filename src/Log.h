@@ -0,0 +1,73 @@
+
+#ifndef LOG_H_
+#define LOG_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+#include "Serial.h"
+#include <avr/pgmspace.h>
+
+/******************************************************************************
+* Makron för diagnostiska utskrifter med nivåerna error, warn, info, debug
+* samt trace. Vilka nivåer som kompileras in väljs via makrot LOG_LEVEL,
+* exempelvis -DLOG_LEVEL=LOG_LEVEL_INFO. Utskrifter på nivåer över vald
+* nivå expanderar till ingenting, varken formatsträng, argument eller
+* funktionsanrop kompileras in. Formatsträngar lagras i flashminnet via
+* PSTR och skrivs ut via serial_printf_P.
+*
+* Om LOG_LEVEL inte anges väljs LOG_LEVEL_WARN för release-byggen (där
+* makrot NDEBUG är definierat) och LOG_LEVEL_DEBUG annars. Nivån trace, som
+* exempelvis skriver ut varje uppmätt intervall, måste väljas explicit.
+*
+* Större diagnostiska utskrifter, exempelvis DynamicTimer_print, omges
+* av #if LOG_LEVEL >= LOG_LEVEL_DEBUG, så att även funktionen utelämnas.
+******************************************************************************/
+
+#define LOG_LEVEL_NONE 0	// Inga diagnostiska utskrifter.
+#define LOG_LEVEL_ERROR 1	// Fel som medför att data går förlorad.
+#define LOG_LEVEL_WARN 2	// Oväntade men hanterade händelser.
+#define LOG_LEVEL_INFO 3	// Tillståndsförändringar, exempelvis start av timern.
+#define LOG_LEVEL_DEBUG 4	// Detaljerad information vid varje uppdatering.
+#define LOG_LEVEL_TRACE 5	// Mätvärden för varje händelse.
+
+#ifndef LOG_LEVEL
+#ifdef NDEBUG
+#define LOG_LEVEL LOG_LEVEL_WARN
+#else
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+#endif
+#endif
+
+#define LOG_PRINT(format, ...) serial_printf_P(PSTR(format), ##__VA_ARGS__)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(format, ...) LOG_PRINT(format, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(format, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(format, ...) LOG_PRINT(format, ##__VA_ARGS__)
+#else
+#define LOG_WARN(format, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(format, ...) LOG_PRINT(format, ##__VA_ARGS__)
+#else
+#define LOG_INFO(format, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(format, ...) LOG_PRINT(format, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(format, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_TRACE
+#define LOG_TRACE(format, ...) LOG_PRINT(format, ##__VA_ARGS__)
+#else
+#define LOG_TRACE(format, ...) do {} while (0)
+#endif
+
+#endif /* LOG_H_ */
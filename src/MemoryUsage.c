@@ -0,0 +1,128 @@
+// Inkluderingsdirektiv:
+#include "MemoryUsage.h"
+#include "Serial.h"
+
+#if defined(__AVR__)
+
+// Symboler definierade av länkaren samt avr-libc:
+extern uint8_t __data_start;
+extern uint8_t __data_end;
+extern uint8_t __bss_start;
+extern uint8_t __bss_end;
+extern uint8_t __heap_start;
+extern uint8_t __stack;
+extern char* __brkval;
+
+void MemoryUsage_paint_stack(void) __attribute__((naked, used, section(".init1")));
+
+/******************************************************************************
+* Funktionen MemoryUsage_paint_stack fyller minnet från slutet av .bss
+* (symbolen _end) upp till och med stackens start (__stack, vilket motsvarar
+* RAMEND) med mönstret STACK_PAINT_PATTERN. Funktionen placeras i sektionen
+* .init1 och exekveras därmed direkt efter reset, innan stacken används och
+* innan registret r1 har nollställts. Därför implementeras den i assembler
+* utan stackanvändning och anropas aldrig, utan exekveras när programflödet
+* passerar sektionen (attributet naked utelämnar återhopp).
+******************************************************************************/
+void MemoryUsage_paint_stack(void)
+{
+	__asm volatile (
+		"	ldi r30, lo8(_end)	\n"
+		"	ldi r31, hi8(_end)	\n"
+		"	ldi r24, %0		\n"
+		"	ldi r25, hi8(__stack)	\n"
+		"	rjmp 2f			\n"
+		"1:	st Z+, r24		\n"
+		"2:	cpi r30, lo8(__stack)	\n"
+		"	cpc r31, r25		\n"
+		"	brlo 1b			\n"
+		"	breq 1b			\n"
+		:
+		: "i" (STACK_PAINT_PATTERN)
+		: "memory"
+	);
+}
+
+/******************************************************************************
+* Funktionen heap_top returnerar adressen för heapens nuvarande topp. Om
+* malloc aldrig har anropats är __brkval noll och heapen är tom, då toppen
+* utgörs av heapens start.
+******************************************************************************/
+static inline uint8_t* heap_top(void)
+{
+	return __brkval ? (uint8_t*)__brkval : &__heap_start;
+}
+
+/******************************************************************************
+* Funktionen MemoryUsage_stack_free_minimum returnerar det minsta avståndet
+* mellan heapens topp och stacken sedan start. Från heapens topp räknas
+* antalet byte som fortfarande innehåller mönstret STACK_PAINT_PATTERN, fram
+* till första byte som har skrivits över av stacken.
+******************************************************************************/
+uint16_t MemoryUsage_stack_free_minimum(void)
+{
+	const uint8_t* address = heap_top();
+	uint16_t free_bytes = 0x00;
+
+	while (address <= &__stack && *address == STACK_PAINT_PATTERN)
+	{
+		address++;
+		free_bytes++;
+	}
+	return free_bytes;
+}
+
+/******************************************************************************
+* Funktionen MemoryUsage_get returnerar en ögonblicksbild av aktuell
+* minnesanvändning, där storlekar på sektionerna .data och .bss beräknas
+* utifrån länkarens symboler och heapens topp hämtas från avr-libc.
+******************************************************************************/
+struct MemoryUsage MemoryUsage_get(void)
+{
+	struct MemoryUsage self;
+	const uint8_t* top = heap_top();
+	self.data_size = (uint16_t)(&__data_end - &__data_start);
+	self.bss_size = (uint16_t)(&__bss_end - &__bss_start);
+	self.heap_top = (uint16_t)top;
+	self.heap_size = (uint16_t)(top - &__heap_start);
+	self.stack_pointer = SP;
+	self.free_now = self.stack_pointer > self.heap_top ? self.stack_pointer - self.heap_top : 0;
+	self.free_minimum = MemoryUsage_stack_free_minimum();
+	return self;
+}
+
+#else
+
+/******************************************************************************
+* Vid kompilering för andra plattformar än AVR saknas länkarens symboler,
+* varpå samtliga värden sätts till noll.
+******************************************************************************/
+uint16_t MemoryUsage_stack_free_minimum(void)
+{
+	return 0;
+}
+
+struct MemoryUsage MemoryUsage_get(void)
+{
+	struct MemoryUsage self = { 0, 0, 0, 0, 0, 0, 0 };
+	return self;
+}
+
+#endif
+
+/******************************************************************************
+* Funktionen MemoryUsage_print används för att skriva ut aktuell
+* minnesanvändning via seriell överföring.
+******************************************************************************/
+void MemoryUsage_print(void)
+{
+	const struct MemoryUsage usage = MemoryUsage_get();
+	serial_print_unsigned(".data: %lu bytes\n", usage.data_size);
+	serial_print_unsigned(".bss: %lu bytes\n", usage.bss_size);
+	serial_print_unsigned("Heap top: 0x%lx\n", usage.heap_top);
+	serial_print_unsigned("Heap size: %lu bytes\n", usage.heap_size);
+	serial_print_unsigned("Stack pointer: 0x%lx\n", usage.stack_pointer);
+	serial_print_unsigned("Free (now): %lu bytes\n", usage.free_now);
+	serial_print_unsigned("Free (minimum): %lu bytes\n", usage.free_minimum);
+	return;
+}
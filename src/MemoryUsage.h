@@ -0,0 +1,44 @@
+
+#ifndef MEMORYUSAGE_H_
+#define MEMORYUSAGE_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+
+/******************************************************************************
+* ATmega328P har 2 kB RAM, som delas mellan statiska variabler (sektionerna
+* .data och .bss), heapen samt stacken. Heapen börjar direkt efter .bss och
+* växer uppåt, medan stacken börjar på högsta adressen (RAMEND) och växer
+* nedåt. Om dessa möts skrivs data över utan att hårdvaran upptäcker det.
+*
+* För att mäta hur nära detta programmet har varit, så fylls allt oanvänt
+* minne mellan .bss och stacken med mönstret STACK_PAINT_PATTERN vid start,
+* innan main anropas (i sektionen .init1). Därefter kan det minsta avståndet
+* mellan heapen och stacken sedan start mätas genom att räkna antalet byte
+* ovanför heapens topp som fortfarande innehåller mönstret, då varje byte som
+* stacken någon gång har använt har skrivits över.
+******************************************************************************/
+
+#define STACK_PAINT_PATTERN 0xC5	// Mönster som oanvänt minne fylls med vid start.
+
+/******************************************************************************
+* Strukten MemoryUsage lagrar en ögonblicksbild av minnesanvändningen.
+* Samtliga storlekar och avstånd mäts i byte.
+******************************************************************************/
+struct MemoryUsage
+{
+	uint16_t data_size;		// Storlek på sektionen .data (initierade statiska variabler).
+	uint16_t bss_size;		// Storlek på sektionen .bss (nollställda statiska variabler).
+	uint16_t heap_top;		// Adress för heapens nuvarande topp.
+	uint16_t heap_size;		// Heapens nuvarande storlek.
+	uint16_t stack_pointer;		// Stackpekarens nuvarande adress.
+	uint16_t free_now;		// Nuvarande avstånd mellan heapens topp och stacken.
+	uint16_t free_minimum;		// Minsta avstånd mellan heapens topp och stacken sedan start.
+};
+
+// Funktionsdeklarationer:
+struct MemoryUsage MemoryUsage_get(void);
+uint16_t MemoryUsage_stack_free_minimum(void);
+void MemoryUsage_print(void);
+
+#endif /* MEMORYUSAGE_H_ */
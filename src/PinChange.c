@@ -0,0 +1,128 @@
+// Inkluderingsdirektiv:
+#include "PinChange.h"
+#include <util/atomic.h>
+
+static struct PinChangeHandler handlers[PIN_CHANGE_PORTS][8];	// Callbackfunktioner per I/O-port och PIN.
+static volatile uint8_t previous[PIN_CHANGE_PORTS];		// Senast hanterad insignal per I/O-port.
+static uint8_t attached[PIN_CHANGE_PORTS];			// PINs med registrerade callbackfunktioner per I/O-port.
+static volatile uint32_t timestamp = 0x00;			// Tidpunkt för händelsen som hanteras.
+
+/******************************************************************************
+* Funktionen PinChange_attach registrerar callbackfunktioner för en given
+* PIN (0 - 7) på en given I/O-port, där pressed anropas när insignalen blir
+* hög och released när insignalen blir låg. Aktuell insignal lagras som
+* utgångsläge. Avbrott aktiveras separat via PinChange_enable.
+******************************************************************************/
+void PinChange_attach(const IO_port io_port, const uint8_t PIN, void (*pressed)(void), void (*released)(void))
+{
+	if (io_port >= PIN_CHANGE_PORTS || PIN > 7) return;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		handlers[io_port][PIN].pressed = pressed;
+		handlers[io_port][PIN].released = released;
+		if (pressed || released) attached[io_port] |= (1 << PIN);
+		else attached[io_port] &= ~(1 << PIN);
+		previous[io_port] = (previous[io_port] & ~(1 << PIN)) | (PORT_PIN_REGISTER(io_port) & (1 << PIN));
+	}
+
+	return;
+}
+
+/******************************************************************************
+* Funktionen PinChange_enable aktiverar PCI-avbrott för en given PIN via
+* ettställning av portens bit i PCICR samt PIN:ens bit i maskregistret.
+* Om insignalen har ändrats sedan senast hanterade nivå, exempelvis medan
+* avbrottet var inaktiverat under bouncetid, anropas motsvarande
+* callbackfunktion direkt. Detta sker med avbrott inaktiverade, precis som
+* i avbrottsrutinen.
+******************************************************************************/
+void PinChange_enable(const IO_port io_port, const uint8_t PIN)
+{
+	if (io_port >= PIN_CHANGE_PORTS || PIN > 7) return;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		const uint8_t level = PORT_PIN_REGISTER(io_port);
+		const uint8_t changed = (level ^ previous[io_port]) & (1 << PIN);
+
+		previous[io_port] ^= changed;
+		PCICR |= (1 << io_port);
+		PORT_PCMSK_REGISTER(io_port) |= (1 << PIN);
+		if (changed) PinChange_dispatch(io_port, changed, level, Clock_now());
+	}
+
+	return;
+}
+
+/******************************************************************************
+* Funktionen PinChange_disable inaktiverar PCI-avbrott för en given PIN via
+* nollställning av PIN:ens bit i maskregistret. Portens bit i PCICR lämnas
+* oförändrad, eftersom övriga PINs på porten kan använda avbrottet.
+******************************************************************************/
+void PinChange_disable(const IO_port io_port, const uint8_t PIN)
+{
+	if (io_port >= PIN_CHANGE_PORTS || PIN > 7) return;
+	PORT_PCMSK_REGISTER(io_port) &= ~(1 << PIN);
+	return;
+}
+
+/******************************************************************************
+* Funktionen PinChange_interrupt anropas från avbrottsrutinen för en given
+* I/O-port. Portens insignaler läses en gång och jämförs med föregående
+* avläsning via XOR, där enbart PINs med aktiverat avbrott beaktas.
+* Föregående avläsning uppdateras för dessa PINs, varefter
+* callbackfunktionen för varje ändrad PIN anropas.
+******************************************************************************/
+void PinChange_interrupt(const IO_port io_port)
+{
+	const uint8_t level = PORT_PIN_REGISTER(io_port);
+	const uint8_t changed = (level ^ previous[io_port]) & PORT_PCMSK_REGISTER(io_port);
+
+	previous[io_port] ^= changed;
+	PinChange_dispatch(io_port, changed, level, Clock_now());
+	return;
+}
+
+/******************************************************************************
+* Funktionen PinChange_dispatch anropar registrerad callbackfunktion för
+* varje ettställd bit i changed, där pressed anropas om motsvarande bit i
+* level är hög, annars released. Tidpunkten time, mätt i klockans
+* uppräkningar (se Clock.h), kan läsas via PinChange_time från
+* callbackfunktionerna. Högst åtta PINs genomlöps, där genomlöpningen
+* avslutas när inga fler ändrade PINs återstår. Funktionen anropas med
+* avbrott inaktiverade.
+******************************************************************************/
+void PinChange_dispatch(const IO_port io_port, uint8_t changed, uint8_t level, const uint32_t time)
+{
+	const struct PinChangeHandler* handler = handlers[io_port];
+	timestamp = time;
+
+	for (; changed; changed >>= 1, level >>= 1, handler++)
+	{
+		if (!(changed & 0x01)) continue;
+		void (*callback)(void) = (level & 0x01) ? handler->pressed : handler->released;
+		if (callback) callback();
+	}
+
+	return;
+}
+
+/******************************************************************************
+* Funktionen PinChange_attached returnerar en bitmask med de PINs på en
+* given I/O-port som har registrerade callbackfunktioner.
+******************************************************************************/
+uint8_t PinChange_attached(const IO_port io_port)
+{
+	return io_port < PIN_CHANGE_PORTS ? attached[io_port] : 0x00;
+}
+
+/******************************************************************************
+* Funktionen PinChange_time returnerar tidpunkten för händelsen som
+* hanteras, mätt i klockans uppräkningar (4 us), och anropas från
+* callbackfunktionerna.
+******************************************************************************/
+uint32_t PinChange_time(void)
+{
+	return timestamp;
+}
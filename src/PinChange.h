@@ -0,0 +1,68 @@
+
+#ifndef PINCHANGE_H_
+#define PINCHANGE_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+#include "Clock.h"
+
+/******************************************************************************
+* PinChange fördelar PCI-avbrott till enskilda PINs. Varje I/O-port har en
+* egen avbrottsvektor, som delas av portens samtliga PINs:
+*
+* I/O-port B (PIN 8 - 13): PCINT0_vect
+* I/O-port C (PIN A0 - A5): PCINT1_vect
+* I/O-port D (PIN 0 - 7): PCINT2_vect
+*
+* Avbrottsvektorn anger därmed enbart att någon PIN på porten har ändrats.
+* I avbrottsrutinen anropas PinChange_interrupt, som läser portens
+* PIN-register en gång och jämför med föregående avläsning via XOR, där
+* resultatet maskeras med portens maskregister (PCMSKn). Därefter anropas
+* registrerad callbackfunktion för varje ändrad PIN, pressed vid hög
+* insignal och released vid låg insignal, via tabellen handlers. Tabellen
+* täcker portarnas samtliga 20 PINs och varje avbrott hanterar högst åtta
+* PINs, så att exekveringstiden är begränsad oavsett antal tryckknappar.
+*
+* Föregående avläsning uppdateras enbart för PINs vars avbrott är
+* aktiverade, eftersom avbrott inte sker för maskerade PINs. När avbrott
+* återaktiveras via PinChange_enable (exempelvis efter bouncetid) jämförs
+* insignalen med senast hanterade nivå, där en ändring som skedde medan
+* avbrottet var inaktiverat hanteras direkt, så att varje nedtryckning
+* följs av ett släpp.
+*
+* Tidpunkten för händelsen som hanteras kan läsas via PinChange_time från
+* callbackfunktionen. Som alternativ till PCI-avbrott kan insignalerna
+* avläsas periodiskt via Debouncer.h, som anropar samma callbackfunktioner
+* via PinChange_dispatch.
+*
+* Registren PINB - PIND ligger med tre byte mellanrum i dataminnet, medan
+* maskregistren PCMSK0 - PCMSK2 ligger direkt efter varandra, där I/O-port
+* B, C och D motsvarar index 0 - 2 (IO_port). Adresserna anges numeriskt på
+* samma sätt som i Timer.h.
+******************************************************************************/
+
+#define PIN_CHANGE_PORTS 3						// Antal I/O-portar med PCI-avbrott (B, C och D).
+#define PORT_PIN_REGISTER(io_port) _SFR_MEM8(0x23 + 3 * (io_port))	// PINB, PINC eller PIND.
+#define PORT_PCMSK_REGISTER(io_port) _SFR_MEM8(0x6B + (io_port))	// PCMSK0, PCMSK1 eller PCMSK2.
+
+/******************************************************************************
+* Strukten PinChangeHandler lagrar callbackfunktioner för en given PIN,
+* vilka anropas från avbrottsrutinen. Saknade callbackfunktioner
+* anges med 0.
+******************************************************************************/
+struct PinChangeHandler
+{
+	void (*pressed)(void);	// Anropas när insignalen blir hög.
+	void (*released)(void);	// Anropas när insignalen blir låg.
+};
+
+// Funktionsdeklarationer:
+void PinChange_attach(const IO_port io_port, const uint8_t PIN, void (*pressed)(void), void (*released)(void));
+void PinChange_enable(const IO_port io_port, const uint8_t PIN);
+void PinChange_disable(const IO_port io_port, const uint8_t PIN);
+void PinChange_interrupt(const IO_port io_port);
+void PinChange_dispatch(const IO_port io_port, uint8_t changed, uint8_t level, const uint32_t time);
+uint8_t PinChange_attached(const IO_port io_port);
+uint32_t PinChange_time(void);
+
+#endif /* PINCHANGE_H_ */
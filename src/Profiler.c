@@ -0,0 +1,103 @@
+// Inkluderingsdirektiv:
+#include "Profiler.h"
+#include "Serial.h"
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+
+#ifdef ISR_PROFILER_ENABLED
+
+static struct ProfilerEntry entries[PROFILER_VECTORS];	// Mätvärden per avbrottsvektor.
+
+// Avbrottsvektorernas namn, lagrade i flashminnet:
+static const char PCINT0_name[] PROGMEM = "PCINT0";
+static const char TIMER2_COMPA_name[] PROGMEM = "TIMER2_COMPA";
+static const char TIMER1_COMPA_name[] PROGMEM = "TIMER1_COMPA";
+static const char* const names[PROFILER_VECTORS] PROGMEM = { PCINT0_name, TIMER2_COMPA_name, TIMER1_COMPA_name };
+
+/******************************************************************************
+* Funktionen Profiler_enter anropas vid början av en avbrottsrutin. Aktuell
+* tid lagras som starttid för avbrottsvektorn och längsta fördröjning
+* uppdateras ifall ingående argument latency överstiger tidigare värden.
+******************************************************************************/
+void Profiler_enter(const ProfilerVector vector, const uint16_t latency)
+{
+	struct ProfilerEntry* self = &entries[vector];
+	self->start = Clock_now();
+	if (latency > self->latency) self->latency = latency;
+	return;
+}
+
+/******************************************************************************
+* Funktionen Profiler_exit anropas vid slutet av en avbrottsrutin.
+* Exekveringstiden beräknas som differensen mellan aktuell tid och
+* starttiden, varefter antal exekveringar, total, kortaste samt längsta
+* exekveringstid uppdateras. Om antalet exekveringar når sitt maxvärde
+* slutar mätningen för att genomsnittet inte skall bli felaktigt.
+******************************************************************************/
+void Profiler_exit(const ProfilerVector vector)
+{
+	struct ProfilerEntry* self = &entries[vector];
+	if (self->count == UINT16_MAX) return;
+
+	const uint32_t elapsed = Clock_now() - self->start;
+	const uint16_t duration = elapsed > UINT16_MAX ? UINT16_MAX : (uint16_t)elapsed;
+
+	if (!self->count || duration < self->minimum) self->minimum = duration;
+	if (duration > self->maximum) self->maximum = duration;
+	self->total += duration;
+	self->count++;
+	return;
+}
+
+/******************************************************************************
+* Funktionen Profiler_reset nollställer samtliga mätvärden. Avbrott
+* inaktiveras under nollställningen så att ingen avbrottsrutin uppdaterar
+* tabellen samtidigt.
+******************************************************************************/
+void Profiler_reset(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		for (register uint8_t i = 0; i < PROFILER_VECTORS; i++)
+		{
+			entries[i].count = 0x00;
+			entries[i].minimum = 0x00;
+			entries[i].maximum = 0x00;
+			entries[i].total = 0x00;
+			entries[i].latency = 0x00;
+		}
+	}
+	return;
+}
+
+/******************************************************************************
+* Funktionen Profiler_print används för att skriva ut profilerarens tabell
+* via seriell överföring. Exekveringstider skrivs ut i mikrosekunder, medan
+* fördröjning skrivs ut i respektive timers uppräkningar. En kopia av
+* varje rad tas med avbrott inaktiverade, så att utskriften blir konsistent.
+******************************************************************************/
+void Profiler_print(void)
+{
+	char name[16];
+	serial_print("ISR profile (times in us, latency in timer counts):\n");
+
+	for (register uint8_t i = 0; i < PROFILER_VECTORS; i++)
+	{
+		struct ProfilerEntry entry;
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			entry = entries[i];
+		}
+
+		strcpy_P(name, (const char*)pgm_read_ptr(&names[i]));
+		serial_print(name);
+		serial_print_unsigned(": count %lu", entry.count);
+		serial_print_unsigned(", min %lu", (uint32_t)entry.minimum * CLOCK_TICK_US);
+		serial_print_unsigned(", max %lu", (uint32_t)entry.maximum * CLOCK_TICK_US);
+		serial_print_unsigned(", mean %lu", entry.count ? entry.total * CLOCK_TICK_US / entry.count : 0);
+		serial_print_unsigned(", latency %lu\n", entry.latency);
+	}
+	return;
+}
+
+#endif /* ISR_PROFILER_ENABLED */
@@ -0,0 +1,75 @@
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+#include "Clock.h"
+
+/******************************************************************************
+* Profileraren används för att mäta exekveringstid samt fördröjning för
+* programmets avbrottsrutiner. Vid början av en avbrottsrutin anropas makrot
+* PROFILER_ENTER och vid slutet anropas makrot PROFILER_EXIT, där tiden läses
+* från klockan (se Clock.h) med upplösningen 4 us. För varje avbrottsvektor
+* lagras antalet exekveringar, kortaste, längsta och genomsnittlig
+* exekveringstid, samt längsta uppmätta fördröjning från att avbrottet
+* begärdes tills avbrottsrutinen startade.
+*
+* Fördröjningen passeras som andra argument till PROFILER_ENTER och mäts
+* av anroparen via respektive timers räknarregister, mätt i timerns
+* uppräkningar, exempelvis TCNT1 för CTC-avbrott på Timer 1. För
+* avbrott utan tidsreferens (exempelvis PCI-avbrott) passeras 0.
+*
+* Exekveringstiden inkluderar eventuella nästlade avbrott, vilket kan ske
+* ifall avbrott aktiveras globalt inuti en avbrottsrutin.
+*
+* Profileraren kompileras enbart in i debug-byggen. Vid release-byggen,
+* där makrot NDEBUG är definierat, eller ifall DISABLE_ISR_PROFILER är
+* definierat, expanderar makrona till ingenting.
+******************************************************************************/
+
+#if !defined(NDEBUG) && !defined(DISABLE_ISR_PROFILER)
+#define ISR_PROFILER_ENABLED
+#endif
+
+/******************************************************************************
+* Enumerationen ProfilerVector anger index för respektive avbrottsvektor i
+* profilerarens tabell.
+******************************************************************************/
+typedef enum ProfilerVector
+{
+	PROFILER_PCINT0,
+	PROFILER_TIMER2_COMPA,
+	PROFILER_TIMER1_COMPA,
+	PROFILER_VECTORS
+} ProfilerVector;
+
+/******************************************************************************
+* Strukten ProfilerEntry lagrar mätvärden för en given avbrottsvektor.
+* Samtliga tider mäts i klockans uppräkningar (4 us).
+******************************************************************************/
+struct ProfilerEntry
+{
+	uint16_t count;		// Antal exekveringar.
+	uint16_t minimum;	// Kortaste exekveringstid.
+	uint16_t maximum;	// Längsta exekveringstid.
+	uint32_t total;		// Total exekveringstid, används för beräkning av genomsnitt.
+	uint16_t latency;	// Längsta fördröjning, mätt i aktuell timers uppräkningar.
+	uint32_t start;		// Tidpunkt då pågående exekvering startade.
+};
+
+#ifdef ISR_PROFILER_ENABLED
+#define PROFILER_ENTER(vector, latency) Profiler_enter(vector, latency)
+#define PROFILER_EXIT(vector) Profiler_exit(vector)
+#else
+#define PROFILER_ENTER(vector, latency)
+#define PROFILER_EXIT(vector)
+#endif
+
+// Funktionsdeklarationer (enbart tillgängliga då profileraren är aktiverad):
+void Profiler_enter(const ProfilerVector vector, const uint16_t latency);
+void Profiler_exit(const ProfilerVector vector);
+void Profiler_reset(void);
+void Profiler_print(void);
+
+#endif /* PROFILER_H_ */
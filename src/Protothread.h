@@ -0,0 +1,59 @@
+
+#ifndef PROTOTHREAD_H_
+#define PROTOTHREAD_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+
+/******************************************************************************
+* Protothreads utgör lättviktiga korutiner utan egen stack, som möjliggör
+* att ett förlopp bestående av flera väntetider (exempelvis AD-omvandling
+* följt av seriell transmission) skrivs sekventiellt utan att programmet
+* blockeras. I stället för att vänta i en while-sats returnerar funktionen
+* PT_WAITING, varefter den anropas på nytt från huvudloopen och fortsätter
+* där den avbröts. Därmed kan flera förlopp exekvera omväxlande i
+* huvudloopen.
+*
+* Tillståndet utgörs enbart av strukten Protothread (två byte), som lagrar
+* radnumret där funktionen senast avbröts. Vid nästa anrop hoppar
+* switch-satsen i PT_BEGIN direkt till motsvarande case-etikett, som har
+* placerats ut av makrona PT_WAIT_UNTIL samt PT_YIELD via __LINE__. Detta
+* medför följande begränsningar:
+*
+* - Lokala variabler behålls inte mellan anrop, utan värden som behövs
+*   efter en väntan måste lagras i en struktur (exempelvis i samma
+*   strukt som tillståndet).
+* - Switch-satser får inte innehålla väntan, eftersom case-etiketterna
+*   då skulle tillhöra fel switch-sats.
+* - Enbart en väntan per rad är tillåten.
+*
+* Exempel, där en funktion väntar på AD-omvandling (se ADC.h):
+*
+* ProtothreadState task(struct Task* self)
+* {
+*	PT_BEGIN(&self->pt);
+*	ADC_start(self->PIN);
+*	PT_WAIT_UNTIL(&self->pt, ADC_ready());
+*	self->result = ADC_result();
+*	PT_END(&self->pt);
+* }
+******************************************************************************/
+
+typedef enum ProtothreadState { PT_WAITING, PT_ENDED } ProtothreadState;  // Returvärden för protothreads.
+
+struct Protothread
+{
+	uint16_t line;	// Radnummer där exekveringen fortsätter, 0 vid start.
+};
+
+#define PT_INIT(pt) ((pt)->line = 0)							// Startar om från början.
+#define PT_BEGIN(pt) switch ((pt)->line) { case 0:					// Inleder funktionens kropp.
+#define PT_WAIT_UNTIL(pt, condition) do { (pt)->line = __LINE__; if (0) { case __LINE__:;	\
+	} if (!(condition)) return PT_WAITING; } while (0)					// Väntar tills villkoret är uppfyllt.
+#define PT_WAIT_WHILE(pt, condition) PT_WAIT_UNTIL(pt, !(condition))			// Väntar så länge villkoret är uppfyllt.
+#define PT_WAIT_THREAD(pt, thread) PT_WAIT_WHILE(pt, (thread) == PT_WAITING)		// Väntar tills en annan protothread har avslutats.
+#define PT_YIELD(pt) do { (pt)->line = __LINE__; return PT_WAITING; case __LINE__:;	\
+	} while (0)										// Lämnar över till övriga förlopp ett varv.
+#define PT_END(pt) } (pt)->line = 0; return PT_ENDED					// Avslutar funktionens kropp.
+
+#endif /* PROTOTHREAD_H_ */
@@ -0,0 +1,121 @@
+// Inkluderingsdirektiv:
+#include "SensorModel.h"
+
+/******************************************************************************
+* Brytpunkter för en linjär temperatursensor (exempelvis TMP36), där
+* temperaturen beräknas som temp = 100 * Uin - 50 vid matningsspänning 5 V.
+* Två brytpunkter räcker för att beskriva sambandet: ADC-kod 0 motsvarar
+* -50.0 grader Celcius och ADC-kod 1023 motsvarar 450.0 grader Celcius.
+* Lutningen är 5000 / 1023 = 4.888 tiondels grader per ADC-steg, vilket
+* motsvarar 1251 i Q8-format.
+******************************************************************************/
+static const struct SensorPoint tmp36_points[] PROGMEM =
+{
+	{    0,  -500,   1251 },
+	{ 1023,  4500,      0 },
+};
+
+/******************************************************************************
+* Brytpunkter för en NTC-termistor på 10 kOhm (B = 3950) ansluten mot jord
+* med en pullup-resistor på 10 kOhm mot Vcc, så att ADC-koden ökar med
+* termistorns resistans (och därmed minskar med temperaturen). Brytpunkterna
+* är valda så att felet från den linjära interpoleringen understiger
+* 0.3 grader Celcius i intervallet -37 till 129 grader Celcius, vilket
+* motsvarar ADC-koder 32 - 992.
+******************************************************************************/
+static const struct SensorPoint ntc10k_points[] PROGMEM =
+{
+	{   32,  1293,  -2976 },
+	{   40,  1200,  -2278 },
+	{   50,  1111,  -1771 },
+	{   62,  1028,  -1399 },
+	{   77,   946,  -1057 },
+	{  100,   851,   -803 },
+	{  129,   760,   -609 },
+	{  166,   672,   -479 },
+	{  213,   584,   -369 },
+	{  281,   486,   -294 },
+	{  369,   385,   -243 },
+	{  511,   250,   -224 },
+	{  722,    65,   -259 },
+	{  821,   -35,   -323 },
+	{  882,  -112,   -414 },
+	{  924,  -180,   -538 },
+	{  954,  -243,   -721 },
+	{  976,  -305,  -1008 },
+	{  992,  -368,      0 },
+};
+
+const struct SensorModel tmp36_model = { tmp36_points, sizeof(tmp36_points) / sizeof(struct SensorPoint) };
+const struct SensorModel ntc10k_model = { ntc10k_points, sizeof(ntc10k_points) / sizeof(struct SensorPoint) };
+
+/******************************************************************************
+* Funktionen SensorModel_convert används för att omvandla en ADC-kod till
+* motsvarande värde enligt en given sensormodell. Först söks det segment
+* som ADC-koden ligger inom via binärsökning bland brytpunkterna, vilket
+* kräver högst fem jämförelser för en tabell på 32 brytpunkter. Om ADC-koden
+* understiger första brytpunkten returneras dess värde direkt. Därefter
+* interpoleras värdet linjärt via segmentets förberäknade lutning, vilket
+* enbart kräver en multiplikation och en skiftning.
+******************************************************************************/
+int16_t SensorModel_convert(const struct SensorModel* self, const uint16_t ADC_code)
+{
+	uint8_t low = 0;
+	uint8_t high = self->size - 1;
+
+	if (ADC_code <= pgm_read_word(&self->points[0].ADC_code))
+		return (int16_t)pgm_read_word(&self->points[0].value);
+
+	while (low < high)
+	{
+		const uint8_t middle = (uint8_t)((low + high + 1) >> 1);
+		if (pgm_read_word(&self->points[middle].ADC_code) <= ADC_code)
+			low = middle;
+		else
+			high = middle - 1;
+	}
+
+	const uint16_t ADC_code0 = pgm_read_word(&self->points[low].ADC_code);
+	const int16_t value0 = (int16_t)pgm_read_word(&self->points[low].value);
+	const int16_t slope = (int16_t)pgm_read_word(&self->points[low].slope);
+	return value0 + (int16_t)(((int32_t)(ADC_code - ADC_code0) * slope) >> 8);
+}
+
+/******************************************************************************
+* Funktionen new_SensorCalibration returnerar en neutral kalibrering, där
+* förstärkningen är 1.0 och förskjutningen är noll.
+******************************************************************************/
+struct SensorCalibration new_SensorCalibration(void)
+{
+	struct SensorCalibration self;
+	self.gain = SENSOR_CALIBRATION_GAIN_ONE;
+	self.offset = 0;
+	return self;
+}
+
+/******************************************************************************
+* Funktionen SensorCalibration_set används för tvåpunktskalibrering. Ingående
+* argument measured_low och measured_high utgör av sensormodellen beräknade
+* värden vid två referenstemperaturer, medan actual_low och actual_high utgör
+* de verkliga temperaturerna vid samma tillfällen. Förstärkning och
+* förskjutning beräknas en gång här, så att själva korrigeringen vid varje
+* avläsning enbart kräver en multiplikation och en addition. Om de uppmätta
+* värdena är lika görs ingen ändring, då förstärkningen då inte är definierad.
+******************************************************************************/
+void SensorCalibration_set(struct SensorCalibration* self, const int16_t measured_low, const int16_t actual_low,
+	const int16_t measured_high, const int16_t actual_high)
+{
+	if (measured_high == measured_low) return;
+	self->gain = (int16_t)(((int32_t)(actual_high - actual_low) << 12) / (measured_high - measured_low));
+	self->offset = actual_low - (int16_t)(((int32_t)measured_low * self->gain) >> 12);
+	return;
+}
+
+/******************************************************************************
+* Funktionen SensorCalibration_apply används för att korrigera ett värde
+* enligt given kalibrering.
+******************************************************************************/
+int16_t SensorCalibration_apply(const struct SensorCalibration* self, const int16_t value)
+{
+	return (int16_t)(((int32_t)value * self->gain) >> 12) + self->offset;
+}
@@ -0,0 +1,72 @@
+
+#ifndef SENSORMODEL_H_
+#define SENSORMODEL_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+#include <avr/pgmspace.h>	// Bibliotek för lagring och avläsning av konstanter i flashminnet.
+
+/******************************************************************************
+* En sensormodell beskriver sambandet mellan resultatet från en AD-omvandling
+* (0 - 1023) och uppmätt storhet, här temperatur mätt i tiondels grader
+* Celcius. Sambandet lagras som en tabell av brytpunkter i flashminnet
+* (PROGMEM), sorterade efter stigande ADC-kod. Mellan två brytpunkter sker
+* linjär interpolering med heltal enligt formeln
+*
+* value = value0 + ((ADC_code - ADC_code0) * slope) >> 8,
+*
+* där slope är lutningen till nästa brytpunkt i fixtalsformat Q8 (värde per
+* ADC-steg * 256). Lutningen beräknas i förväg vid framtagning av tabellen,
+* så att ingen division eller flyttalsberäkning behövs per avläsning:
+*
+* slope = (value1 - value0) * 256 / (ADC_code1 - ADC_code0)
+*
+* Sista brytpunkten har lutningen 0. ADC-koder utanför tabellen begränsas
+* till första respektive sista brytpunktens värde.
+******************************************************************************/
+struct SensorPoint
+{
+	uint16_t ADC_code;	// ADC-kod för brytpunkten.
+	int16_t value;		// Uppmätt storhet vid brytpunkten (tiondels grader Celcius).
+	int16_t slope;		// Lutning till nästa brytpunkt i Q8-format.
+};
+
+/******************************************************************************
+* Strukten SensorModel refererar till en tabell av brytpunkter i flashminnet
+* samt antalet brytpunkter i denna tabell.
+******************************************************************************/
+struct SensorModel
+{
+	const struct SensorPoint* points;	// Pekare till brytpunkter lagrade i flashminnet.
+	uint8_t size;				// Antalet brytpunkter.
+};
+
+/******************************************************************************
+* Strukten SensorCalibration används för tvåpunktskalibrering av en sensor.
+* Korrigerat värde beräknas som
+*
+* corrected = (value * gain) >> 12 + offset,
+*
+* där gain lagras i fixtalsformat Q12 (4096 motsvarar förstärkning 1.0) och
+* offset lagras i samma enhet som sensormodellens värden.
+******************************************************************************/
+struct SensorCalibration
+{
+	int16_t gain;	// Förstärkning i Q12-format.
+	int16_t offset;	// Förskjutning i tiondels grader Celcius.
+};
+
+#define SENSOR_CALIBRATION_GAIN_ONE 4096	// Förstärkning 1.0 i Q12-format.
+
+// Fördefinierade sensormodeller:
+extern const struct SensorModel tmp36_model;	// Linjär sensor, temp = 100 * Uin - 50 (Vcc = 5 V).
+extern const struct SensorModel ntc10k_model;	// NTC-termistor 10 kOhm (B = 3950) mot jord med 10 kOhm pullup.
+
+// Funktionsdeklarationer:
+int16_t SensorModel_convert(const struct SensorModel* self, const uint16_t ADC_code);
+struct SensorCalibration new_SensorCalibration(void);
+void SensorCalibration_set(struct SensorCalibration* self, const int16_t measured_low, const int16_t actual_low,
+	const int16_t measured_high, const int16_t actual_high);
+int16_t SensorCalibration_apply(const struct SensorCalibration* self, const int16_t value);
+
+#endif /* SENSORMODEL_H_ */
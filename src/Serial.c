@@ -1,5 +1,7 @@
 // Inkluderingsdirektiv:
 #include "Serial.h"
+#include <avr/pgmspace.h>
+#include <stdarg.h>
 
 // Statiska funktioner:
 static inline void write_byte(const char data);
@@ -19,13 +21,15 @@ static inline void write_byte(const char data);
  * på 115 220 kbps. För att första transmitterade utskrift skall hamna längst
  * till vänster på den första raden så transmitteras ett vagnreturstecken \r, 
  * följt av ett nolltecken \0 för att indikera att transmissionen är slutförd.
+ * Även seriell mottagning aktiveras, där avbrott sker för varje mottaget 
+ * tecken (avbrottsvektor USART_RX_vect), vilket används av konsolen.
  ******************************************************************************/
 
 void init_serial(void)
 {
 	static bool serial_initialized = false; 
 	if (serial_initialized) return;
-	UCSR0B = (1 << TXEN0);
+	UCSR0B = (1 << TXEN0) | (1 << RXEN0) | (1 << RXCIE0);
 	UCSR0C = (1 << UCSZ01) | (1 << UCSZ00);
 	UBRR0 = 103;
 	write_byte('\r');
@@ -74,7 +78,7 @@ void serial_print(const char* s)
 {
 	char text[SIZE];
 	text[0] = '\0'; 
-	sprintf(text, s, number); 
+	sprintf(text, s, (long)number); 
 	serial_print(text); 
 	return;
 }
@@ -95,11 +99,109 @@ void serial_print_unsigned(const char* s, const uint32_t number)
 {	
 	char text[SIZE]; 
 	text[0] = '\0';
-	sprintf(text, s, number);
+	sprintf(text, s, (unsigned long)number);
 	serial_print(text);
 	return;
 }
 
+/******************************************************************************
+* Funktionen serial_print_P används för att transmittera ett textstycke som
+* lagras i flashminnet. Ingående argument s utgör en pekare till textstycket
+* i flashminnet, där varje tecken läses via pgm_read_byte. I övrigt sker
+* transmissionen på samma sätt som för funktionen serial_print.
+******************************************************************************/
+
+void serial_print_P(const char* s)
+{
+	char c;
+
+	while ((c = (char)pgm_read_byte(s++)) != '\0')
+	{
+		write_byte(c);
+		if (c == '\n')
+			write_byte('\r');
+	}
+	write_byte('\0');
+	return;
+}
+
+/******************************************************************************
+* Funktionen serial_printf_P används för att sammansätta ett textstycke med
+* ett valfritt antal argument enligt en formatsträng lagrad i flashminnet.
+* Om formatsträngen saknar formatspecifikationer transmitteras den direkt
+* via serial_print_P, oavsett längd. Annars sammansätts textstycket i en
+* sträng som rymmer SIZE tecken via vsnprintf_P, där längre text kortas av,
+* följt av transmission via serial_print.
+******************************************************************************/
+
+void serial_printf_P(const char* format, ...)
+{
+	if (!strchr_P(format, '%'))
+	{
+		serial_print_P(format);
+		return;
+	}
+
+	char text[SIZE];
+	va_list arguments;
+	va_start(arguments, format);
+	vsnprintf_P(text, SIZE, format, arguments);
+	va_end(arguments);
+	serial_print(text);
+	return;
+}
+
+/******************************************************************************
+* Funktionen serial_ready returnerar true när dataregistret UDR0 är tomt,
+* det vill säga när nästa tecken kan skrivas utan väntan.
+******************************************************************************/
+
+bool serial_ready(void)
+{
+	return (UCSR0A & (1 << UDRE0)) ? true : false;
+}
+
+/******************************************************************************
+* Funktionen SerialWriter_start förbereder transmission av textstycket text,
+* vilket sedan sker via upprepade anrop av SerialWriter_run.
+******************************************************************************/
+
+void SerialWriter_start(struct SerialWriter* self, const char* text)
+{
+	PT_INIT(&self->pt);
+	self->text = text;
+	self->index = 0x00;
+	return;
+}
+
+/******************************************************************************
+* Funktionen SerialWriter_run transmitterar textstycket på samma sätt som
+* serial_print, men i stället för att vänta in dataregistret UDR0 returneras
+* PT_WAITING, varefter transmissionen fortsätter vid nästa anrop. När
+* samtliga tecken har skrivits returneras PT_ENDED.
+******************************************************************************/
+
+ProtothreadState SerialWriter_run(struct SerialWriter* self)
+{
+	PT_BEGIN(&self->pt);
+
+	for (; self->text[self->index] != '\0'; self->index++)
+	{
+		PT_WAIT_UNTIL(&self->pt, serial_ready());
+		UDR0 = self->text[self->index];
+
+		if (self->text[self->index] == '\n')
+		{
+			PT_WAIT_UNTIL(&self->pt, serial_ready());
+			UDR0 = '\r';
+		}
+	}
+
+	PT_WAIT_UNTIL(&self->pt, serial_ready());
+	UDR0 = '\0';
+	PT_END(&self->pt);
+}
+
 /******************************************************************************
 * Funktionen write_byte används för att transmittera en byte, vilket motsvarar
 * ett tecken. Ingående argument data utgörs av aktuellt tecken som skall
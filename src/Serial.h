@@ -4,10 +4,13 @@
 
 // Inkluderingsdirektiv:
 #include "definitions.h"
+#include "Protothread.h"
 
 /******************************************************************************
 * För att aktivera seriell transmission så ettställs biten TXEN0 i 
-* kontrollregistret UCSR0B (USART Control and  Status Register 0B). 
+* kontrollregistret UCSR0B (USART Control and  Status Register 0B). För att
+* aktivera seriell mottagning med avbrott för varje mottaget tecken så
+* ettställs även bitarna RXEN0 samt RXCIE0 i samma register.
 * 
 * För att sätta bithastigheten / Baud Rate för seriell överföring till 9600 
 * kbps (kilobits per second), så skrivs talet 103 till registret UBBR0 
@@ -34,8 +37,21 @@
 * Vid behov av att deklarera en sträng, vilket sker då text skall sammansättas
 * med ett heltal, så används makrot SIZE för att sätta strängens kapacitet
 * till 50 tecken (inklusive nolltecken).
+*
+* Funktionerna serial_print_P samt serial_printf_P motsvarar serial_print
+* respektive printf, men läser textstycket respektive formatsträngen från
+* flashminnet (se PSTR i avr/pgmspace.h), så att texten inte upptar RAM.
+* Dessa används av loggmakrona i Log.h.
+*
+* Samtliga funktioner ovan väntar in varje tecken, vilket vid 9600 kbps tar
+* cirka 1 ms per tecken. Som alternativ transmitteras ett textstycke utan
+* väntan via strukten SerialWriter, som utgör en protothread (se
+* Protothread.h) där varje tecken skrivs först när dataregistret UDR0 är
+* tomt (se serial_ready). Textstycket måste behållas oförändrat tills
+* transmissionen är slutförd.
 ******************************************************************************/
 #define ENABLE_SERIAL_TRANSMISSION UCSR0B = (1 << TXEN0) 
+#define ENABLE_SERIAL_RECEPTION UCSR0B |= (1 << RXEN0) | (1 << RXCIE0)
 #define SET_BAUD_RATE_TO_9600_KBPS UBRR0 = 103                                        // 9600 kbps.
 #define SET_TRANSMISSION_SIZE_TO_8_BITS UCSR0C = (1 << UCSZ01) | (1 << UCSZ00)        // Bitar per paket.
 #define WAIT_FOR_PREVIOUS_TRANSMISSION_TO_FINISH while ((UCSR0A & (1 << UDRE0)) == 0) // Väntar på föregående transmission.
@@ -43,10 +59,26 @@
 #define END_TRANSMISSION write_byte('\0') 
 #define SIZE 50 
 
+/******************************************************************************
+* Strukten SerialWriter lagrar tillståndet för transmission av ett
+* textstycke utan väntan.
+******************************************************************************/
+struct SerialWriter
+{
+	struct Protothread pt;	// Protothreadens tillstånd.
+	const char* text;	// Textstycket som transmitteras.
+	uint8_t index;		// Index för nästa tecken.
+};
+
 // Funktionsdeklarationer:
 void init_serial(void); 
 void serial_print(const char* s); 
 void serial_print_integer(const char* s, const int32_t number); 
 void serial_print_unsigned(const char* s, const uint32_t number); 
+void serial_print_P(const char* s);
+void serial_printf_P(const char* format, ...);
+bool serial_ready(void);
+void SerialWriter_start(struct SerialWriter* self, const char* text);
+ProtothreadState SerialWriter_run(struct SerialWriter* self);
 
 #endif /* SERIAL_H_ */
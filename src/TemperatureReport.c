@@ -0,0 +1,145 @@
+// Inkluderingsdirektiv:
+#include "TemperatureReport.h"
+#include <string.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+
+// Statiska funktioner:
+static bool should_report(struct TemperatureReport* self);
+
+/******************************************************************************
+* Funktionen new_TemperatureReport skapar en temperaturavläsning för en
+* given sensor, där callbackfunktionen measured anropas efter varje
+* avläsning (0 om ingen callbackfunktion används).
+******************************************************************************/
+struct TemperatureReport new_TemperatureReport(const struct TempSensor* sensor, void (*measured)(const int16_t temperature))
+{
+	struct TemperatureReport self;
+	PT_INIT(&self.pt);
+	self.sensor = sensor;
+	self.measured = measured;
+	self.requests = 0x00;
+	self.temperature = 0x00;
+	self.on_change = false;
+	self.hysteresis = 0x00;
+	self.heartbeat = 0x00;
+	self.reported = false;
+	self.reported_temperature = 0x00;
+	self.reported_time = 0x00;
+	self.suppressed = 0x00;
+	self.text[0] = '\0';
+	return self;
+}
+
+/******************************************************************************
+* Funktionen TemperatureReport_request begär en avläsning, vilken utförs
+* från huvudloopen. Antalet begärda avläsningar begränsas till 255.
+* Funktionen kan anropas från avbrottsrutiner.
+******************************************************************************/
+void TemperatureReport_request(struct TemperatureReport* self)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if (self->requests < UINT8_MAX) self->requests++;
+	}
+
+	return;
+}
+
+/******************************************************************************
+* Funktionen TemperatureReport_run anropas från programmets huvudloop och
+* fortsätter förloppet där det senast avbröts. Funktionen returnerar
+* PT_WAITING så länge förloppet väntar, exempelvis på AD-omvandlaren eller
+* dataregistret UDR0, och PT_ENDED när en avläsning har slutförts.
+* Vid utskrift enbart vid ändring hoppas transmissionen över för
+* avläsningar som inte skall skrivas ut (se should_report), medan övriga
+* avläsningar skrivs ut tillsammans med antalet undertryckta avläsningar.
+******************************************************************************/
+ProtothreadState TemperatureReport_run(struct TemperatureReport* self)
+{
+	PT_BEGIN(&self->pt);
+	PT_WAIT_UNTIL(&self->pt, self->requests);
+
+	ADC_start(self->sensor->PIN);
+	PT_WAIT_UNTIL(&self->pt, ADC_ready());
+	self->temperature = TempSensor_convert(self->sensor, ADC_result());
+
+	if (should_report(self))
+	{
+		TempSensor_format(self->temperature, self->text);
+
+		if (self->on_change)
+		{
+			const size_t length = strlen(self->text) - 1;
+			snprintf_P(self->text + length, SIZE - length, PSTR(", %u skipped\n"), self->suppressed);
+			self->suppressed = 0x00;
+		}
+
+		SerialWriter_start(&self->writer, self->text);
+		PT_WAIT_THREAD(&self->pt, SerialWriter_run(&self->writer));
+	}
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		self->requests--;
+	}
+
+	if (self->measured) self->measured(self->temperature);
+	PT_END(&self->pt);
+}
+
+/******************************************************************************
+* Funktionen TemperatureReport_set_change aktiverar utskrift enbart vid
+* ändring, där hysteresis utgör minsta ändring mätt i tiondels grader och
+* heartbeat längsta tid utan utskrift mätt i sekunder (0 för ingen
+* begränsning). Nästa avläsning skrivs alltid ut.
+******************************************************************************/
+void TemperatureReport_set_change(struct TemperatureReport* self, const uint8_t hysteresis, const uint16_t heartbeat)
+{
+	self->on_change = true;
+	self->hysteresis = hysteresis;
+	self->heartbeat = heartbeat;
+	self->reported = false;
+	self->suppressed = 0x00;
+	return;
+}
+
+/******************************************************************************
+* Funktionen TemperatureReport_set_all återställer utskrift av samtliga
+* avläsningar.
+******************************************************************************/
+void TemperatureReport_set_all(struct TemperatureReport* self)
+{
+	self->on_change = false;
+	self->suppressed = 0x00;
+	return;
+}
+
+/******************************************************************************
+* Funktionen should_report avgör om senaste avläsning skall skrivas ut.
+* Samtliga avläsningar skrivs ut om utskrift enbart vid ändring inte är
+* aktiverad. Annars skrivs avläsningen ut om ingen avläsning har skrivits
+* ut tidigare, om ändringen från senast utskrivna temperatur överstiger
+* hysteresen, eller om heartbeat sekunder har förflutit sedan senaste
+* utskrift. I dessa fall lagras avläsningen som senast utskriven, annars
+* räknas den som undertryckt.
+******************************************************************************/
+static bool should_report(struct TemperatureReport* self)
+{
+	if (!self->on_change) return true;
+
+	const uint32_t now = Clock_seconds();
+	const int16_t change = self->temperature - self->reported_temperature;
+
+	if (self->reported && (change < 0 ? -change : change) <= self->hysteresis &&
+		(!self->heartbeat || now - self->reported_time < self->heartbeat))
+	{
+		if (self->suppressed < UINT16_MAX) self->suppressed++;
+		return false;
+	}
+
+	self->reported = true;
+	self->reported_temperature = self->temperature;
+	self->reported_time = now;
+	return true;
+}
@@ -0,0 +1,63 @@
+
+#ifndef TEMPERATUREREPORT_H_
+#define TEMPERATUREREPORT_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+#include "ADC.h"
+#include "Protothread.h"
+#include "Serial.h"
+#include "Clock.h"
+
+/******************************************************************************
+* Strukten TemperatureReport implementerar en temperaturavläsning som en
+* protothread (se Protothread.h), där AD-omvandling och utskrift sker utan
+* väntan. Avläsningar begärs via TemperatureReport_request, exempelvis
+* från avbrottsrutiner, medan förloppet exekveras från huvudloopen via
+* TemperatureReport_run:
+*
+* 1. Vänta tills en avläsning har begärts.
+* 2. Starta AD-omvandlingen och vänta tills den är slutförd.
+* 3. Sammansätt textstycket och transmittera det via SerialWriter.
+* 4. Anropa callbackfunktionen measured med avläst temperatur, mätt i
+*    tiondels grader Celcius, exempelvis för lagring i historiken.
+*
+* Begärda avläsningar räknas, så att varje begäran ger en avläsning även
+* om flera begärs innan föregående avläsning är slutförd. Därmed blockeras
+* avbrottsrutinerna inte längre av AD-omvandling och seriell transmission.
+*
+* Som standard skrivs varje avläsning ut. Via TemperatureReport_set_change
+* kan utskrift i stället ske enbart vid ändring: en avläsning skrivs ut
+* först när den skiljer sig från senast utskrivna värde med mer än
+* hysteresis tiondels grader, alternativt när heartbeat sekunder har
+* förflutit sedan senaste utskrift. Antalet undertryckta avläsningar sedan
+* föregående utskrift skrivs ut på samma rad, så att datamängden styrs av
+* hur mycket temperaturen ändras snarare än av hur ofta den mäts av.
+* Callbackfunktionen measured anropas för samtliga avläsningar.
+******************************************************************************/
+struct TemperatureReport
+{
+	struct Protothread pt;				// Protothreadens tillstånd.
+	const struct TempSensor* sensor;		// Temperatursensor som läses av.
+	void (*measured)(const int16_t temperature);	// Anropas efter varje avläsning.
+	volatile uint8_t requests;			// Antal begärda avläsningar som återstår.
+	int16_t temperature;				// Senast avläst temperatur.
+	bool on_change;					// Indikerar utskrift enbart vid ändring.
+	uint8_t hysteresis;				// Minsta ändring för utskrift, mätt i tiondels grader.
+	uint16_t heartbeat;				// Längsta tid utan utskrift mätt i sekunder.
+	bool reported;					// Indikerar att en avläsning har skrivits ut.
+	int16_t reported_temperature;			// Senast utskrivna temperatur.
+	uint32_t reported_time;				// Tidpunkt för senaste utskrift mätt i sekunder.
+	uint16_t suppressed;				// Antal undertryckta avläsningar sedan senaste utskrift.
+	char text[SIZE];				// Textstycket som transmitteras.
+	struct SerialWriter writer;			// Transmission av textstycket.
+};
+
+// Funktionsdeklarationer:
+struct TemperatureReport new_TemperatureReport(const struct TempSensor* sensor, void (*measured)(const int16_t temperature));
+void TemperatureReport_request(struct TemperatureReport* self);
+ProtothreadState TemperatureReport_run(struct TemperatureReport* self);
+void TemperatureReport_set_change(struct TemperatureReport* self, const uint8_t hysteresis, const uint16_t heartbeat);
+void TemperatureReport_set_all(struct TemperatureReport* self);
+
+#endif /* TEMPERATUREREPORT_H_ */
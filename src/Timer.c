@@ -1,8 +1,118 @@
 // Inkluderingsdirektiv:
 #include "Timer.h"
+#include <avr/pgmspace.h>
 
-static void init_timer(const TimerSelection timerSelection);
-static inline uint32_t get_required_interrupts(const double delay_time);
+// Statiska funktioner:
+static void init_timer(const struct TimerDescriptor* descriptor);
+static void set_interrupt(const TimerSelection timerSelection, const bool enabled);
+static inline uint32_t get_required_interrupts(const struct Timer* self, const double delay_time);
+
+/******************************************************************************
+* Tabellen descriptors beskriver timerkretsar Timer 0 - 2, indexerad via
+* TimerSelection, och lagras i flashminnet. Registeradresserna utgörs av
+* adresser i dataminnet (motsvarande _SFR_MEM_ADDR), vilka anges numeriskt
+* så att tabellen kan initieras vid kompilering.
+*
+* Prescaleralternativen för bitarna CSn0 - CSn2 (1 - 5 respektive 1 - 7)
+* lagras i tabellerna prescalers samt timer2_prescalers, där Timer 2 har
+* fler alternativ än Timer 0 samt Timer 1. Beskrivningen av Timer 2
+* motsvarar klockans konfiguration (se Clock.h), eftersom Timer 2 inte
+* initieras här.
+******************************************************************************/
+static const struct TimerDescriptor descriptors[] PROGMEM =
+{
+	{	// Timer 0: Normal Mode, overflow efter 256 uppräkningar.
+		.TCCRA = 0x44, .TCCRB = 0x45, .TCNT = 0x46, .OCRA = 0x47, .OCRB = 0x48,
+		.TIMSK = 0x6E, .TIFR = 0x35,
+		.overflow_bit = (1 << TOIE0), .compare_A_bit = (1 << OCIE0A),
+		.compare_B_bit = (1 << OCIE0B), .capture_bit = 0x00,
+		.mode_mask_A = (1 << WGM01) | (1 << WGM00), .mode_mask_B = (1 << WGM02),
+		.CTC_mode_A = (1 << WGM01), .CTC_mode_B = 0x00,
+		.timer2_prescalers = false, .wide = false,
+		.interrupt_bit = (1 << TOIE0), .CTC = false, .prescaler = 1, .top = 0xFF
+	},
+
+	{	// Timer 1: CTC Mode med prescaler 8 och maxvärde 65535 i OCR1A, avbrott var 32.768:e ms.
+		.TCCRA = 0x80, .TCCRB = 0x81, .TCNT = 0x84, .OCRA = 0x88, .OCRB = 0x8A,
+		.TIMSK = 0x6F, .TIFR = 0x36,
+		.overflow_bit = (1 << TOIE1), .compare_A_bit = (1 << OCIE1A),
+		.compare_B_bit = (1 << OCIE1B), .capture_bit = (1 << ICIE1),
+		.mode_mask_A = (1 << WGM11) | (1 << WGM10), .mode_mask_B = (1 << WGM13) | (1 << WGM12),
+		.CTC_mode_A = 0x00, .CTC_mode_B = (1 << WGM12),
+		.timer2_prescalers = false, .wide = true,
+		.interrupt_bit = (1 << OCIE1A), .CTC = true, .prescaler = TIMER1_PRESCALER, .top = TIMER1_TOP
+	},
+
+	{	// Timer 2: Normal Mode med prescaler 64, konfigureras av klockan (se Clock.h).
+		.TCCRA = 0xB0, .TCCRB = 0xB1, .TCNT = 0xB2, .OCRA = 0xB3, .OCRB = 0xB4,
+		.TIMSK = 0x70, .TIFR = 0x37,
+		.overflow_bit = (1 << TOIE2), .compare_A_bit = (1 << OCIE2A),
+		.compare_B_bit = (1 << OCIE2B), .capture_bit = 0x00,
+		.mode_mask_A = (1 << WGM21) | (1 << WGM20), .mode_mask_B = (1 << WGM22),
+		.CTC_mode_A = (1 << WGM21), .CTC_mode_B = 0x00,
+		.timer2_prescalers = true, .wide = false,
+		.interrupt_bit = (1 << TOIE2), .CTC = false, .prescaler = 64, .top = 0xFF
+	}
+};
+
+static const uint16_t prescalers[] PROGMEM = { 1, 8, 64, 256, 1024 };
+static const uint16_t timer2_prescalers[] PROGMEM = { 1, 8, 32, 64, 128, 256, 1024 };
+
+/******************************************************************************
+* Funktionen TimerDescriptor_get kopierar beskrivningen av en given
+* timerkrets från flashminnet till angiven strukt.
+******************************************************************************/
+void TimerDescriptor_get(const TimerSelection timerSelection, struct TimerDescriptor* descriptor)
+{
+	memcpy_P(descriptor, &descriptors[timerSelection], sizeof(struct TimerDescriptor));
+	return;
+}
+
+/******************************************************************************
+* Funktionen TimerDescriptor_clock_select returnerar värdet på bitarna
+* CSn0 - CSn2 för en given prescaler, eller 0 (timern stoppad) ifall
+* prescalern inte stöds av aktuell timerkrets.
+******************************************************************************/
+uint8_t TimerDescriptor_clock_select(const struct TimerDescriptor* self, const uint16_t prescaler)
+{
+	const uint16_t* table = self->timer2_prescalers ? timer2_prescalers : prescalers;
+	const uint8_t options = self->timer2_prescalers ? sizeof(timer2_prescalers) / sizeof(uint16_t) :
+		sizeof(prescalers) / sizeof(uint16_t);
+
+	for (uint8_t i = 0; i < options; i++)
+	{
+		if (pgm_read_word(&table[i]) == prescaler) return i + 1;
+	}
+
+	return 0x00;
+}
+
+/******************************************************************************
+* Funktionen TimerDescriptor_prescaler returnerar aktuell prescaler för en
+* given timerkrets, avläst från bitarna CSn0 - CSn2 i kontrollregister B,
+* eller 0 ifall timern är stoppad alternativt klockas externt.
+******************************************************************************/
+uint16_t TimerDescriptor_prescaler(const struct TimerDescriptor* self)
+{
+	const uint16_t* table = self->timer2_prescalers ? timer2_prescalers : prescalers;
+	const uint8_t options = self->timer2_prescalers ? sizeof(timer2_prescalers) / sizeof(uint16_t) :
+		sizeof(prescalers) / sizeof(uint16_t);
+	const uint8_t clock_select = TIMER_REGISTER(self->TCCRB) & TIMER_CLOCK_SELECT_MASK;
+
+	if (!clock_select || clock_select > options) return 0x00;
+	return pgm_read_word(&table[clock_select - 1]);
+}
+
+/******************************************************************************
+* Funktionen TimerDescriptor_interrupt_time returnerar tiden mellan avbrott
+* mätt i millisekunder för en given timerkrets, beräknad som
+* prescaler * (top + 1) / F_CPU, exempelvis 8 * 65 536 / 16 MHz = 32.768 ms
+* för Timer 1.
+******************************************************************************/
+float TimerDescriptor_interrupt_time(const struct TimerDescriptor* self)
+{
+	return self->prescaler * (self->top + 1.0f) * 1000.0f / F_CPU;
+}
 
 /******************************************************************************
 * Funktionen new_Timer används för att skapa och initiera objekt av strukten 
@@ -14,82 +124,62 @@ static inline uint32_t get_required_interrupts(const double delay_time);
 * till self. Om minnesallokeringen misslyckas returneras NULL direkt. Annars
 * initieras struktens medlemmar; enabled sätts till false för att indikera
 * att timer-kretsen är avstängd vid start, vald timerkrets sparas via 
-* medlemmen timerSelection, antalet exekverade avbrott sätts till noll vid
+* medlemmen timerSelection, tiden mellan avbrott beräknas från timerkretsens
+* beskrivning, antalet exekverade avbrott sätts till noll vid
 * start, medan antalet avbrott som krävs för specificerad fördröjningstid
 * beräknas via anrop av funktionen get_required_interrupts, där ingående 
 * argument delay_time passeras som parameter. Returvärdet från detta anrop,
 * vilket är beräknat antalet avbrott som krävs för specificerad fördröjningtid, 
 * lagras sedan via medlemmen required_interrupts. Slutligen returneras det nu 
 * initierade objektet self, som är redo att användas för implementering av 
-* en given timerkrets.
+* en given timerkrets. Timer 2 initieras inte, eftersom den används av
+* klockan (se Timer.h).
 ******************************************************************************/
 
 struct Timer new_Timer(const TimerSelection timerSelection, const double delay_time) 
 {
 	struct Timer self;
+	struct TimerDescriptor descriptor;
+	TimerDescriptor_get(timerSelection, &descriptor);
 	 
 	self.enabled = false;
 	self.timerSelection = timerSelection;
+	self.interrupt_time = TimerDescriptor_interrupt_time(&descriptor);
 	self.executed_interrupts = 0x00;
-	self.required_interrupts = get_required_interrupts(delay_time);
-	init_timer(self.timerSelection);
+	self.required_interrupts = get_required_interrupts(&self, delay_time);
+	if (timerSelection != TIMER_CLOCK) init_timer(&descriptor);
 	return self;
 }
 
 /******************************************************************************
 * Funktionen Timer_on används för att aktivera en given timer. Ingående
-* argument self utgör en pekare till ett timerobjekt, vars medlem 
-* timerSelection undersöks för att ta reda på vilken timerkrets som skall
-* aktiveras. Aktuell timerkrets aktiveras, följt av att medlemmen enabled 
-* sätts till true för att indikera att timern i fråga nu är aktiverad.
+* argument self utgör en pekare till ett timerobjekt, vars timerkrets
+* aktiveras genom att timerns avbrottsbit (enligt tabellen descriptors)
+* ettställs i maskregistret, följt av att medlemmen enabled sätts till true
+* för att indikera att timern i fråga nu är aktiverad. Anropet ignoreras
+* för Timer 2, vars overflow-avbrott används av klockan.
 ******************************************************************************/
 
 void Timer_on(struct Timer* self) 
 {
-	if (self->timerSelection == TIMER0)
-	{
-		TIMSK0 = (1 << TOIE0);
-	}
-	
-	else if (self->timerSelection == TIMER1)
-	{
-		TIMSK1 = (1 << OCIE1A);
-	}
-	
-	else if (self->timerSelection == TIMER2)
-	{
-		TIMSK2 = (1 << TOIE2);
-	}
-	
+	if (self->timerSelection == TIMER_CLOCK) return;
+	set_interrupt(self->timerSelection, true);
 	self->enabled = true;
 	return;
 }
 
 /******************************************************************************
 * Funktionen Timer_off används för att inaktivera en given timer. Ingående
-* argument self utgör en pekare till ett timerobjekt, vars medlem
-* timerSelection undersöks för att ta reda på vilken timerkrets som skall
-* inaktiveras. Aktuell timerkrets inaktiveras, följt av att medlemmen enabled
-* sätts till false för att indikera att timern i fråga nu är inaktiverad.
+* argument self utgör en pekare till ett timerobjekt, vars timerkrets
+* inaktiveras genom att timerns avbrottsbit i maskregistret nollställs,
+* följt av att medlemmen enabled sätts till false för att indikera att
+* timern i fråga nu är inaktiverad. Övriga bitar i maskregistret påverkas
+* inte.
 ******************************************************************************/
 
- void Timer_off(struct Timer* self)
+void Timer_off(struct Timer* self)
 {
-	if (self->timerSelection == TIMER0)
-	{
-		TIMSK0 = 0x00;
-	}
-	
-	else if (self->timerSelection == TIMER1)
-	{
-		TIMSK1 = 0x00;
-	}
-	
-	else if (self->timerSelection == TIMER2)
-	{
-		TIMSK2 = 0x00;
-	}
-	
+	set_interrupt(self->timerSelection, false);
 	self->enabled = false;
 	return;
 }
@@ -171,7 +261,7 @@ bool Timer_elapsed(struct Timer* self)
 
 void Timer_clear(struct Timer* self)
 {
-	self->executed_interrupts = 0x00;
+	Atomic_store32(&self->executed_interrupts, 0x00);
 	return;
 }
 
@@ -187,7 +277,7 @@ void Timer_clear(struct Timer* self)
 void Timer_reset(struct Timer* self) 
 {
 	Timer_off(self);
-	self->executed_interrupts = 0x00;
+	Atomic_store32(&self->executed_interrupts, 0x00);
 	return;
 }
 
@@ -202,51 +292,105 @@ void Timer_reset(struct Timer* self)
 
 void Timer_set(struct Timer* self, const double delay_time) 
 {
-	self->required_interrupts = get_required_interrupts(delay_time);
+	Atomic_store32(&self->required_interrupts, get_required_interrupts(self, delay_time));
 	return;
 }
 
 /******************************************************************************
-* Funktionen init_timer används för att initiera en given timerkrets för en
-* uppräkningstid där ett avbrott sker var 0.016:e millisekund vid uppräkning
-* till 256, då overflow- eller CTC-avbrott sker, beroende på använd timerkrets. 
-* Ingående argument timerSelection indikerar vilken timer som skall initieras.
+* Funktionerna Timer_executed samt Timer_required returnerar antalet
+* exekverade respektive erforderliga avbrott för en given timer. Värdena
+* läses atomärt, så att de kan läsas utanför avbrottsrutiner utan risk att
+* ett avbrott uppdaterar dem mitt i läsningen.
+******************************************************************************/
+
+uint32_t Timer_executed(const struct Timer* self)
+{
+	return Atomic_load32(&self->executed_interrupts);
+}
+
+uint32_t Timer_required(const struct Timer* self)
+{
+	return Atomic_load32(&self->required_interrupts);
+}
+
+/******************************************************************************
+* Funktionen init_timer används för att initiera en given timerkrets, där
+* overflow-avbrott sker var 0.016:e millisekund för Timer 0 och CTC-avbrott
+* var 32.768:e millisekund för Timer 1 (se Timer.h). Ingående argument
+* descriptor utgör beskrivningen av timerkretsen som skall initieras.
 *
 * Först aktiveras avbrott globalt via ettställning av I-flaggan i statusregistret
 * SREG. Denna bit måste alltid vara ettställd för att timergenererade avbrott
-* skall kunna implementeras. Sedan initeras aktuell timerkrets, där de 8-bitars 
-* timerkretsarna Timer 0 samt Timer 2 initieras i Normal Mode, vilket innebär 
+* skall kunna implementeras. Sedan hämtas timerkretsens beskrivning från
+* tabellen descriptors, varefter bitarna för waveform generation mode samt
+* prescaler uppdateras i kontrollregistren via read-modify-write, så att
+* övriga bitar (exempelvis för compare-utgångar) lämnas orörda. Den 8-bitars
+* timerkretsen Timer 0 initieras i Normal Mode, vilket innebär 
 * uppräkning tills overflow sker (efter uppräkning till 256, som inte ryms i 
 * 8-bitars register).
 * 
 * För den 16-bitars timerkretsen Timer 1 används CTC Mode (Clear Timer On 
-* Compare), där maxvärdet för uppräkning sätts till 256 för att matcha de
-* andra två timerkretsarna, så att avbrott sker lika ofta för respektive 
-* timer. Eftersom Timer 1 vid uppräkning till 256 är långt från full används
-* därmed CTC Mode, där timern nollställs automatiskt vid uppräkning till
-* förvalt maxvärde, vilket i detta fall är 256.
+* Compare) med prescaler 8, där maxvärdet för uppräkning sätts till 65535 i
+* OCR1A, så att timern räknar 65 536 steg per period. CTC Mode används så
+* att compare-kanal B kan schemaläggas mot samma maxvärde (se
+* TimerChannel.h), där timern nollställs automatiskt vid uppräkning till
+* förvalt maxvärde.
 ******************************************************************************/
 
-static void init_timer(const TimerSelection timerSelection) 
+static void init_timer(const struct TimerDescriptor* descriptor) 
 {
-	asm("SEI"); 
-	
-	if (timerSelection == TIMER0) 
-	{
-		TCCR0B = (1 << CS00); 
-	}
-	
-	else if (timerSelection == TIMER1)
+	const uint8_t mode_A = descriptor->CTC ? descriptor->CTC_mode_A : 0x00;
+	const uint8_t mode_B = descriptor->CTC ? descriptor->CTC_mode_B : 0x00;
+	const uint8_t clock_select = TimerDescriptor_clock_select(descriptor, descriptor->prescaler);
+
+	ENABLE_INTERRUPTS;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
 	{
-		TCCR1B = (1 << WGM11);
-		OCR1A = 256;
+		if (descriptor->CTC && descriptor->wide)
+		{
+			TIMER_REGISTER16(descriptor->OCRA) = descriptor->top;
+		}
+
+		else if (descriptor->CTC)
+		{
+			TIMER_REGISTER(descriptor->OCRA) = (uint8_t)descriptor->top;
+		}
+
+		TIMER_REGISTER(descriptor->TCCRA) = (TIMER_REGISTER(descriptor->TCCRA) & ~descriptor->mode_mask_A) | mode_A;
+		TIMER_REGISTER(descriptor->TCCRB) = (TIMER_REGISTER(descriptor->TCCRB) & 
+			~(descriptor->mode_mask_B | TIMER_CLOCK_SELECT_MASK)) | mode_B | clock_select;
 	}
-	
-	else if (timerSelection == TIMER2)
+
+	return;
+}
+
+/******************************************************************************
+* Funktionen set_interrupt ettställer alternativt nollställer timerns
+* avbrottsbit i maskregistret för en given timerkrets. Övriga bitar i
+* registret lämnas orörda, så att andra avbrottskällor på samma timerkrets
+* (exempelvis compare-kanal B) inte påverkas. Uppdateringen sker atomärt,
+* eftersom en avbrottsrutin kan ändra samma register under tiden.
+******************************************************************************/
+
+static void set_interrupt(const TimerSelection timerSelection, const bool enabled)
+{
+	const uint8_t TIMSK = pgm_read_byte(&descriptors[timerSelection].TIMSK);
+	const uint8_t bit = pgm_read_byte(&descriptors[timerSelection].interrupt_bit);
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
 	{
-		TCCR2B = (1 << CS20); 
+		if (enabled)
+		{
+			TIMER_REGISTER(TIMSK) |= bit;
+		}
+
+		else
+		{
+			TIMER_REGISTER(TIMSK) &= ~bit;
+		}
 	}
-	
+
 	return;
 }
 
@@ -255,13 +399,13 @@ static void init_timer(const TimerSelection timerSelection)
 * avbrott som krävs för en given fördröjningstid. Ingående argument delay_time
 * utgörs av specificerad fördröjningstid mätt i millisekunder. Antalet avbrott
 * som krävs för aktuell fördröjning beräknas som kvoten av specificerad 
-* fördröjningstid genom tiden mellan varje avbrott, vilket i detta fall är
-* satt till 0.016 ms, här implementerat via makrot INTERRUPT_TIME. Antalet
+* fördröjningstid genom tiden mellan varje avbrott för timerns timerkrets,
+* lagrad i medlemmen interrupt_time (32.768 ms för Timer 1). Antalet
 * avbrott som krävs för specificerad fördröjningstid avrundas till närmaste
 * heltal via anrop av funktionen round_to_integer och returneras sedan.
 ******************************************************************************/
 
-static inline uint32_t get_required_interrupts(const double delay_time)
+static inline uint32_t get_required_interrupts(const struct Timer* self, const double delay_time)
 {
-	return (uint32_t)(delay_time / INTERRUPT_TIME + 0.5);
+	return (uint32_t)(delay_time / self->interrupt_time + 0.5);
 }
@@ -4,98 +4,124 @@
 
 // Inkluderingsdirektiv:
 #include "definitions.h"
+#include "Atomic.h"
 
 /******************************************************************************
-* Vid initiering sätts timerkretsar Timer 0 - 2 till att räkna upp utan
-* prescaler, vilket innebär en uppräkningsfrekvens på 16 MHz, som motsvarar en
-* uppräkningshastighet på 62.5 us. Därmed tar det 256 * 62.5u = 0.016 ms mellan
-* varje timergenererat avbrott för en given timer när denna är aktiverad, då
-* samtliga timerkretsar sätts till att räkna upp till 256, då avbrott sker och
-* timerkretsen nollställs (automatiskt för Timer 0 samt Timer 2, då overflow
-* sker för dessa 8-bitars timerkretsar, medan Timer 1 i stället nollställs av 
-* hårdvaran i CTC Mode, då denna uppgår till 16-bitar och därmed är långt från
-* full vid uppräkning till 256).
+* Vid initiering sätts de 8-bitars timerkretsarna Timer 0 samt Timer 2 till
+* att räkna upp utan prescaler, vilket innebär en uppräkningsfrekvens på
+* 16 MHz, som motsvarar en uppräkningshastighet på 62.5 ns. Därmed tar det
+* 256 * 62.5n = 0.016 ms mellan varje overflow-avbrott.
 *
-* För att initiera timerkrets Timer 0 utan prescaler i Normal Mode så ettställs
-* biten CS00 (Clock Select 0 bit 0) i kontrollregistret TCCR0B (Timer/Counter
-* Control Register 0B). Därmed sätts uppräkningsfrekvensen till 16 MHz. 
+* Timer 1, som driver den dynamiska timern, räknar i stället upp med
+* prescaler 8 (0.5 us per uppräkning) genom samtliga 65 536 steg, vilket
+* medför ett avbrott var 65536 * 0.5u = 32.768:e millisekund. Detta
+* motsvarar ursprunglig hårdvarukonfiguration, där avbrottstiden felaktigt
+* angavs till 0.016 ms, och gör att avbrottsrutinen TIMER1_COMPA_vect
+* exekverar cirka 30 gånger per sekund i stället för 62 500 gånger per
+* sekund. Upplösningen om 32.768 ms räcker gott för fördröjningstider mätt
+* i sekunder.
 *
-* För att initiera timerkrets Timer 1 utan prescaler i CTC Mode, så att avbrott 
-* sker vid ett lägre värde än när overflow sker, vilket annars sker vid 
-* uppräkning till 65 536 för en 16-bitars räknare, så ettställs bitar CS10 
-* (Clock Select 1 bit 0) samt WGM11 (Waveform Generator Mode 1 bit 1) i 
-* kontrollregistret TCCR1B (Timer/Counter Control Register 1B). CS10 används 
-* för att ställa in uppräkningsfrekvensen utan prescaler (16 MHz), medan WGM12 
-* används för att Timer 1 skall arbeta i CTC Mode i stället för Normal Mode.
-* För att ställa in att timergenererat avbrott skall ske på Timer 1 vid 
-* uppräkning till 256, såsom övriga timerkretsar, så skrivs detta heltal till
-* registret OCR1A (Output Compare Register 1A). Vid uppräkning till 256 sker
-* då ett CTC-avbrott och Timer 1 nollställs av hårdvaran. Detta måste göras
-* vid initiering av Timer 1.
+* Registeradresser, avbrottsbitar, bitar för waveform generation mode samt
+* prescaleralternativ för respektive timerkrets lagras i en tabell av typen
+* TimerDescriptor i flashminnet (se Timer.c), så att samtliga timerkretsar
+* hanteras via samma kod. Vid skrivning till kontroll- och maskregister
+* uppdateras enbart de bitar som timern äger (read-modify-write), så att
+* exempelvis timerns compare-kanal B eller input capture kan användas
+* samtidigt av andra moduler:
 *
-* För att initiera timerkrets Timer 2 utan prescaler i Normal Mode så ettställs
-* biten CS20 (Clock Select 2 bit 0) i kontrollregistret TCCR2B (Timer/Counter
-* Control Register 2B). Därmed sätts uppräkningsfrekvensen till 16 MHz, precis
-* som för Timer 0. Dessa register uppgår båda till 8-bitar, vilket alltså
-* medför overflow vid uppräkning till 256.
+* - Timer 0 initieras i Normal Mode via biten CS00 (ingen prescaler) i
+*   kontrollregistret TCCR0B och aktiveras via biten TOIE0 i TIMSK0.
+* - Timer 1 initieras i CTC Mode via bitarna WGM12 samt CS11 (prescaler 8)
+*   i TCCR1B, där maxvärdet för uppräkning skrivs till OCR1A (65535, det
+*   vill säga 65 536 uppräkningar per period), och aktiveras via biten
+*   OCIE1A i TIMSK1.
+* - Timer 2 konfigureras i stället av klockan (se Clock.h) i Normal Mode
+*   med prescaler 64, där overflow-avbrottet TIMER2_OVF_vect räknar upp
+*   klockan. Timer 2 kan därför inte användas av strukten Timer: new_Timer
+*   lämnar timerkretsen orörd och Timer_on ignoreras, så att klockans
+*   prescaler och avbrottsrutin inte skrivs över. Timerns compare-kanaler
+*   kan dock användas via TimerChannel (se TimerChannel.h).
+*
+* Tiden mellan avbrott beräknas från tabellen som prescaler * (top + 1) /
+* F_CPU (se TimerDescriptor_interrupt_time) och lagras i respektive
+* timerobjekt, så att fördröjningstiden räknas om till antal avbrott för
+* rätt timerkrets.
 ******************************************************************************/
 
-#define INIT_TIMER0 TCCR0B = (1 << CS00) | (1 << CS02)			// Initierar Timer 0 i Normal Mode. 
-#define INIT_TIMER1 TCCR1B = (1 << CS10) | (1 << CS12) | (1 << WGM12)	// Initierar Timer 1 i CTC Mode. 
-#define INIT_TIMER2 TCCR2B = (1 << CS20)				// Initierar Timer 2 i Normal Mode. 
-
-#define SET_TIMER1_LIMIT OCR1A = 256					// CTC-avbrott för Timer 1 sker vid uppräkning till 256. 
-#define INTERRUPT_TIME 0.016f						// 0.016 ms mellan timergenererade avbrott. 
-
 /******************************************************************************
-* För att aktivera Timer 0 i Normal Mode ettställs biten TOIE0 (Timer/Counter
-* Overflow Interrupt Enable 0) i maskregistret TIMSK0 (Timer/Counter Mask
-* Register 0). För att inaktivera avbrott nollställs i stället detta register.
-* Avbrottsvektor för Timer 0 i Normal Mode är TIMER0_OVF_vect.
-* 
-* För att aktivera Timer 1 i CTC Mode så ettställs biten OCIE1A (Output Compare
-* Interrupt Enable 1A) i maskregistret TIMSK1 (Timer/Counter Mask Register 1). 
-* För att inaktivera avbrott nollställs i stället detta register.
-* Avbrottsvektor för Timer 1 i CTC Mode är TIMER1_COMPA_vect.
-* 
-* För att aktivera Timer 2 i Normal Mode ettställs biten TOIE2 (Timer/Counter
-* Overflow Interrupt Enable 2) i maskregistret TIMSK2 (Timer/Counter Mask
-* Register 2). För att inaktivera avbrott nollställs i stället detta register.
-* Avbrottsvektor för Timer 2 i Normal Mode är TIMER2_OVF_vect.
+* Strukten TimerDescriptor beskriver en timerkrets: minnesadresser för dess
+* register, bitar i maskregistret för respektive avbrottskälla, bitar för
+* waveform generation mode, vilken prescalertabell som gäller samt vilken
+* avbrottskälla och konfiguration som används av strukten Timer.
 ******************************************************************************/
+struct TimerDescriptor
+{
+	uint8_t TCCRA;			// Adress för kontrollregister A.
+	uint8_t TCCRB;			// Adress för kontrollregister B.
+	uint8_t TCNT;			// Adress för räknarregistret.
+	uint8_t OCRA;			// Adress för compare-register A.
+	uint8_t OCRB;			// Adress för compare-register B.
+	uint8_t TIMSK;			// Adress för maskregistret.
+	uint8_t TIFR;			// Adress för flaggregistret.
+	uint8_t overflow_bit;		// Maskbit för overflow-avbrott.
+	uint8_t compare_A_bit;		// Maskbit för compare match A.
+	uint8_t compare_B_bit;		// Maskbit för compare match B.
+	uint8_t capture_bit;		// Maskbit för input capture, 0 om sådan saknas.
+	uint8_t mode_mask_A;		// Bitar för waveform generation mode i kontrollregister A.
+	uint8_t mode_mask_B;		// Bitar för waveform generation mode i kontrollregister B.
+	uint8_t CTC_mode_A;		// Värde på bitarna i kontrollregister A för CTC Mode.
+	uint8_t CTC_mode_B;		// Värde på bitarna i kontrollregister B för CTC Mode.
+	bool timer2_prescalers;		// Indikerar prescaleralternativen för Timer 2.
+	bool wide;			// Indikerar 16-bitars timerkrets.
+	uint8_t interrupt_bit;		// Avbrottskälla som används av strukten Timer.
+	bool CTC;			// Indikerar att strukten Timer använder CTC Mode.
+	uint16_t prescaler;		// Prescaler som används av strukten Timer.
+	uint16_t top;			// Maxvärde för uppräkning i CTC Mode.
+};
 
-#define ENABLE_TIMER0 TIMSK0 = (1 << TOIE0)			// Aktiverar Timer 0 i Normal Mode. 
-#define ENABLE_TIMER1 TIMSK1 = (1 << OCIE1A)			// Aktiverar Timer 1 i CTC Mode. 
-#define ENABLE_TIMER2 TIMSK2 = (1 << TOIE2)			// Aktiverar Timer 2 i Normal Mode. 
+#define TIMER_CLOCK_SELECT_MASK 0x07					// Bitar CSn0 - CSn2 i kontrollregister B.
+#define TIMER_REGISTER(address) _SFR_MEM8(address)			// Åtkomst till 8-bitars register via minnesadress.
+#define TIMER_REGISTER16(address) _SFR_MEM16(address)			// Åtkomst till 16-bitars register via minnesadress.
 
-#define DISABLE_TIMER0 TIMSK0 = 0x00				// Inaktiverar Timer 0 i Normal Mode. 
-#define DISABLE_TIMER1 TIMSK1 = 0x00				// Inaktiverar Timer 1 i CTC Mode. 
-#define DISABLE_TIMER2 TIMSK2 = 0x00				// Inaktiverar Timer 2 i Normal Mode. 
+#define TIMER_CLOCK TIMER2						// Timerkrets som används av klockan (se Clock.h).
+#define TIMER1_PRESCALER 8						// Prescaler för Timer 1.
+#define TIMER1_TOP 0xFFFF						// Maxvärde för uppräkning för Timer 1.
+#define INTERRUPT_TIME (TIMER1_PRESCALER * (TIMER1_TOP + 1.0f) * 1000.0f / F_CPU)	// 32.768 ms mellan avbrott för Timer 1 (se ovan).
 
 /******************************************************************************
 * Strukten Timer används för att implementera mikrodatorns timerkretsar via
 * timerobjekt. Mikrodatorns tre timerkretsar Timer 0 - 2 kan användas med
-* valbar fördröjningstid. Samtliga timerkretsar räknar upp till 256 innan
-* timergenererat avbrott sker, vilket medför avbrott var 1.024:e millisekund 
-* för en given timer när denna är aktiverad (frekvensen sätts via respektive
-* timers prescaler-bitar vid initieringen).
+* valbar fördröjningstid, förutom Timer 2 som används av klockan (se ovan).
+* Fördröjningstiden räknas om till antal avbrott via medlemmen
+* interrupt_time, vilken beräknas från vald timerkrets prescaler och
+* maxvärde. Makrot INTERRUPT_TIME anger motsvarande tid för Timer 1, för
+* moduler som enbart används med den dynamiska timern (exempelvis Trace.h).
 *
 * Avbrottsvektorer för respektive timerkrets är följande:
 *
 * Timer 0: TIMER0_OVF_vect - Normal Mode.
-* Timer 1: TIMER1_COMPA_vect - CTC Mode, maxvärde för uppräkning satt till 256.
-* Timer 2: TIMER2_OVF_vect - Normal Mode.
+* Timer 1: TIMER1_COMPA_vect - CTC Mode, maxvärde för uppräkning satt till 65535.
+*
+* Medlemmarna executed_interrupts och required_interrupts uppdateras från
+* avbrottsrutiner och ska därför läsas och skrivas utanför avbrottsrutiner
+* via Timer_executed, Timer_required, Timer_clear, Timer_reset samt
+* Timer_set, vilka sker atomärt (se Atomic.h).
 ******************************************************************************/
 
 struct Timer
 {
 	bool enabled;					// Indikerar ifall timern är aktiverad.
 	TimerSelection timerSelection;			// Använd timerkrets. 
+	float interrupt_time;				// Tid mellan avbrott mätt i millisekunder.
 	volatile uint32_t executed_interrupts;		// Antalet avbrott som har ägt rum. 
-	uint32_t required_interrupts;			// Antalet avbrott som krävs för aktuell fördröjning.
+	volatile uint32_t required_interrupts;		// Antalet avbrott som krävs för aktuell fördröjning.
 };
 
 // Funktionsdeklarationer:
+void TimerDescriptor_get(const TimerSelection timerSelection, struct TimerDescriptor* descriptor);
+uint8_t TimerDescriptor_clock_select(const struct TimerDescriptor* self, const uint16_t prescaler);
+uint16_t TimerDescriptor_prescaler(const struct TimerDescriptor* self);
+float TimerDescriptor_interrupt_time(const struct TimerDescriptor* self);
 struct Timer new_Timer(const TimerSelection timerSelection, const double delay_time); 
 void Timer_on(struct Timer* self);
 void Timer_off(struct Timer* self);
@@ -105,5 +131,7 @@ bool Timer_elapsed(struct Timer* self);
 void Timer_clear(struct Timer* self);
 void Timer_reset(struct Timer* self);
 void Timer_set(struct Timer* self, const double delay_time); 
+uint32_t Timer_executed(const struct Timer* self);
+uint32_t Timer_required(const struct Timer* self);
 
 #endif /* TIMER_H_ */
@@ -0,0 +1,209 @@
+// Inkluderingsdirektiv:
+#include "TimerChannel.h"
+
+static struct TimerChannel* channels[3][2];	// Aktiverade kanaler, indexerade via timerkrets och kanal.
+
+// Statiska funktioner:
+static uint32_t get_period(const struct TimerDescriptor* descriptor, const double delay_time);
+static void schedule(struct TimerChannel* self, uint32_t compare, const bool first);
+static uint32_t read_compare(const struct TimerChannel* self);
+
+/******************************************************************************
+* Funktionen new_TimerChannel används för att skapa en kanal på en given
+* timerkrets. Ingående argument timerSelection samt channel väljer
+* timerkrets respektive compare-kanal, delay_time utgör fördröjningstiden
+* mätt i millisekunder och callback utgör funktionen som anropas vid varje
+* deadline (eller 0 ifall ingen funktion skall anropas). Kanalen är
+* inaktiverad vid start.
+******************************************************************************/
+struct TimerChannel new_TimerChannel(const TimerSelection timerSelection, const TimerChannelSelection channel,
+	const double delay_time, void (*callback)(void))
+{
+	struct TimerChannel self;
+	self.enabled = false;
+	self.timerSelection = timerSelection;
+	self.channel = channel;
+	self.delay_time = delay_time;
+	self.period = 0x00;
+	self.wrap = 0x00;
+	self.OCR = 0x00;
+	self.wide = false;
+	self.remaining = 0x00;
+	self.expirations = 0x00;
+	self.callback = callback;
+	return self;
+}
+
+/******************************************************************************
+* Funktionen TimerChannel_on används för att aktivera en kanal. Först räknas
+* fördröjningstiden om till uppräkningar utifrån timerkretsens aktuella
+* prescaler. Om timerkretsen är stoppad, alternativt om kanal A på Timer 1
+* väljs (maxvärde för uppräkning i CTC Mode), så förblir kanalen
+* inaktiverad. Annars registreras kanalen för avbrottsrutinen, varefter
+* första deadline schemaläggs från aktuellt räknarvärde. Avbrottsflaggan
+* nollställs (genom att en etta skrivs) innan kanalens avbrott aktiveras i
+* maskregistret, så att en gammal compare match inte orsakar ett avbrott.
+******************************************************************************/
+void TimerChannel_on(struct TimerChannel* self)
+{
+	struct TimerDescriptor descriptor;
+	TimerDescriptor_get(self->timerSelection, &descriptor);
+	if (descriptor.CTC && self->channel == CHANNEL_A) return;
+
+	const uint32_t period = get_period(&descriptor, self->delay_time);
+	if (!period) return;
+
+	const uint8_t bit = self->channel == CHANNEL_A ? descriptor.compare_A_bit : descriptor.compare_B_bit;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		self->period = period;
+		self->wrap = descriptor.CTC ? (uint32_t)descriptor.top + 1 : descriptor.wide ? 0x10000UL : 0x100UL;
+		self->OCR = self->channel == CHANNEL_A ? descriptor.OCRA : descriptor.OCRB;
+		self->wide = descriptor.wide;
+		self->remaining = period;
+		channels[self->timerSelection][self->channel] = self;
+
+		const uint32_t count = descriptor.wide ? TIMER_REGISTER16(descriptor.TCNT) : TIMER_REGISTER(descriptor.TCNT);
+		schedule(self, count, true);
+
+		TIMER_REGISTER(descriptor.TIFR) = bit;
+		TIMER_REGISTER(descriptor.TIMSK) |= bit;
+		self->enabled = true;
+	}
+
+	return;
+}
+
+/******************************************************************************
+* Funktionen TimerChannel_off används för att inaktivera en kanal, vilket
+* sker genom att kanalens avbrottsbit nollställs i maskregistret. Övriga
+* kanaler på samma timerkrets påverkas inte.
+******************************************************************************/
+void TimerChannel_off(struct TimerChannel* self)
+{
+	struct TimerDescriptor descriptor;
+	TimerDescriptor_get(self->timerSelection, &descriptor);
+	const uint8_t bit = self->channel == CHANNEL_A ? descriptor.compare_A_bit : descriptor.compare_B_bit;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		TIMER_REGISTER(descriptor.TIMSK) &= ~bit;
+		self->enabled = false;
+	}
+
+	return;
+}
+
+/******************************************************************************
+* Funktionen TimerChannel_set används för att uppdatera fördröjningstiden för
+* en given kanal, mätt i millisekunder. Om kanalen är aktiverad gäller den
+* nya fördröjningstiden från och med nästa deadline.
+******************************************************************************/
+void TimerChannel_set(struct TimerChannel* self, const double delay_time)
+{
+	self->delay_time = delay_time;
+	if (!self->enabled) return;
+
+	struct TimerDescriptor descriptor;
+	TimerDescriptor_get(self->timerSelection, &descriptor);
+	const uint32_t period = get_period(&descriptor, delay_time);
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if (period) self->period = period;
+	}
+
+	return;
+}
+
+/******************************************************************************
+* Funktionen TimerChannel_expirations returnerar antalet deadlines som har
+* passerats sedan kanalen skapades. Värdet läses atomärt.
+******************************************************************************/
+uint32_t TimerChannel_expirations(const struct TimerChannel* self)
+{
+	return Atomic_load32(&self->expirations);
+}
+
+/******************************************************************************
+* Funktionen TimerChannel_interrupt anropas från avbrottsrutinen för compare
+* match på en given timerkrets och kanal. Om återstående uppräkningar är
+* noll har deadline nåtts, varvid fördröjningen laddas om. Därefter flyttas
+* compare-registret fram från föregående compare-värde, så att nästa
+* deadline inte påverkas av tiden det tog att hantera avbrottet. Slutligen
+* anropas kanalens callbackfunktion vid deadline, vilken får inaktivera
+* kanalen (exempelvis för en engångsfördröjning).
+******************************************************************************/
+void TimerChannel_interrupt(const TimerSelection timerSelection, const TimerChannelSelection channel)
+{
+	struct TimerChannel* self = channels[timerSelection][channel];
+	if (!self || !self->enabled) return;
+
+	const bool elapsed = !self->remaining;
+
+	if (elapsed)
+	{
+		self->remaining = self->period;
+		self->expirations++;
+	}
+
+	schedule(self, read_compare(self), false);
+	if (elapsed && self->callback) self->callback();
+	return;
+}
+
+/******************************************************************************
+* Funktionen get_period räknar om en fördröjningstid mätt i millisekunder
+* till antalet uppräkningar för en given timerkrets utifrån dess aktuella
+* prescaler, avrundat till närmaste heltal (minst en uppräkning). Om
+* timerkretsen är stoppad returneras 0.
+******************************************************************************/
+static uint32_t get_period(const struct TimerDescriptor* descriptor, const double delay_time)
+{
+	const uint16_t prescaler = TimerDescriptor_prescaler(descriptor);
+	if (!prescaler) return 0x00;
+
+	const uint32_t period = (uint32_t)(delay_time * (F_CPU / 1000UL) / prescaler + 0.5);
+	return period ? period : 1;
+}
+
+/******************************************************************************
+* Funktionen schedule skriver nästa compare-värde utifrån ingående värde
+* compare, där compare-registret flyttas fram med återstående uppräkningar,
+* dock högst ett helt varv, vilket motsvarar att compare-registret lämnas
+* oförändrat. Återstående uppräkningar minskas i motsvarande grad.
+*
+* Vid första schemaläggningen (first) utgör compare aktuellt räknarvärde,
+* varför ett helt varv skulle skriva samma värde som räknaren och kunna
+* ge compare match direkt, en period för tidigt. Första steget begränsas
+* därför till ett halvt varv, där resten schemaläggs vid nästa avbrott.
+* Varvet hanteras via villkorlig subtraktion i stället för modulo, så att
+* ingen division sker i avbrottsrutinen.
+******************************************************************************/
+static void schedule(struct TimerChannel* self, uint32_t compare, const bool first)
+{
+	uint32_t step = self->remaining > self->wrap ? self->wrap : self->remaining;
+	if (first && step == self->wrap) step = self->wrap / 2;
+
+	compare += step;
+	if (compare >= self->wrap) compare -= self->wrap;
+	self->remaining -= step;
+
+	if (self->wide)
+	{
+		TIMER_REGISTER16(self->OCR) = (uint16_t)compare;
+	}
+
+	else
+	{
+		TIMER_REGISTER(self->OCR) = (uint8_t)compare;
+	}
+
+	return;
+}
+
+static uint32_t read_compare(const struct TimerChannel* self)
+{
+	return self->wide ? TIMER_REGISTER16(self->OCR) : TIMER_REGISTER(self->OCR);
+}
@@ -0,0 +1,67 @@
+
+#ifndef TIMERCHANNEL_H_
+#define TIMERCHANNEL_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+#include "Timer.h"
+
+/******************************************************************************
+* Strukten TimerChannel implementerar en fördröjning via en av timerkretsens
+* två compare-kanaler (OCRnA respektive OCRnB), där varje kanal har egen
+* fördröjningstid samt egen callbackfunktion. Kanalerna delar timerkretsens
+* räknare, som löper fritt, varför en enda timerkrets kan driva flera
+* oberoende fördröjningar (exempelvis bouncetid, sampling och blinkning)
+* utan att fler timergenererade avbrott behövs.
+*
+* Vid aktivering skrivs compare-registret till aktuellt räknarvärde plus
+* fördröjningen, varefter compare-registret flyttas fram i varje
+* avbrottsrutin. Fördröjningar längre än ett varv för räknaren delas upp i
+* hela varv, så att avbrott enbart sker en gång per varv tills deadline
+* återstår. Vid deadline anropas kanalens callbackfunktion från
+* avbrottsrutinen, varefter nästa deadline beräknas från föregående
+* deadline (inte från tidpunkten då avbrottet hanterades), så att
+* fördröjningen inte driver.
+*
+* Timerkretsen måste vara startad (se Clock.h för Timer 2 samt Timer.h för
+* Timer 0 och Timer 1) innan en kanal aktiveras, eftersom fördröjningen
+* räknas om till uppräkningar utifrån aktuell prescaler. För Timer 1 kan
+* enbart kanal B användas, då OCR1A utgör maxvärde för uppräkning i CTC
+* Mode. Fördröjningen bör uppgå till minst ett tiotal uppräkningar, annars
+* kan räknaren passera compare-värdet innan det har skrivits, vilket
+* fördröjer deadline med ett helt varv.
+*
+* Avbrottsvektorer för respektive kanal, vilka anropar TimerChannel_interrupt:
+*
+* Timer 0: TIMER0_COMPA_vect samt TIMER0_COMPB_vect.
+* Timer 1: TIMER1_COMPB_vect.
+* Timer 2: TIMER2_COMPA_vect samt TIMER2_COMPB_vect.
+******************************************************************************/
+
+typedef enum TimerChannelSelection { CHANNEL_A, CHANNEL_B } TimerChannelSelection;  // Enumeration för compare-kanaler.
+
+struct TimerChannel
+{
+	bool enabled;					// Indikerar ifall kanalen är aktiverad.
+	TimerSelection timerSelection;			// Använd timerkrets.
+	TimerChannelSelection channel;			// Använd compare-kanal.
+	double delay_time;				// Fördröjningstid mätt i millisekunder.
+	uint32_t period;				// Fördröjningstid mätt i timerns uppräkningar.
+	uint32_t wrap;					// Antal uppräkningar per varv för räknaren.
+	uint8_t OCR;					// Adress för kanalens compare-register.
+	bool wide;					// Indikerar 16-bitars compare-register.
+	volatile uint32_t remaining;			// Återstående uppräkningar efter nästa compare match.
+	volatile uint32_t expirations;			// Antalet deadlines som har passerats.
+	void (*callback)(void);				// Anropas från avbrottsrutinen vid deadline.
+};
+
+// Funktionsdeklarationer:
+struct TimerChannel new_TimerChannel(const TimerSelection timerSelection, const TimerChannelSelection channel,
+	const double delay_time, void (*callback)(void));
+void TimerChannel_on(struct TimerChannel* self);
+void TimerChannel_off(struct TimerChannel* self);
+void TimerChannel_set(struct TimerChannel* self, const double delay_time);
+uint32_t TimerChannel_expirations(const struct TimerChannel* self);
+void TimerChannel_interrupt(const TimerSelection timerSelection, const TimerChannelSelection channel);
+
+#endif /* TIMERCHANNEL_H_ */
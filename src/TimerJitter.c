@@ -0,0 +1,193 @@
+// Inkluderingsdirektiv:
+#include "TimerJitter.h"
+#include "Serial.h"
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+
+#ifdef TIMER_JITTER_ENABLED
+
+#define JITTER_TICKS_PER_INTERRUPT ((uint32_t)(INTERRUPT_TIME * 1000 + 0.5f) / CLOCK_TICK_US)	// Uppräkningar per timeravbrott.
+#define JITTER_PERCENTILE 99	// Skattad percentil för avvikelsens absolutbelopp.
+
+static uint32_t previous_time = 0x00;		// Tidpunkt för föregående utlöpning.
+static uint32_t previous_required = 0x00;	// Fördröjningstid vid föregående utlöpning, 0 om ingen.
+static uint16_t count = 0x00;			// Antal uppmätta perioder.
+static uint16_t exact = 0x00;			// Antal perioder utan avvikelse.
+static uint16_t early[JITTER_BINS];		// Histogram över tidiga perioder.
+static uint16_t late[JITTER_BINS];		// Histogram över sena perioder.
+static int32_t minimum = 0x00;			// Minsta avvikelse i uppräkningar.
+static int32_t maximum = 0x00;			// Största avvikelse i uppräkningar.
+
+// Statiska funktioner:
+static void record(const int32_t deviation);
+static uint8_t bin(const uint32_t magnitude);
+static uint8_t percentile(const uint16_t total, const uint16_t zero, const uint16_t* early_bins, const uint16_t* late_bins);
+static void print_bins(const char* name, const uint16_t* bins);
+static inline void increment(uint16_t* counter);
+
+/******************************************************************************
+* Funktionen TimerJitter_expiry anropas via makrot TIMER_JITTER_EXPIRY från
+* avbrottsrutinen TIMER1_COMPA_vect när den dynamiska timern löper ut, där
+* required utgör aktuell fördröjningstid mätt i antal avbrott. Avvikelsen
+* från nominell period lagras ifall fördröjningstiden är oförändrad sedan
+* föregående utlöpning.
+******************************************************************************/
+void TimerJitter_expiry(const uint32_t required)
+{
+	const uint32_t now = Clock_now();
+
+	if (required && required == previous_required)
+		record((int32_t)(now - previous_time) - (int32_t)(required * JITTER_TICKS_PER_INTERRUPT));
+
+	previous_time = now;
+	previous_required = required;
+	return;
+}
+
+/******************************************************************************
+* Funktionen TimerJitter_reset nollställer histogrammet, varefter nästa
+* utlöpning utgör referens för följande period.
+******************************************************************************/
+void TimerJitter_reset(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		previous_required = 0x00;
+		count = 0x00;
+		exact = 0x00;
+		minimum = 0x00;
+		maximum = 0x00;
+
+		for (register uint8_t i = 0; i < JITTER_BINS; i++)
+		{
+			early[i] = 0x00;
+			late[i] = 0x00;
+		}
+	}
+
+	return;
+}
+
+/******************************************************************************
+* Funktionen TimerJitter_print skriver ut antalet uppmätta perioder, minsta
+* och största avvikelse, skattad 99:e percentil samt histogrammets
+* intervall som innehåller perioder. Samtliga tider skrivs ut i
+* mikrosekunder. En kopia av histogrammet tas med avbrott inaktiverade,
+* så att utskriften blir konsistent.
+******************************************************************************/
+void TimerJitter_print(void)
+{
+	uint16_t total, zero, early_copy[JITTER_BINS], late_copy[JITTER_BINS];
+	int32_t min, max;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		total = count;
+		zero = exact;
+		min = minimum;
+		max = maximum;
+
+		for (register uint8_t i = 0; i < JITTER_BINS; i++)
+		{
+			early_copy[i] = early[i];
+			late_copy[i] = late[i];
+		}
+	}
+
+	serial_printf_P(PSTR("Timer jitter, %u periods (us):\n"), total);
+	if (!total) return;
+
+	serial_printf_P(PSTR("min %ld, max %ld\n"), (long)min * CLOCK_TICK_US, (long)max * CLOCK_TICK_US);
+	const uint8_t p = percentile(total, zero, early_copy, late_copy);
+	if (!p) serial_printf_P(PSTR("p%u 0\n"), JITTER_PERCENTILE);
+	else if (p < JITTER_BINS) serial_printf_P(PSTR("p%u < %lu\n"), JITTER_PERCENTILE, (unsigned long)CLOCK_TICK_US << p);
+	else serial_printf_P(PSTR("p%u >= %lu\n"), JITTER_PERCENTILE, (unsigned long)CLOCK_TICK_US << (p - 1));
+
+	if (zero) serial_printf_P(PSTR("     0: %u\n"), zero);
+	print_bins(PSTR("early"), early_copy);
+	print_bins(PSTR("late"), late_copy);
+	return;
+}
+
+/******************************************************************************
+* Funktionen record lagrar en avvikelse mätt i uppräkningar, där negativa
+* avvikelser motsvarar för korta perioder.
+******************************************************************************/
+static void record(const int32_t deviation)
+{
+	if (!count || deviation < minimum) minimum = deviation;
+	if (!count || deviation > maximum) maximum = deviation;
+	increment(&count);
+
+	if (!deviation) increment(&exact);
+	else if (deviation < 0) increment(&early[bin((uint32_t)-deviation)]);
+	else increment(&late[bin((uint32_t)deviation)]);
+	return;
+}
+
+/******************************************************************************
+* Funktionen bin returnerar index i histogrammet för en avvikelse skild
+* från noll, där index 0 motsvarar intervall 1 (en uppräkning).
+******************************************************************************/
+static uint8_t bin(const uint32_t magnitude)
+{
+	uint32_t value = magnitude;
+	uint8_t index = 0;
+
+	while (value >>= 1)
+	{
+		if (++index == JITTER_BINS - 1) break;
+	}
+
+	return index;
+}
+
+/******************************************************************************
+* Funktionen percentile returnerar intervallet k (0 för avvikelser om noll
+* uppräkningar) där 99:e percentilen av avvikelsens absolutbelopp finns,
+* det vill säga att avvikelsen understiger 2^k uppräkningar för minst 99 %
+* av perioderna.
+******************************************************************************/
+static uint8_t percentile(const uint16_t total, const uint16_t zero, const uint16_t* early_bins, const uint16_t* late_bins)
+{
+	const uint32_t target = ((uint32_t)total * JITTER_PERCENTILE + 99) / 100;
+	uint32_t sum = zero;
+	if (sum >= target) return 0;
+
+	for (register uint8_t i = 0; i < JITTER_BINS; i++)
+	{
+		sum += (uint32_t)early_bins[i] + late_bins[i];
+		if (sum >= target) return i + 1;
+	}
+
+	return JITTER_BINS;
+}
+
+/******************************************************************************
+* Funktionen print_bins skriver ut intervall som innehåller perioder, ett
+* per rad, där name lagras i flashminnet. Sista intervallet saknar övre
+* gräns.
+******************************************************************************/
+static void print_bins(const char* name, const uint16_t* bins)
+{
+	for (register uint8_t i = 0; i < JITTER_BINS; i++)
+	{
+		if (!bins[i]) continue;
+		serial_print_P(name);
+		if (i == JITTER_BINS - 1) serial_printf_P(PSTR(" %lu+: %u\n"), (unsigned long)CLOCK_TICK_US << i, bins[i]);
+		else serial_printf_P(PSTR(" %lu-%lu: %u\n"), (unsigned long)CLOCK_TICK_US << i, (unsigned long)CLOCK_TICK_US << (i + 1), bins[i]);
+	}
+
+	return;
+}
+
+/******************************************************************************
+* Funktionen increment räknar upp en räknare, som stannar vid högsta värdet.
+******************************************************************************/
+static inline void increment(uint16_t* counter)
+{
+	if (*counter < UINT16_MAX) (*counter)++;
+	return;
+}
+
+#endif /* TIMER_JITTER_ENABLED */
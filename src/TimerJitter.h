@@ -0,0 +1,54 @@
+
+#ifndef TIMERJITTER_H_
+#define TIMERJITTER_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+#include "Clock.h"
+#include "Timer.h"
+
+/******************************************************************************
+* TimerJitter mäter hur noggrant den dynamiska timerns fördröjningstid
+* realiseras av avbrottsrutinen TIMER1_COMPA_vect. Vid varje utlöpning
+* anropas makrot TIMER_JITTER_EXPIRY med aktuell fördröjningstid mätt i
+* antal avbrott, varvid tidpunkten läses från klockan (se Clock.h) med
+* upplösningen 4 us. Avvikelsen mellan uppmätt period och nominell period
+* (antal avbrott gånger INTERRUPT_TIME) beror exempelvis på att avbrott fördröjs
+* eller går förlorade medan andra avbrottsrutiner exekverar.
+*
+* Avvikelserna lagras i ett logaritmiskt histogram, där intervall k
+* (1 - JITTER_BINS) omfattar avvikelser om 2^(k - 1) till 2^k uppräkningar
+* och sista intervallet även större avvikelser. Tidiga (negativa) och sena
+* (positiva) avvikelser räknas separat, medan avvikelser om noll
+* uppräkningar räknas för sig. Utöver histogrammet lagras minsta och
+* största avvikelse, medan 99:e percentilen av avvikelsens absolutbelopp
+* skattas från histogrammet som övre gränsen för motsvarande intervall.
+*
+* En period mäts enbart om fördröjningstiden är oförändrad sedan föregående
+* utlöpning, eftersom perioden annars avsiktligt har förkortats eller
+* förlängts (se DynamicTimerUpdate).
+*
+* Precis som profileraren (se Profiler.h) kompileras mätningen enbart in i
+* debug-byggen. Vid release-byggen, där makrot NDEBUG är definierat, eller
+* ifall DISABLE_TIMER_JITTER är definierat, expanderar makrot till
+* ingenting.
+******************************************************************************/
+
+#if !defined(NDEBUG) && !defined(DISABLE_TIMER_JITTER)
+#define TIMER_JITTER_ENABLED
+#endif
+
+#define JITTER_BINS 16		// Antal intervall per riktning, upp till 2^16 uppräkningar (262 ms).
+
+#ifdef TIMER_JITTER_ENABLED
+#define TIMER_JITTER_EXPIRY(required) TimerJitter_expiry(required)
+#else
+#define TIMER_JITTER_EXPIRY(required)
+#endif
+
+// Funktionsdeklarationer (enbart tillgängliga då mätningen är aktiverad):
+void TimerJitter_expiry(const uint32_t required);
+void TimerJitter_reset(void);
+void TimerJitter_print(void);
+
+#endif /* TIMERJITTER_H_ */
@@ -0,0 +1,124 @@
+// Inkluderingsdirektiv:
+#include "Trace.h"
+#include "Serial.h"
+#include "Timer.h"
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+
+#if defined(__AVR__)
+#define TRACE_NOINIT __attribute__((section(".noinit")))	// Nollställs inte vid reset.
+#else
+#define TRACE_NOINIT
+#endif
+
+static struct TraceBuffer buffer TRACE_NOINIT;	// Spårbufferten, behålls över reset.
+
+// Händelsernas namn, lagrade i flashminnet:
+static const char RESET_name[] PROGMEM = "RESET";
+static const char BUTTON_name[] PROGMEM = "BUTTON";
+static const char DEBOUNCE_name[] PROGMEM = "DEBOUNCE";
+static const char MEASUREMENT_name[] PROGMEM = "MEASUREMENT";
+static const char INTERVAL_name[] PROGMEM = "INTERVAL";
+static const char ESTIMATE_name[] PROGMEM = "ESTIMATE";
+static const char ESTIMATOR_name[] PROGMEM = "ESTIMATOR";
+static const char* const names[TRACE_EVENTS] PROGMEM =
+{
+	RESET_name, BUTTON_name, DEBOUNCE_name, MEASUREMENT_name, INTERVAL_name, ESTIMATE_name, ESTIMATOR_name
+};
+
+/******************************************************************************
+* Funktionen Trace_init anropas vid start med innehållet i MCUSR (orsaken
+* till senaste reset) som ingående argument. Om bufferten är giltig och
+* reset inte orsakades av påslag av matningsspänningen behålls tidigare
+* poster och true returneras, annars töms bufferten och false returneras.
+* Slutligen lagras en post som markerar programstarten.
+******************************************************************************/
+bool Trace_init(const uint8_t reset_cause)
+{
+	const bool retained = buffer.magic == TRACE_MAGIC && !(reset_cause & (1 << PORF)) &&
+		buffer.next < TRACE_CAPACITY && buffer.count <= TRACE_CAPACITY;
+
+	if (!retained) Trace_clear();
+	TRACE(TRACE_RESET, reset_cause);
+	return retained;
+}
+
+/******************************************************************************
+* Funktionen Trace_record lagrar en post i ringbufferten, där den äldsta
+* posten skrivs över när bufferten är full. Aktuell tid hämtas från
+* klockan, varefter posten skrivs med avbrott inaktiverade, så att
+* funktionen kan anropas från både avbrottsrutiner och huvudloopen.
+******************************************************************************/
+void Trace_record(const TraceEvent event, const uint16_t argument)
+{
+	const uint16_t timestamp = (uint16_t)(Clock_now() >> TRACE_TIME_SHIFT);
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		struct TraceRecord* record = &buffer.records[buffer.next];
+		record->event = (uint8_t)event;
+		record->timestamp = timestamp;
+		record->argument = argument;
+		buffer.next = (buffer.next + 1) & (TRACE_CAPACITY - 1);
+		if (buffer.count < TRACE_CAPACITY) buffer.count++;
+	}
+
+	return;
+}
+
+/******************************************************************************
+* Funktionen Trace_clear tömmer bufferten och markerar den som giltig.
+******************************************************************************/
+void Trace_clear(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		buffer.next = 0x00;
+		buffer.count = 0x00;
+		buffer.magic = TRACE_MAGIC;
+	}
+
+	return;
+}
+
+/******************************************************************************
+* Funktionen Trace_print skriver ut lagrade poster via seriell överföring,
+* äldsta posten först. Tidsstämplar skrivs ut i millisekunder, liksom
+* argument för intervall och fördröjningstider, medan övriga argument
+* skrivs ut oförändrade. Varje post kopieras med avbrott inaktiverade,
+* där poster som skrivs under utskriften kan ersätta de äldsta posterna.
+******************************************************************************/
+void Trace_print(void)
+{
+	char name[16];
+	uint8_t first, count;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		count = buffer.count;
+		first = (buffer.next - count) & (TRACE_CAPACITY - 1);
+	}
+
+	serial_printf_P(PSTR("Trace: %u records (time in ms):\n"), count);
+
+	for (register uint8_t i = 0; i < count; i++)
+	{
+		struct TraceRecord record;
+
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			record = buffer.records[(first + i) & (TRACE_CAPACITY - 1)];
+		}
+
+		if (record.event >= TRACE_EVENTS) continue;
+		uint32_t argument = record.argument;
+
+		if (record.event == TRACE_INTERVAL || record.event == TRACE_ESTIMATE)
+			argument = (uint32_t)((argument << TRACE_INTERVAL_SHIFT) * INTERRUPT_TIME + 0.5);
+
+		strcpy_P(name, (const char*)pgm_read_ptr(&names[record.event]));
+		serial_printf_P(PSTR("%lu %s %lu\n"), (unsigned long)record.timestamp * 1024UL / 1000UL, name, (unsigned long)argument);
+	}
+
+	return;
+}
@@ -0,0 +1,96 @@
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+#include "Clock.h"
+
+/******************************************************************************
+* Spårbufferten lagrar de senaste händelserna i programmet i binärt format i
+* en ringbuffert i RAM, så att förloppet kan analyseras i efterhand utan att
+* utskrifter i realtid påverkar tidsförloppet. Varje post består av en
+* händelsekod, en 16-bitars tidsstämpel samt ett 16-bitars argument (5 byte)
+* och skrivs utan formatering på ett fåtal klockcykler via makrot TRACE,
+* vilket kan anropas från avbrottsrutiner.
+*
+* Tidsstämpeln utgörs av klockans tid (se Clock.h) skiftad TRACE_TIME_SHIFT
+* steg, vilket ger upplösningen 1.024 ms, där tidsstämpeln slår runt efter
+* cirka 67 sekunder. Argument för intervall och fördröjningstider anges i
+* antal timergenererade avbrott (32.768 ms per avbrott, se Timer.h),
+* begränsat till 16 bitar, vilket räcker för knappt 36 minuter.
+*
+* Bufferten placeras i sektionen .noinit, som inte nollställs vid reset.
+* Vid start kontrolleras bufferten via ett magiskt tal: om det är giltigt
+* och reset inte orsakades av påslag av matningsspänningen (exempelvis
+* watchdog, extern reset eller brown-out) behålls tidigare poster, vilka
+* skrivs ut vid start så att förloppet fram till reset kan analyseras.
+* Bufferten kan även skrivas ut via konsolkommandot trace.
+*
+* Spårningen kan stängas av vid kompilering via makrot DISABLE_TRACE, då
+* makrot TRACE expanderar till ingenting.
+******************************************************************************/
+
+#ifndef TRACE_CAPACITY
+#define TRACE_CAPACITY 32			// Antal poster i ringbufferten, måste vara en tvåpotens.
+#endif
+
+#define TRACE_TIME_SHIFT 8			// Klockans uppräkningar (4 us) per tidsenhet: 2^8, det vill säga 1.024 ms.
+#define TRACE_INTERVAL_SHIFT 0			// Timergenererade avbrott per argumentenhet: 2^0, det vill säga 32.768 ms.
+#define TRACE_MAGIC 0x54AA			// Indikerar att bufferten innehåller giltiga poster.
+
+/******************************************************************************
+* Enumerationen TraceEvent anger händelsekoder för spårbufferten, där
+* argumentet för respektive händelse anges inom parentes.
+******************************************************************************/
+typedef enum TraceEvent
+{
+	TRACE_RESET,				// Programstart (innehållet i MCUSR).
+	TRACE_BUTTON,				// PCI-avbrott för tryckknappen (1 om nedtryckt).
+	TRACE_DEBOUNCE,				// Bouncetiden har löpt ut (0).
+	TRACE_MEASUREMENT,			// Timerstyrd temperaturmätning (0).
+	TRACE_INTERVAL,				// Intervall mellan knapptryckningar (antal avbrott).
+	TRACE_ESTIMATE,				// Ny fördröjningstid (antal avbrott).
+	TRACE_ESTIMATOR,			// Ny skattningsstrategi (IntervalEstimatorType).
+	TRACE_EVENTS
+} TraceEvent;
+
+struct TraceRecord
+{
+	uint8_t event;				// Händelsekod (TraceEvent).
+	uint16_t timestamp;			// Tidpunkt i enheter om 1.024 ms.
+	uint16_t argument;			// Händelsens argument.
+};
+
+struct TraceBuffer
+{
+	uint16_t magic;				// TRACE_MAGIC då bufferten är giltig.
+	uint8_t next;				// Index för nästa post.
+	uint8_t count;				// Antal lagrade poster.
+	struct TraceRecord records[TRACE_CAPACITY];
+};
+
+/******************************************************************************
+* Funktionen Trace_interval räknar om ett antal timergenererade avbrott till
+* argumentenheter (2^TRACE_INTERVAL_SHIFT avbrott) via skift, begränsat
+* till 16 bitar.
+******************************************************************************/
+static inline uint16_t Trace_interval(const uint32_t interrupts)
+{
+	const uint32_t units = interrupts >> TRACE_INTERVAL_SHIFT;
+	return units > UINT16_MAX ? UINT16_MAX : (uint16_t)units;
+}
+
+#ifndef DISABLE_TRACE
+#define TRACE(event, argument) Trace_record(event, argument)
+#else
+#define TRACE(event, argument)
+#endif
+
+// Funktionsdeklarationer:
+bool Trace_init(const uint8_t reset_cause);
+void Trace_record(const TraceEvent event, const uint16_t argument);
+void Trace_clear(void);
+void Trace_print(void);
+
+#endif /* TRACE_H_ */
@@ -0,0 +1,101 @@
+// Inkluderingsdirektiv:
+#include "TypedVector.h"
+
+/******************************************************************************
+* Funktionen Vector_reserve_memory används för att säkerställa att ett
+* dynamiskt fält rymmer minst new_capacity element. Ingående argument data
+* utgör en pekare till fältets datapekare, capacity en pekare till fältets
+* kapacitet och element_size storleken på ett element mätt i byte, medan
+* allocator utgör den allokerare som fältet allokeras via. Om
+* befintlig kapacitet redan räcker görs ingenting. Annars omallokeras fältet
+* till exakt angiven kapacitet. Vid misslyckad allokering, eller ifall
+* fältets storlek mätt i byte inte ryms i size_t (16 bitar på mikrodatorn),
+* bibehålls det befintliga fältet och false returneras.
+******************************************************************************/
+bool Vector_reserve_memory(const struct Allocator* allocator, void** data, size_t* capacity,
+	const size_t element_size, const size_t new_capacity)
+{
+	if (new_capacity <= *capacity) return true;
+	if (new_capacity > SIZE_MAX / element_size) return false;
+	void* copy = allocator->reallocate(*data, element_size * new_capacity);
+	if (!copy) return false;
+	*data = copy;
+	*capacity = new_capacity;
+	return true;
+}
+
+/******************************************************************************
+* Funktionen Vector_grow_memory används för att utöka ett dynamiskt fält så
+* att det rymmer minst required element. Kapaciteten utökas geometriskt med
+* 50 % i taget (minst VECTOR_MIN_CAPACITY element) tills den räcker, vilket
+* medför att ett fält som fylls på ett element i taget enbart omallokeras ett
+* logaritmiskt antal gånger. Utökningen begränsas till det största antal
+* element vars storlek mätt i byte ryms i size_t. Om den geometriska
+* utökningen misslyckas, görs ett nytt försök med exakt den kapacitet som
+* krävs.
+******************************************************************************/
+bool Vector_grow_memory(const struct Allocator* allocator, void** data, size_t* capacity,
+	const size_t element_size, const size_t required)
+{
+	if (required <= *capacity) return true;
+	const size_t limit = SIZE_MAX / element_size;
+	if (required > limit) return false;
+	size_t new_capacity = *capacity < VECTOR_MIN_CAPACITY ? VECTOR_MIN_CAPACITY : *capacity;
+
+	while (new_capacity < required)
+	{
+		const size_t step = new_capacity / 2;
+		new_capacity = new_capacity > limit - step ? limit : new_capacity + step;
+	}
+
+	if (Vector_reserve_memory(allocator, data, capacity, element_size, new_capacity)) return true;
+	return Vector_reserve_memory(allocator, data, capacity, element_size, required);
+}
+
+/******************************************************************************
+* Funktionen Vector_shrink_memory används för att minska ett dynamiskt fälts
+* kapacitet till antalet lagrade element, så att outnyttjat minne frigörs.
+* Om fältet är tomt frigörs allt minne.
+******************************************************************************/
+void Vector_shrink_memory(const struct Allocator* allocator, void** data, size_t* capacity,
+	const size_t element_size, const size_t elements)
+{
+	if (elements == *capacity) return;
+
+	if (!elements)
+	{
+		Vector_free_memory(allocator, data, capacity);
+		return;
+	}
+
+	void* copy = allocator->reallocate(*data, element_size * elements);
+	if (!copy) return;
+	*data = copy;
+	*capacity = elements;
+	return;
+}
+
+/******************************************************************************
+* Funktionen Vector_free_memory används för att frigöra ett dynamiskt fält.
+******************************************************************************/
+void Vector_free_memory(const struct Allocator* allocator, void** data, size_t* capacity)
+{
+	allocator->deallocate(*data);
+	*data = NULL;
+	*capacity = 0x00;
+	return;
+}
+
+/******************************************************************************
+* Funktionen Vector_offset_of returnerar index för elementet som pekaren
+* element pekar på, förutsatt att pekaren pekar in bland ett dynamiskt
+* fälts lagrade element. Annars returneras antalet element. Används för att
+* hitta en källa som utgörs av fältet självt innan fältet omallokeras.
+******************************************************************************/
+size_t Vector_offset_of(const void* data, const size_t elements, const size_t element_size, const void* element)
+{
+	const uintptr_t begin = (uintptr_t)data;
+	const uintptr_t address = (uintptr_t)element;
+	if (!data || address < begin || address >= begin + elements * element_size) return elements;
+	return (address - begin) / element_size;
+}
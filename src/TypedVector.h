@@ -0,0 +1,136 @@
+
+#ifndef TYPEDVECTOR_H_
+#define TYPEDVECTOR_H_
+
+// Inkluderingsdirektiv:
+#include "definitions.h"
+#include "Allocator.h"
+#include <string.h>	// Bibliotek för minneskopiering (memcpy).
+
+/******************************************************************************
+* Makrona VECTOR_DECLARE samt VECTOR_DEFINE används för att generera
+* dynamiska arrayer för en given datatyp, exempelvis uint16_t, så att samma
+* implementering kan återanvändas för samtliga buffertar i programmet i
+* stället för att skrivas om för varje datatyp. VECTOR_DECLARE(type) placeras
+* i en headerfil och deklarerar strukten Vector_type samt tillhörande
+* funktioner, medan VECTOR_DEFINE(type) placeras i exakt en källfil och
+* genererar själva implementeringen. Exempel:
+*
+* VECTOR_DECLARE(uint16_t)
+*
+* ger strukten struct Vector_uint16_t samt funktionerna new_Vector_uint16_t,
+* Vector_uint16_t_push, Vector_uint16_t_reserve och så vidare.
+*
+* Varje vektor håller reda på både antalet lagrade element (elements) samt
+* antalet element som ryms i allokerat minne (capacity). När vektorn blir
+* full utökas kapaciteten geometriskt med 50 % (minst VECTOR_MIN_CAPACITY
+* element), vilket medför att omallokering enbart sker ett logaritmiskt
+* antal gånger och att varje push i genomsnitt tar konstant tid. En faktor
+* på 1.5 i stället för 2 har valts för att begränsa outnyttjat minne, då
+* enbart 2 kB RAM finns tillgängligt.
+*
+* Minne allokeras via vektorns allokerare (se Allocator.h), som vid start
+* sätts till DEFAULT_ALLOCATOR. En annan allokerare kan väljas via
+* funktionen Vector_type_set_allocator så länge vektorn är tom.
+*
+* Inga vektortyper genereras i förväg, eftersom varje instansiering kostar
+* programminne även om den inte används. En modul som behöver en vektortyp
+* deklarerar den i sin headerfil och genererar den i sin källfil.
+******************************************************************************/
+
+#define VECTOR_MIN_CAPACITY 4	// Minsta kapacitet vid första allokering.
+
+// Gemensamma funktioner för minneshantering, används av samtliga vektortyper:
+bool Vector_reserve_memory(const struct Allocator* allocator, void** data, size_t* capacity,
+	const size_t element_size, const size_t new_capacity);
+bool Vector_grow_memory(const struct Allocator* allocator, void** data, size_t* capacity,
+	const size_t element_size, const size_t required);
+void Vector_shrink_memory(const struct Allocator* allocator, void** data, size_t* capacity,
+	const size_t element_size, const size_t elements);
+void Vector_free_memory(const struct Allocator* allocator, void** data, size_t* capacity);
+size_t Vector_offset_of(const void* data, const size_t elements, const size_t element_size, const void* element);
+
+/******************************************************************************
+* Deklarerar strukten Vector_type samt tillhörande funktioner för angiven
+* datatyp. Datatypen måste utgöras av ett enda ord, exempelvis uint16_t.
+******************************************************************************/
+#define VECTOR_DECLARE(type) \
+struct Vector_##type \
+{ \
+	type* data;		/* Pekare till dynamiskt fält som lagrar elementen. */ \
+	size_t elements;	/* Antalet lagrade element. */ \
+	size_t capacity;	/* Antalet element som ryms i allokerat minne. */ \
+	const struct Allocator* allocator; /* Allokerare för fältet. */ \
+}; \
+struct Vector_##type new_Vector_##type(void); \
+void Vector_##type##_set_allocator(struct Vector_##type* self, const struct Allocator* allocator); \
+bool Vector_##type##_reserve(struct Vector_##type* self, const size_t new_capacity); \
+bool Vector_##type##_push(struct Vector_##type* self, const type new_element); \
+bool Vector_##type##_push_many(struct Vector_##type* self, const type* elements, const size_t count); \
+void Vector_##type##_shrink_to_fit(struct Vector_##type* self); \
+void Vector_##type##_clear(struct Vector_##type* self);
+
+/******************************************************************************
+* Genererar implementeringen av funktionerna deklarerade via VECTOR_DECLARE.
+* Vid push läggs elementet direkt i ledigt minne ifall kapaciteten räcker,
+* annars utökas kapaciteten geometriskt först. Vid push_many reserveras
+* minne för samtliga nya element på en gång, följt av en minneskopiering.
+* Källan får utgöras av vektorns egna element, vars position då räknas om
+* efter en eventuell omallokering.
+******************************************************************************/
+#define VECTOR_DEFINE(type) \
+struct Vector_##type new_Vector_##type(void) \
+{ \
+	struct Vector_##type self; \
+	self.data = NULL; \
+	self.elements = 0x00; \
+	self.capacity = 0x00; \
+	self.allocator = DEFAULT_ALLOCATOR; \
+	return self; \
+} \
+\
+void Vector_##type##_set_allocator(struct Vector_##type* self, const struct Allocator* allocator) \
+{ \
+	if (!self->data) self->allocator = allocator; \
+	return; \
+} \
+\
+bool Vector_##type##_reserve(struct Vector_##type* self, const size_t new_capacity) \
+{ \
+	return Vector_reserve_memory(self->allocator, (void**)&self->data, &self->capacity, sizeof(type), new_capacity); \
+} \
+\
+bool Vector_##type##_push(struct Vector_##type* self, const type new_element) \
+{ \
+	if (self->elements == self->capacity && \
+		!Vector_grow_memory(self->allocator, (void**)&self->data, &self->capacity, sizeof(type), self->elements + 1)) return false; \
+	self->data[self->elements++] = new_element; \
+	return true; \
+} \
+\
+bool Vector_##type##_push_many(struct Vector_##type* self, const type* elements, const size_t count) \
+{ \
+	if (!count) return true; \
+	if (count > SIZE_MAX - self->elements) return false; \
+	const size_t offset = Vector_offset_of(self->data, self->elements, sizeof(type), elements); \
+	if (!Vector_grow_memory(self->allocator, (void**)&self->data, &self->capacity, sizeof(type), self->elements + count)) return false; \
+	if (offset < self->elements) elements = &self->data[offset]; \
+	memcpy(&self->data[self->elements], elements, sizeof(type) * count); \
+	self->elements += count; \
+	return true; \
+} \
+\
+void Vector_##type##_shrink_to_fit(struct Vector_##type* self) \
+{ \
+	Vector_shrink_memory(self->allocator, (void**)&self->data, &self->capacity, sizeof(type), self->elements); \
+	return; \
+} \
+\
+void Vector_##type##_clear(struct Vector_##type* self) \
+{ \
+	Vector_free_memory(self->allocator, (void**)&self->data, &self->capacity); \
+	self->elements = 0x00; \
+	return; \
+}
+
+#endif /* TYPEDVECTOR_H_ */
@@ -4,8 +4,9 @@
 * Funktionen new_Vector används för att initiera en ny dynamisk array. Först
 * deklareras ett objekt av strukten Vector, döpt self. Sedan sätt pekaren data
 * till en nullpekare, detta då den ej har någon befintlig minnesadress som den 
-* kan peka på vid start. Instansvariabeln elements sätts till 0 vid start då 
-* arrayen är tom vid start. 
+* kan peka på vid start. Instansvariablerna elements och capacity sätts till 0
+* vid start då arrayen är tom och inget minne är allokerat vid start.
+* Standardallokeraren DEFAULT_ALLOCATOR används för minnesallokering.
 * Slutligen returneras objektet self. 
 ******************************************************************************/
 
@@ -14,16 +15,32 @@ struct Vector new_Vector(void)
 	struct Vector self; 
 	self.data = NULL;
 	self.elements = 0x00;
+	self.capacity = 0x00;
+	self.allocator = DEFAULT_ALLOCATOR;
 	return self;
 }
 
+/******************************************************************************
+* Funktionen Vector_set_allocator används för att välja vilken allokerare
+* som vektorns minne skall allokeras via. Eftersom befintligt minne måste
+* frigöras via samma allokerare som det allokerades med, så ignoreras
+* anropet ifall vektorn redan har allokerat minne.
+******************************************************************************/
+
+void Vector_set_allocator(struct Vector* self, const struct Allocator* allocator)
+{
+	if (!self->data) self->allocator = allocator;
+	return;
+}
+
 /******************************************************************************
 * Funtionen används för att kunna uppdatera den dynamiska vektorns storlek.
 * Om den nya storleken är noll, frigör allt minne och avsluta funktionen, 
-* via anrop av funktionen Vector_clear. Annars omallokeras fältet data
-* med en kopia efter den nya storleken. 
-* Sedan sätts ordinarie pekare data till att peka på det nya fältet och 
-* därefter uppdateras antalet element.
+* via anrop av funktionen Vector_clear. Om den nya storleken överstiger 
+* kapaciteten reserveras minne för exakt den nya storleken. Därefter 
+* uppdateras antalet element. Vid minskning behålls allokerat minne, så att
+* vektorn kan växa igen utan omallokering. Outnyttjat minne frigörs enbart
+* via ett explicit anrop av Vector_shrink_to_fit.
 ******************************************************************************/
 
 void Vector_resize(struct Vector* self, const size_t new_size)
@@ -34,38 +51,78 @@ void Vector_resize(struct Vector* self, const size_t new_size)
 		return;
 	}
 	
-	uint32_t* copy =  (uint32_t*)realloc(self->data, sizeof(uint32_t) * new_size); 
-	if (!copy) return;
-	self->data = copy;
+	if (!Vector_reserve(self, new_size)) return;
 	self->elements = new_size;
 	return;
 }
 
 /******************************************************************************
-* Först omallokeras fältet så att det rymmer ett tal till, använder 
-* en kopia. Sedan läggs det nya elementet längst bak i arrayen och 
-* därefter sätts datapekaren till att peka på det nya fältet.
+* Funktionen Vector_reserve används för att reservera minne för minst
+* new_capacity element, exempelvis när antalet element är känt i förväg.
+* Returnerar false ifall minnesallokeringen misslyckas.
+******************************************************************************/
+
+bool Vector_reserve(struct Vector* self, const size_t new_capacity)
+{
+	return Vector_reserve_memory(self->allocator, (void**)&self->data, &self->capacity, sizeof(uint32_t), new_capacity);
+}
+
+/******************************************************************************
+* Om arrayen är full utökas kapaciteten geometriskt först, så att 
+* omallokering enbart sker när kapaciteten tar slut. Sedan läggs det nya 
+* elementet längst bak i arrayen. Returnerar false ifall minnesallokeringen
+* misslyckas, då inget element läggs till.
+******************************************************************************/
+
+bool Vector_push(struct Vector* self, const uint32_t new_element)
+{
+	if (self->elements == self->capacity &&
+		!Vector_grow_memory(self->allocator, (void**)&self->data, &self->capacity, sizeof(uint32_t), self->elements + 1)) return false;
+	self->data[self->elements++] = new_element; 
+	return true;
+}
+
+/******************************************************************************
+* Funktionen Vector_push_many används för att lägga till count element på
+* en gång längst bak i arrayen. Minne reserveras för samtliga element innan
+* dessa kopieras. Källan får utgöras av vektorns egna element, exempelvis
+* för att duplicera innehållet, då omallokeringen kan flytta datapekaren
+* räknas källans position om efter omallokeringen. Returnerar false ifall
+* minnesallokeringen misslyckas.
+******************************************************************************/
+
+bool Vector_push_many(struct Vector* self, const uint32_t* elements, const size_t count)
+{
+	if (!count) return true;
+	if (count > SIZE_MAX - self->elements) return false;
+	const size_t offset = Vector_offset_of(self->data, self->elements, sizeof(uint32_t), elements);
+	if (!Vector_grow_memory(self->allocator, (void**)&self->data, &self->capacity, sizeof(uint32_t), self->elements + count)) return false;
+	if (offset < self->elements) elements = &self->data[offset];
+	memcpy(&self->data[self->elements], elements, sizeof(uint32_t) * count);
+	self->elements += count;
+	return true;
+}
+
+/******************************************************************************
+* Funktionen Vector_shrink_to_fit används för att minska kapaciteten till
+* antalet lagrade element, så att outnyttjat minne frigörs.
 ******************************************************************************/
 
-void Vector_push(struct Vector* self, const uint32_t new_element)
+void Vector_shrink_to_fit(struct Vector* self)
 {
-	uint32_t* copy = (uint32_t*)realloc(self->data, sizeof(uint32_t) * (self->elements + 1)); 
-	if (!copy) return; 
-	copy[self->elements++] = new_element; 
-	self->data = copy; 
+	Vector_shrink_memory(self->allocator, (void**)&self->data, &self->capacity, sizeof(uint32_t), self->elements);
 	return;
 }
 
 /******************************************************************************
 * Funktionen används för att kunna tömma en dynamisk array och frigöra
-* dess minne. Först sker en deallokering via anrop av funktionen free, 
-* där datapekaren som pekar på det allokerarade minnet passerar.
+* dess minne. Först sker en deallokering via anrop av Vector_free_memory,
+* där datapekaren som pekar på det allokerarade minnet passeras.
 ******************************************************************************/
 
 void Vector_clear(struct Vector* self)
 {
-	free(self->data);
-	self->data = NULL;
+	Vector_free_memory(self->allocator, (void**)&self->data, &self->capacity);
 	self->elements = 0x00;
 	return;
 }
@@ -104,23 +161,26 @@ double Vector_average(const struct Vector* self)
 * Om arrayen är tom så avslutas funktionen.
 * Annars initieras seriell överföring med anrop av funktionen
 * init_serial. Sedan skrivs antal och summa av element ut, samt det 
-* avrundade värdet. 
+* avrundade värdet. Texten lagras i flashminnet och funktionen kompileras
+* enbart in då LOG_LEVEL är minst LOG_LEVEL_DEBUG.
 ******************************************************************************/
 
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
 void Vector_print(const struct Vector* self)
 {
 	if (!self->elements) return;
 	init_serial();
 	
-	serial_print("------------------------------------------------\n");
-	serial_print_unsigned("Number of elements: %lu\n", self->elements); 
-	serial_print_unsigned("Sum of all elements: %lu\n", Vector_sum(self));
-	serial_print_integer("Rounded average: %ld\n", (uint32_t)(Vector_average(self) + 0.5));
+	serial_print_P(PSTR("------------------------------------------------\n"));
+	serial_printf_P(PSTR("Number of elements: %lu\n"), (unsigned long)self->elements); 
+	serial_printf_P(PSTR("Sum of all elements: %lu\n"), (unsigned long)Vector_sum(self));
+	serial_printf_P(PSTR("Rounded average: %lu\n"), (unsigned long)(Vector_average(self) + 0.5));
 	for (register size_t i = 0; i < self->elements; i++)
-		serial_print_unsigned("%lu\n", self->data[i]);
-	serial_print("------------------------------------------------\n\n");	
+		serial_printf_P(PSTR("%lu\n"), (unsigned long)self->data[i]);
+	serial_print_P(PSTR("------------------------------------------------\n\n"));	
 	return;
 }
+#endif /* LOG_LEVEL >= LOG_LEVEL_DEBUG */
 
 /******************************************************************************
 * Funktionen används för att kunna beräkna summa av alla befintliga 
@@ -3,26 +3,36 @@
 #define VECTOR_H_
 
 #include "definitions.h"
-#include "Serial.h"
+#include "Log.h"
+#include "TypedVector.h"
 
 /******************************************************************************
 Strukten Vector används för att implementera dynamiska arrayer för lagring av
 osignerade heltal. Pekaren data pekar på ett dynamiskt fält som lagrar samtliga
-tal, medan elements indikerar antalet tal i arrayen. 
+tal, medan elements indikerar antalet tal i arrayen. Medlemmen capacity
+indikerar hur många tal som ryms i allokerat minne, så att omallokering inte
+behöver ske vid varje push (se TypedVector.h). Minne allokeras via pekaren
+allocator, som vid start pekar på DEFAULT_ALLOCATOR (se Allocator.h).
 ******************************************************************************/
 struct Vector
 {
 	uint32_t* data;		// Pekare till dynamsikt fält som lagrar osignerade heltal
 	size_t elements;	// Räknar antalet element (osignerade heltal) i arrayen.
+	size_t capacity;	// Antalet element som ryms i allokerat minne.
+	const struct Allocator* allocator;	// Allokerare för fältet data.
 };
 
 // Externa funktioner:
 struct Vector new_Vector(void);								// Initieringsrutin för dynamiska arrayer, returnerar färdig vektor.
+void Vector_set_allocator(struct Vector* self, const struct Allocator* allocator);	// Väljer allokerare, enbart möjligt för tom vektor.
 void Vector_resize(struct Vector* self, const size_t new_size);				// Uppdaterar den dynamiska vektorns storlek.
-void Vector_push(struct Vector* self, const uint32_t new_element);			// Lägger till ett nytt element längst bak i arrayen.
+bool Vector_reserve(struct Vector* self, const size_t new_capacity);			// Reserverar minne för minst new_capacity element.
+bool Vector_push(struct Vector* self, const uint32_t new_element);			// Lägger till ett nytt element längst bak i arrayen.
+bool Vector_push_many(struct Vector* self, const uint32_t* elements, const size_t count);	// Lägger till flera element längst bak i arrayen.
+void Vector_shrink_to_fit(struct Vector* self);						// Frigör outnyttjat minne.
 void Vector_clear(struct Vector* self);							// Tömmer arrayen och frigör minne.
 void Vector_set(struct Vector* self, const size_t index, const uint32_t new_element);	// Används för att skriva över ett gammalt element.
 uint32_t Vector_sum(const struct Vector* self);						// Beräknar summan av alla befintliga element.
 double Vector_average(const struct Vector* self);					// Beräknar genomsnitt av lagrade värden.
-void Vector_print(const struct Vector* self);						// Skriver ut vektorns innehåll.
+void Vector_print(const struct Vector* self);						// Skriver ut vektorns innehåll (då LOG_LEVEL är minst LOG_LEVEL_DEBUG).
 #endif /* VECTOR_H_ */
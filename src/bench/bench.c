@@ -0,0 +1,367 @@
+// Inkluderingsdirektiv:
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "sim_avr.h"
+#include "sim_elf.h"
+#include "sim_irq.h"
+#include "avr_ioport.h"
+#include "avr_adc.h"
+#include "avr_uart.h"
+
+/******************************************************************************
+* Benchmarkprogram som exekverar programmet, kompilerat för ATmega328P via
+* avr-gcc, i simulatorn simavr, vilken ersätter mikrodatorn vid mätning.
+* Eftersom simavr exekverar programmet instruktion för instruktion med
+* korrekt antal klockcykler per instruktion kan kostnaden för avbrottsrutiner
+* och funktioner mätas exakt. Ett scenario med knapptryckningar på
+* tryckknappens PIN 13 (PORTB5), en fast insignal på analog PIN A1 samt en
+* tomgångsperiod simuleras enligt angivna argument:
+*
+* --firmware ELF    Programfil kompilerad för ATmega328P (krävs).
+* --symbols FILE    Symboltabell från avr-nm för programfilen (krävs).
+* --name NAME       Scenariots namn, används som prefix i resultatet.
+* --presses N       Antal knapptryckningar (standard 5).
+* --interval MS     Tid mellan knapptryckningar i millisekunder (standard 2000).
+* --idle MS         Simulerad tid efter sista knapptryckningen (standard 5000).
+* --adc-mv MV       Spänning på analog PIN A1 i millivolt (standard 750).
+* --baseline FILE   Referensvärden, se baseline.txt.
+* --tolerance PCT   Tillåten ökning i procent jämfört med referensvärden
+*                   (standard 5).
+* --verbose         Transmitterade tecken skrivs ut på stderr.
+*
+* Resultatet skrivs ut som rader på formen "nyckel värde", exempelvis
+* "presses.isr.PCINT0.cycles.max 1234", och innehåller:
+*
+* - Antal anrop samt minsta, största och genomsnittligt antal klockcykler
+*   per avbrottsrutin och per uppmätt funktion. En rutin anses starta när
+*   programräknaren når dess första instruktion och avslutas när stackpekaren
+*   överstiger värdet vid starten, det vill säga när returadressen har
+*   hämtats via RET eller RETI. Tiden för avbrottsrutiner exkluderar därmed
+*   avbrottets svarstid (hopp via avbrottstabellen), medan tiden för
+*   funktioner inkluderar eventuella avbrott som sker under funktionsanropet.
+* - Antal transmitterade tecken via USART 0.
+* - Total tid samt längsta sammanhängande tid med avbrott inaktiverade
+*   (I-flaggan i SREG nollställd), vilket inkluderar tiden i avbrottsrutiner.
+*
+* Om referensvärden anges jämförs varje resultat med motsvarande nyckel i
+* referensfilen, varvid programmet returnerar 1 ifall något värde överstiger
+* referensvärdet med mer än tillåten tolerans.
+******************************************************************************/
+
+#define BENCH_F_CPU 16000000UL
+#define BENCH_CYCLES_PER_MS (BENCH_F_CPU / 1000UL)
+#define BENCH_PRESS_TIME 50		// Tid i millisekunder som tryckknappen hålls nedtryckt.
+#define BENCH_NAME_SIZE 32
+
+/******************************************************************************
+* Strukten BenchProbe lagrar mätdata för en avbrottsrutin eller funktion,
+* identifierad via dess symbol i programfilen.
+******************************************************************************/
+struct BenchProbe
+{
+	const char* symbol;		// Symbolnamn i programfilen.
+	const char* name;		// Namn i resultatet.
+	const char* category;		// "isr" eller "func".
+	uint32_t address;		// Adress i flashminnet (byte), 0 om symbolen saknas.
+	bool active;			// Indikerar att rutinen exekveras.
+	uint16_t entry_SP;		// Stackpekarens värde vid start.
+	avr_cycle_count_t entry_cycle;	// Klockcykel vid start.
+	uint64_t count;
+	uint64_t total;
+	uint64_t minimum;
+	uint64_t maximum;
+};
+
+static struct BenchProbe probes[] =
+{
+	{ .symbol = "__vector_3", .name = "PCINT0", .category = "isr" },
+	{ .symbol = "__vector_7", .name = "TIMER2_COMPA", .category = "isr" },
+	{ .symbol = "__vector_9", .name = "TIMER2_OVF", .category = "isr" },
+	{ .symbol = "__vector_11", .name = "TIMER1_COMPA", .category = "isr" },
+	{ .symbol = "__vector_18", .name = "USART_RX", .category = "isr" },
+	{ .symbol = "TemperatureReport_run", .name = "TemperatureReport_run", .category = "func" },
+	{ .symbol = "DynamicTimer_update", .name = "DynamicTimer_update", .category = "func" },
+	{ .symbol = "Vector_sum", .name = "Vector_sum", .category = "func" },
+	{ .symbol = "serial_print", .name = "serial_print", .category = "func" },
+};
+
+#define BENCH_PROBES (sizeof(probes) / sizeof(probes[0]))
+
+// Statiska variabler:
+static uint64_t transmitted_bytes = 0;
+static uint64_t disabled_total = 0;
+static uint64_t disabled_longest = 0;
+static uint64_t disabled_current = 0;
+static bool verbose = false;
+static bool regression = false;
+
+// Statiska funktioner:
+static void uart_output(struct avr_irq_t* irq, uint32_t value, void* param);
+static bool load_symbols(const char* path);
+static void run(avr_t* avr, const uint64_t ms);
+static void step(avr_t* avr);
+static void report(const char* name, const char* key, const uint64_t value, const char* baseline, const unsigned tolerance);
+static bool baseline_value(const char* path, const char* key, uint64_t* value);
+
+int main(int argc, char** argv)
+{
+	const char* firmware_path = 0;
+	const char* symbols_path = 0;
+	const char* baseline = 0;
+	const char* name = "bench";
+	uint32_t presses = 5;
+	uint32_t interval = 2000;
+	uint32_t idle = 5000;
+	uint32_t adc_mv = 750;
+	unsigned tolerance = 5;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char* value = i + 1 < argc ? argv[i + 1] : "";
+
+		if (!strcmp(argv[i], "--firmware")) firmware_path = value, i++;
+		else if (!strcmp(argv[i], "--symbols")) symbols_path = value, i++;
+		else if (!strcmp(argv[i], "--name")) name = value, i++;
+		else if (!strcmp(argv[i], "--presses")) presses = (uint32_t)strtoul(value, 0, 10), i++;
+		else if (!strcmp(argv[i], "--interval")) interval = (uint32_t)strtoul(value, 0, 10), i++;
+		else if (!strcmp(argv[i], "--idle")) idle = (uint32_t)strtoul(value, 0, 10), i++;
+		else if (!strcmp(argv[i], "--adc-mv")) adc_mv = (uint32_t)strtoul(value, 0, 10), i++;
+		else if (!strcmp(argv[i], "--baseline")) baseline = value, i++;
+		else if (!strcmp(argv[i], "--tolerance")) tolerance = (unsigned)strtoul(value, 0, 10), i++;
+		else if (!strcmp(argv[i], "--verbose")) verbose = true;
+		else firmware_path = 0, i = argc;
+	}
+
+	if (!firmware_path || !symbols_path)
+	{
+		fprintf(stderr, "Usage: %s --firmware ELF --symbols FILE [--name NAME] [--presses N] [--interval MS] "
+			"[--idle MS] [--adc-mv MV] [--baseline FILE] [--tolerance PCT] [--verbose]\n", argv[0]);
+		return 2;
+	}
+
+	if (!load_symbols(symbols_path)) return 2;
+
+	elf_firmware_t firmware;
+	memset(&firmware, 0, sizeof(firmware));
+
+	if (elf_read_firmware(firmware_path, &firmware))
+	{
+		fprintf(stderr, "Could not read %s\n", firmware_path);
+		return 2;
+	}
+
+	avr_t* avr = avr_make_mcu_by_name("atmega328p");
+	if (!avr) return 2;
+	avr_init(avr);
+	firmware.frequency = BENCH_F_CPU;
+	avr_load_firmware(avr, &firmware);
+	avr->vcc = avr->avcc = avr->aref = 5000;
+
+	uint32_t flags = 0;
+	avr_ioctl(avr, AVR_IOCTL_UART_GET_FLAGS('0'), &flags);
+	flags &= ~AVR_UART_FLAG_STDIO;
+	avr_ioctl(avr, AVR_IOCTL_UART_SET_FLAGS('0'), &flags);
+	avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT), uart_output, 0);
+
+	avr_irq_t* button = avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ('B'), 5);
+	avr_raise_irq(button, 0);
+	avr_raise_irq(avr_io_getirq(avr, AVR_IOCTL_ADC_GETIRQ, ADC_IRQ_ADC1), adc_mv);
+
+	for (uint32_t i = 0; i < presses; i++)
+	{
+		run(avr, interval - BENCH_PRESS_TIME);
+		avr_raise_irq(button, 1);
+		run(avr, BENCH_PRESS_TIME);
+		avr_raise_irq(button, 0);
+	}
+
+	run(avr, idle);
+
+	for (size_t i = 0; i < BENCH_PROBES; i++)
+	{
+		const struct BenchProbe* probe = &probes[i];
+		char key[BENCH_NAME_SIZE * 2];
+		if (!probe->address) continue;
+
+		snprintf(key, sizeof(key), "%s.%s.count", probe->category, probe->name);
+		report(name, key, probe->count, 0, tolerance);
+		if (!probe->count) continue;
+
+		snprintf(key, sizeof(key), "%s.%s.cycles.min", probe->category, probe->name);
+		report(name, key, probe->minimum, baseline, tolerance);
+		snprintf(key, sizeof(key), "%s.%s.cycles.max", probe->category, probe->name);
+		report(name, key, probe->maximum, baseline, tolerance);
+		snprintf(key, sizeof(key), "%s.%s.cycles.mean", probe->category, probe->name);
+		report(name, key, probe->total / probe->count, baseline, tolerance);
+	}
+
+	report(name, "uart.bytes", transmitted_bytes, baseline, tolerance);
+	report(name, "irq_disabled.cycles.total", disabled_total, baseline, tolerance);
+	report(name, "irq_disabled.cycles.max", disabled_longest, baseline, tolerance);
+	return regression ? 1 : 0;
+}
+
+/******************************************************************************
+* Anropas av simavr för varje tecken som transmitteras via USART 0.
+******************************************************************************/
+static void uart_output(struct avr_irq_t* irq, uint32_t value, void* param)
+{
+	transmitted_bytes++;
+	if (verbose) fputc((char)value, stderr);
+	return;
+}
+
+/******************************************************************************
+* Funktionen load_symbols läser symboltabellen som genereras av avr-nm, med
+* rader på formen "adress typ namn", och lagrar adressen för varje uppmätt
+* symbol. Symboler i flashminnet har typen T eller t.
+******************************************************************************/
+static bool load_symbols(const char* path)
+{
+	FILE* file = fopen(path, "r");
+	char line[128];
+
+	if (!file)
+	{
+		fprintf(stderr, "Could not read %s\n", path);
+		return false;
+	}
+
+	while (fgets(line, sizeof(line), file))
+	{
+		unsigned long address;
+		char type;
+		char symbol[64];
+		if (sscanf(line, "%lx %c %63s", &address, &type, symbol) != 3) continue;
+		if (type != 'T' && type != 't') continue;
+
+		for (size_t i = 0; i < BENCH_PROBES; i++)
+		{
+			if (!strcmp(probes[i].symbol, symbol))
+				probes[i].address = (uint32_t)address;
+		}
+	}
+
+	fclose(file);
+	return true;
+}
+
+/******************************************************************************
+* Funktionen run exekverar programmet ett givet antal millisekunder.
+******************************************************************************/
+static void run(avr_t* avr, const uint64_t ms)
+{
+	const avr_cycle_count_t end = avr->cycle + ms * BENCH_CYCLES_PER_MS;
+
+	while (avr->cycle < end)
+	{
+		const int state = avr->state;
+		if (state == cpu_Done || state == cpu_Crashed) exit(2);
+		step(avr);
+	}
+	return;
+}
+
+/******************************************************************************
+* Funktionen step exekverar en instruktion och uppdaterar mätdata: start och
+* slut för uppmätta rutiner samt tid med avbrott inaktiverade.
+******************************************************************************/
+static void step(avr_t* avr)
+{
+	const avr_cycle_count_t before = avr->cycle;
+	const bool interrupts_disabled = !avr->sreg[S_I];
+	avr_run(avr);
+
+	const uint64_t elapsed = avr->cycle - before;
+	const uint16_t SP = (uint16_t)(avr->data[R_SPL] | (avr->data[R_SPH] << 8));
+
+	if (interrupts_disabled)
+	{
+		disabled_total += elapsed;
+		disabled_current += elapsed;
+		if (disabled_current > disabled_longest) disabled_longest = disabled_current;
+	}
+
+	else
+	{
+		disabled_current = 0;
+	}
+
+	for (size_t i = 0; i < BENCH_PROBES; i++)
+	{
+		struct BenchProbe* probe = &probes[i];
+		if (!probe->address) continue;
+
+		if (probe->active && SP > probe->entry_SP)
+		{
+			const uint64_t cycles = avr->cycle - probe->entry_cycle;
+			probe->active = false;
+			probe->total += cycles;
+			if (!probe->count || cycles < probe->minimum) probe->minimum = cycles;
+			if (cycles > probe->maximum) probe->maximum = cycles;
+			probe->count++;
+		}
+
+		if (!probe->active && avr->pc == probe->address)
+		{
+			probe->active = true;
+			probe->entry_SP = SP;
+			probe->entry_cycle = avr->cycle;
+		}
+	}
+	return;
+}
+
+/******************************************************************************
+* Funktionen report skriver ut ett resultat och jämför det med referensvärdet,
+* ifall en referensfil har angivits och innehåller nyckeln i fråga.
+******************************************************************************/
+static void report(const char* name, const char* key, const uint64_t value, const char* baseline, const unsigned tolerance)
+{
+	char full_key[BENCH_NAME_SIZE * 3];
+	uint64_t reference;
+	snprintf(full_key, sizeof(full_key), "%s.%s", name, key);
+	printf("%s %llu\n", full_key, (unsigned long long)value);
+
+	if (baseline && baseline_value(baseline, full_key, &reference))
+	{
+		if (value * 100 > reference * (100 + tolerance))
+		{
+			fprintf(stderr, "Regression: %s %llu (baseline %llu)\n", full_key,
+				(unsigned long long)value, (unsigned long long)reference);
+			regression = true;
+		}
+	}
+	return;
+}
+
+/******************************************************************************
+* Funktionen baseline_value söker efter en nyckel i referensfilen. Rader som
+* börjar med # ignoreras.
+******************************************************************************/
+static bool baseline_value(const char* path, const char* key, uint64_t* value)
+{
+	FILE* file = fopen(path, "r");
+	char line[160];
+	bool found = false;
+	if (!file) return false;
+
+	while (!found && fgets(line, sizeof(line), file))
+	{
+		char line_key[BENCH_NAME_SIZE * 3];
+		unsigned long long line_value;
+		if (line[0] == '#') continue;
+
+		if (sscanf(line, "%95s %llu", line_key, &line_value) == 2 && !strcmp(line_key, key))
+		{
+			*value = line_value;
+			found = true;
+		}
+	}
+
+	fclose(file);
+	return found;
+}
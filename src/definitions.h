@@ -8,7 +8,6 @@
 #include <avr/interrupt.h>  // Bibliotek för avbrott. 
 #include <stdio.h>          // Bibliotek för implementering av I/O i C. 
 #include <stdlib.h>         // C:s standardbibliotek. 
-#include "Byte.h"           // Headerfil för inkludering av union för enkel bithantering. 
 #include <util/delay.h>     // Bibliotek generering av fördröjning.
 
 /******************************************************************************
@@ -16,11 +15,13 @@
 * i statusregistret SREG, vilket åstadkommes via assemblerinstruktionen SEI
 * (Set Interrupt Flag). För att vid behov inaktivera avbrott globalt, vilket
 * exempelvis är nödvändigt vid skrivning till EEPROM-minnet, så nollställs
-* I-biten via assemblerinstruktionen CLI (Clear Interrupt Flag).
+* I-biten via assemblerinstruktionen CLI (Clear Interrupt Flag). Makrona
+* sei() och cli() från avr/interrupt.h används, vilka vid kompilering för
+* PC (HOST_BUILD) i stället uppdaterar simulatorns statusregister.
 ******************************************************************************/
 
-#define ENABLE_INTERRUPTS asm("SEI")    // Aktiverar avbrott globalt. 
-#define DISABLE_INTERRUPTS asm("CLI")   // Inaktiverar avbrott globalt. 
+#define ENABLE_INTERRUPTS sei()    // Aktiverar avbrott globalt. 
+#define DISABLE_INTERRUPTS cli()   // Inaktiverar avbrott globalt. 
 
 // Typdefinitioner: 
 typedef enum bool { false, true } bool;                                 // Realiserar datatypen bool.
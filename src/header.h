@@ -5,20 +5,41 @@
 #include "definitions.h"
 #include "GPIO.h" 
 #include "Timer.h"
+#include "TimerChannel.h"
 #include "Serial.h"
 #include "ADC.h"
 #include "Vector.h"
 #include "DynamicTimer.h"
+#include "Console.h"
+#include "Clock.h"
+#include "Profiler.h"
+#include "CpuLoad.h"
+#include "TimerJitter.h"
+#include "Trace.h"
+#include "History.h"
+#include "EepromLog.h"
+#include "Checkpoint.h"
+#include "Debouncer.h"
+#include "TemperatureReport.h"
+#include "AdaptiveSampling.h"
+#include <avr/wdt.h>
 
 // Globala variabler:
 struct Led led1; 
 struct Button button; 
-struct Timer timer0; 
+struct TimerChannel debounce; 
 struct TempSensor tempSensor;
+struct TemperatureReport report;
+struct AdaptiveSampling adaptive;
 struct DynamicTimer timer1;
 
 // Funktionsdeklarationer:
 void setup(void);
+void loop(void);
+void debounce_elapsed(void);
+void button_pressed(void);
+void button_released(void);
+void temperature_measured(const int16_t temperature);
 
 
 #endif /* HEADER_H_ */
\ No newline at end of file
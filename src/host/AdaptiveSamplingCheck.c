@@ -0,0 +1,57 @@
+// Inkluderingsdirektiv:
+#include "Check.h"
+#include "../AdaptiveSampling.h"
+
+/******************************************************************************
+* Kontroller av den adaptiva avläsningens skalfaktor (se
+* AdaptiveSampling.h).
+******************************************************************************/
+
+/******************************************************************************
+* Funktionen check_adaptive_sampling kontrollerar att skalfaktorn halveras
+* vid snabb förändring ned till ADAPTIVE_MIN_SCALE, ökar vid stabil
+* temperatur upp till ADAPTIVE_MAX_SCALE samt förblir 1 när styrningen är
+* avstängd.
+******************************************************************************/
+void check_adaptive_sampling(void)
+{
+	struct AdaptiveSampling self = new_AdaptiveSampling();
+	int16_t temperature = 200;
+
+	CHECK(!AdaptiveSampling_update(&self, temperature));
+	Simulator_advance_ms(1000);
+	CHECK(!AdaptiveSampling_update(&self, temperature + 100));
+	CHECK(self.scale == DYNAMIC_TIMER_SCALE_ONE);
+
+	AdaptiveSampling_enable(&self, true);
+	Simulator_advance_ms(1000);
+	CHECK(AdaptiveSampling_update(&self, temperature));
+	CHECK(self.scale == DYNAMIC_TIMER_SCALE_ONE / 2);
+
+	for (uint8_t i = 0; i < 10; i++)
+	{
+		Simulator_advance_ms(1000);
+		temperature += 50;
+		AdaptiveSampling_update(&self, temperature);
+	}
+
+	CHECK(self.scale == ADAPTIVE_MIN_SCALE);
+	CHECK(!AdaptiveSampling_update(&self, temperature + 50));
+	uint16_t previous = self.scale;
+	bool monotonic = true;
+
+	for (uint8_t i = 0; i < 100; i++)
+	{
+		Simulator_advance_ms(1000);
+		AdaptiveSampling_update(&self, temperature + (i & 1));
+		if (self.scale < previous) monotonic = false;
+		previous = self.scale;
+	}
+
+	CHECK(monotonic);
+	CHECK(self.scale == ADAPTIVE_MAX_SCALE);
+
+	AdaptiveSampling_enable(&self, false);
+	CHECK(self.scale == DYNAMIC_TIMER_SCALE_ONE);
+	return;
+}
@@ -0,0 +1,106 @@
+// Inkluderingsdirektiv:
+#include "Check.h"
+
+/******************************************************************************
+* Funktionen check_heap_allocator kontrollerar att heap_allocator räknar
+* använt minne och high-water mark vid allokering, omallokering och
+* frigöring, samt att en allokering som inte kan uppfyllas räknas som
+* misslyckad utan att blocket går förlorat.
+******************************************************************************/
+void check_heap_allocator(void)
+{
+	const struct AllocatorStatistics before = *heap_allocator.statistics;
+	const struct AllocatorStatistics* statistics = heap_allocator.statistics;
+
+	uint8_t* block = heap_allocator.allocate(10);
+	CHECK(block != 0);
+	CHECK(statistics->used_bytes == before.used_bytes + 10);
+
+	for (uint8_t i = 0; i < 10; i++)
+		block[i] = i;
+
+	block = heap_allocator.reallocate(block, 100);
+	CHECK(block != 0 && block[9] == 9);
+	CHECK(statistics->used_bytes == before.used_bytes + 100);
+	block = heap_allocator.reallocate(block, 40);
+	CHECK(block != 0 && block[0] == 0 && block[9] == 9);
+	CHECK(statistics->used_bytes == before.used_bytes + 40);
+	CHECK(statistics->high_water_bytes >= before.used_bytes + 100);
+
+	CHECK(heap_allocator.reallocate(block, SIZE_MAX) == 0);
+	CHECK(statistics->failures == before.failures + 1);
+	CHECK(statistics->used_bytes == before.used_bytes + 40 && block[9] == 9);
+
+	void* second = heap_allocator.allocate(6);
+	CHECK(statistics->used_bytes == before.used_bytes + 46);
+	heap_allocator.deallocate(block);
+	CHECK(statistics->used_bytes == before.used_bytes + 6);
+	CHECK(heap_allocator.reallocate(second, 0) == 0);
+	heap_allocator.deallocate(0);
+	CHECK(statistics->used_bytes == before.used_bytes);
+
+	Check_capture_start();
+	Allocator_print(&heap_allocator);
+	const char* text = Check_capture_stop();
+	char line[48];
+	snprintf(line, sizeof(line), "High-water mark: %u bytes\n", statistics->high_water_bytes);
+	CHECK(strstr(text, line) != 0 && statistics->high_water_bytes > 0);
+	return;
+}
+
+#ifdef ENABLE_POOL_ALLOCATOR
+
+/******************************************************************************
+* Funktionen check_pool_allocator kontrollerar blockpoolens val av blockstorlek,
+* flytt till mindre block vid omallokering, misslyckade allokeringar när
+* poolen är slut samt att omallokering av block utanför poolen räknas som
+* misslyckad.
+******************************************************************************/
+void check_pool_allocator(void)
+{
+	const struct AllocatorStatistics before = *pool_allocator.statistics;
+	void* blocks[16];
+	uint8_t count = 0;
+
+	uint8_t* block = pool_allocator.allocate(10);
+	CHECK(block != 0);
+	CHECK(Pool_class_statistics(0).used == 1);
+	CHECK(pool_allocator.statistics->used_bytes == before.used_bytes + 16);
+
+	for (uint8_t i = 0; i < 10; i++)
+		block[i] = i;
+
+	block = pool_allocator.reallocate(block, 100);
+	CHECK(block != 0);
+	CHECK(Pool_class_statistics(0).used == 0 && Pool_class_statistics(3).used == 1);
+	CHECK(block[9] == 9);
+
+	block = pool_allocator.reallocate(block, 12);
+	CHECK(Pool_class_statistics(0).used == 1 && Pool_class_statistics(3).used == 0);
+	CHECK(block[0] == 0 && block[9] == 9);
+	pool_allocator.deallocate(block);
+	CHECK(pool_allocator.statistics->used_bytes == before.used_bytes);
+	CHECK(pool_allocator.statistics->high_water_bytes >= before.used_bytes + 128);
+
+	while (count < 16 && (blocks[count] = pool_allocator.allocate(16)))
+		count++;
+
+	CHECK(count == POOL_BLOCKS_16 + POOL_BLOCKS_32 + POOL_BLOCKS_64 + POOL_BLOCKS_128);
+	CHECK(pool_allocator.statistics->failures == before.failures + 1);
+	CHECK(Pool_class_statistics(0).exhausted > 0);
+	CHECK(pool_allocator.allocate(1) == 0);
+
+	while (count)
+		pool_allocator.deallocate(blocks[--count]);
+
+	CHECK(pool_allocator.statistics->used_bytes == before.used_bytes);
+	uint32_t foreign[4] = { 0 };
+	const uint16_t failed = pool_allocator.statistics->failures;
+	CHECK(pool_allocator.reallocate(foreign, 8) == 0);
+	CHECK(pool_allocator.statistics->failures == failed + 1);
+	CHECK(pool_allocator.allocate(0) == 0);
+	CHECK(pool_allocator.allocate(129) == 0);
+	return;
+}
+
+#endif /* ENABLE_POOL_ALLOCATOR */
@@ -0,0 +1,92 @@
+// Inkluderingsdirektiv:
+#include "Check.h"
+
+static uint32_t checks = 0;			// Antal genomförda kontroller.
+static uint32_t failures = 0;			// Antal misslyckade kontroller.
+static char output[CHECK_OUTPUT_SIZE];		// Transmitterade tecken sedan Check_capture_start.
+static size_t output_length = 0;		// Antal lagrade tecken i output.
+static uint32_t random_state = 1;		// Tillstånd för pseudoslumptal.
+
+// Statiska funktioner:
+static void capture(const char data);
+
+/******************************************************************************
+* Funktionen Check_result räknar en kontroll och skriver ut villkoret,
+* filen och radnumret ifall kontrollen misslyckades. Anropas via makrot
+* CHECK.
+******************************************************************************/
+void Check_result(const int passed, const char* condition, const char* file, const int line)
+{
+	checks++;
+	if (passed) return;
+	failures++;
+	printf("%s:%d: check failed: %s\n", file, line, condition);
+	return;
+}
+
+/******************************************************************************
+* Funktionerna Check_count och Check_failures returnerar antalet genomförda
+* respektive misslyckade kontroller.
+******************************************************************************/
+uint32_t Check_count(void)
+{
+	return checks;
+}
+
+uint32_t Check_failures(void)
+{
+	return failures;
+}
+
+/******************************************************************************
+* Funktionerna Check_capture_start och Check_capture_stop lagrar
+* transmitterade tecken i bufferten output. Funktionen Check_capture_stop
+* återställer utskrift till terminalen och returnerar lagrad text.
+******************************************************************************/
+void Check_capture_start(void)
+{
+	Simulator_flush();
+	output_length = 0;
+	output[0] = '\0';
+	Simulator_set_output(capture);
+	return;
+}
+
+const char* Check_capture_stop(void)
+{
+	Simulator_flush();
+	Simulator_set_output(0);
+	return output;
+}
+
+/******************************************************************************
+* Funktionen Check_random returnerar pseudoslumptal (linjär kongruens), så
+* att kontrollerna ger samma resultat vid varje körning.
+******************************************************************************/
+uint32_t Check_random(void)
+{
+	random_state = random_state * 1103515245UL + 12345UL;
+	return (random_state >> 16) & 0x7FFF;
+}
+
+/******************************************************************************
+* Funktionen Check_advance_ticks flyttar fram simulerad tid ett exakt antal
+* av klockans uppräkningar (64 klockcykler vardera, se Clock.h).
+******************************************************************************/
+void Check_advance_ticks(const uint32_t ticks)
+{
+	Simulator_advance((uint64_t)ticks * (SIMULATOR_F_CPU / 1000000UL) * CLOCK_TICK_US);
+	return;
+}
+
+/******************************************************************************
+* Funktionen capture lagrar ett transmitterat tecken, där vagnreturer och
+* nolltecken utelämnas.
+******************************************************************************/
+static void capture(const char data)
+{
+	if (data == '\r' || data == '\0' || output_length >= CHECK_OUTPUT_SIZE - 1) return;
+	output[output_length++] = data;
+	output[output_length] = '\0';
+	return;
+}
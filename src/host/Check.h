@@ -0,0 +1,65 @@
+#ifndef CHECK_H_
+#define CHECK_H_
+
+// Inkluderingsdirektiv:
+#include "../header.h"
+#include "Simulator.h"
+#include <stdio.h>
+#include <string.h>
+
+/******************************************************************************
+* Kontroller av programmets moduler vid kompilering för PC (HOST_BUILD).
+* Modulerna anropas direkt via simulatorn (se Simulator.h), utan setup och
+* loop, och resultaten jämförs med förväntade värden via makrot CHECK.
+* Kontrollerna för respektive modul ligger i en egen fil (*Check.c), vars
+* funktion anropas från check_main.c. Misslyckade kontroller skrivs ut med
+* fil och radnummer.
+*
+* Transmitterade tecken kan lagras via Check_capture_start och
+* Check_capture_stop, så att modulernas utskrifter kan jämföras med
+* förväntad text. Vagnreturer och nolltecken utelämnas.
+******************************************************************************/
+
+#define CHECK_OUTPUT_SIZE 2048	// Storlek på buffert för transmitterade tecken.
+
+#define CHECK(condition) Check_result((condition), #condition, __FILE__, __LINE__)
+
+// Funktionsdeklarationer:
+void Check_result(const int passed, const char* condition, const char* file, const int line);
+uint32_t Check_count(void);
+uint32_t Check_failures(void);
+void Check_capture_start(void);
+const char* Check_capture_stop(void);
+uint32_t Check_random(void);
+void Check_advance_ticks(const uint32_t ticks);
+
+// Kontroller per modul:
+void check_sensor_model(void);
+void check_temperature_format(void);
+void check_temperature_report(void);
+void check_temperature_report_change(void);
+void check_vector(void);
+void check_typed_vector(void);
+void check_vector_limits(void);
+void check_heap_allocator(void);
+void check_estimators(void);
+void check_trimmed_mean(void);
+void check_timer(void);
+void check_timer_channel(void);
+void check_dynamic_timer_report(void);
+void check_dynamic_timer_rescale(void);
+void check_cpu_load(void);
+void check_trace(void);
+void check_history(void);
+void check_eeprom_log(void);
+void check_restore(void);
+void check_checkpoint(void);
+void check_pin_change(void);
+void check_debouncer(void);
+void check_adaptive_sampling(void);
+void check_timer_jitter(void);
+#ifdef ENABLE_POOL_ALLOCATOR
+void check_pool_allocator(void);
+#endif
+
+#endif /* CHECK_H_ */
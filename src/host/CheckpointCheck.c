@@ -0,0 +1,115 @@
+// Inkluderingsdirektiv:
+#include "Check.h"
+#include "../Checkpoint.h"
+#include <stddef.h>
+
+/******************************************************************************
+* Kontroller av den dynamiska timerns kontrollpunkt (se Checkpoint.h samt
+* DynamicTimer_restore i DynamicTimer.h).
+******************************************************************************/
+
+/******************************************************************************
+* Funktionen check_restore kontrollerar att DynamicTimer_restore godtar en
+* giltig kontrollpunkt och avvisar okänd strategi samt kapacitet som är
+* noll eller överstiger MAX_CAPACITY.
+******************************************************************************/
+void check_restore(void)
+{
+	struct DynamicTimer timer = new_DynamicTimer(TIMER1, 10);
+	struct DynamicTimerCheckpoint checkpoint;
+	memset(&checkpoint, 0, sizeof(checkpoint));
+	checkpoint.required_interrupts = 150;
+	checkpoint.estimate = 150;
+	checkpoint.estimator = ESTIMATOR_MEAN;
+	checkpoint.quantile = 50;
+	checkpoint.count = 3;
+	checkpoint.capacity = 8;
+	checkpoint.intervals[0] = 140;
+	checkpoint.intervals[1] = 150;
+	checkpoint.intervals[2] = 160;
+
+	Check_capture_start();
+	CHECK(DynamicTimer_restore(&timer, &checkpoint));
+	Check_capture_stop();
+	CHECK(timer.capacity == 8 && timer.interrupt_vector.elements == 3);
+	CHECK(timer.timer.required_interrupts == 150);
+
+	checkpoint.capacity = 0;
+	CHECK(!DynamicTimer_restore(&timer, &checkpoint));
+	checkpoint.capacity = MAX_CAPACITY + 1;
+	CHECK(!DynamicTimer_restore(&timer, &checkpoint));
+	checkpoint.capacity = 8;
+	checkpoint.estimator = ESTIMATOR_QUANTILE + 1;
+	CHECK(!DynamicTimer_restore(&timer, &checkpoint));
+	CHECK(timer.capacity == 8 && timer.interrupt_vector.elements == 3);
+
+	DynamicTimer_clear(&timer);
+	return;
+}
+
+/******************************************************************************
+* Funktionen check_checkpoint kontrollerar att Checkpoint_process skriver en
+* ändrad kontrollpunkt som Checkpoint_restore sedan återställer, samt att
+* ingen skrivning påbörjas innan CHECKPOINT_PERIOD sekunder har passerat,
+* när kontrollpunkten är oförändrad eller när ingen fördröjningstid har
+* skattats. En kontrollpunkt med felaktig kontrollsumma återställs inte.
+******************************************************************************/
+void check_checkpoint(void)
+{
+	struct DynamicTimer timer = new_DynamicTimer(TIMER1, 10);
+	struct DynamicTimer restored = new_DynamicTimer(TIMER1, 10);
+	struct DynamicTimerCheckpoint checkpoint;
+	memset(&checkpoint, 0, sizeof(checkpoint));
+	checkpoint.required_interrupts = 150;
+	checkpoint.estimate = 150;
+	checkpoint.estimator = ESTIMATOR_MEAN;
+	checkpoint.count = 2;
+	checkpoint.capacity = 10;
+	checkpoint.intervals[0] = 140;
+	checkpoint.intervals[1] = 160;
+
+	Check_capture_start();
+	DynamicTimer_restore(&timer, &checkpoint);
+	Simulator_advance_ms(CHECKPOINT_PERIOD * 1000UL);
+	Checkpoint_process(&timer);
+	CHECK(Eeprom_busy());
+
+	while (Eeprom_busy()) Simulator_advance_ms(1);
+	Checkpoint_process(&timer);
+	CHECK(Checkpoint_restore(&restored));
+	CHECK(restored.timer.required_interrupts == 150 && restored.interrupt_vector.elements == 2);
+	CHECK(restored.interrupt_vector.data[0] == 140 && restored.interrupt_vector.data[1] == 160);
+
+	Simulator_advance_ms(CHECKPOINT_PERIOD * 1000UL);
+	Checkpoint_process(&timer);
+	CHECK(!Eeprom_busy());
+
+	checkpoint.required_interrupts = 200;
+	DynamicTimer_restore(&timer, &checkpoint);
+	Simulator_advance_ms(1000);
+	Checkpoint_process(&timer);
+	CHECK(!Eeprom_busy());
+	Simulator_advance_ms(CHECKPOINT_PERIOD * 1000UL);
+	Checkpoint_process(&timer);
+	CHECK(Eeprom_busy());
+
+	while (Eeprom_busy()) Simulator_advance_ms(1);
+	Checkpoint_process(&timer);
+	DynamicTimer_clear(&timer);
+	timer.timer.required_interrupts = 0;
+	Simulator_advance_ms(CHECKPOINT_PERIOD * 1000UL);
+	Checkpoint_process(&timer);
+	CHECK(!Eeprom_busy());
+	CHECK(Checkpoint_restore(&restored) && restored.timer.required_interrupts == 200);
+
+	uint8_t corrupted;
+	Eeprom_read(CHECKPOINT_ADDRESS + offsetof(struct DynamicTimerCheckpoint, estimate), &corrupted, 1);
+	corrupted ^= 0x01;
+	Eeprom_write(CHECKPOINT_ADDRESS + offsetof(struct DynamicTimerCheckpoint, estimate), &corrupted, 1);
+	while (Eeprom_busy()) Simulator_advance_ms(1);
+	CHECK(!Checkpoint_restore(&restored));
+	Check_capture_stop();
+
+	DynamicTimer_clear(&restored);
+	return;
+}
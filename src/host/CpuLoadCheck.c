@@ -0,0 +1,80 @@
+// Inkluderingsdirektiv:
+#include "Check.h"
+#include "../CpuLoad.h"
+
+/******************************************************************************
+* Kontroller av processorbelastningens mätfönster (se CpuLoad.h), där tid i
+* huvudloopen, i avbrottsrutiner samt vilotid simuleras genom att tiden
+* flyttas fram ett exakt antal av klockans uppräkningar.
+******************************************************************************/
+
+#ifdef CPU_LOAD_ENABLED
+// Statiska funktioner:
+static void run_window(const uint32_t isr_ms, const uint32_t main_ms);
+#endif /* CPU_LOAD_ENABLED */
+
+/******************************************************************************
+* Funktionen check_cpu_load kontrollerar att tid i avbrottsrutiner dras bort
+* från huvudloopens tid, att vilotiden utgör resterande del av fönstret,
+* att fönstren skrivs ut med senaste fönstret först samt att högsta
+* belastning behålls. Efter fler än CPU_LOAD_WINDOWS fönster skrivs enbart
+* de senaste ut, medan ett blockerat varv som förlänger fönstret mäts mot
+* fönstrets faktiska längd.
+******************************************************************************/
+void check_cpu_load(void)
+{
+#ifdef CPU_LOAD_ENABLED
+	CpuLoad_reset();
+	run_window(1, 4);
+	run_window(2, 6);
+
+	Check_capture_start();
+	CpuLoad_print();
+	CHECK(!strcmp(Check_capture_stop(), "CPU load, 1000 ms windows:\n"
+		"    isr 20.0%, main 40.0%, idle 40.0%\n"
+		"    isr 10.0%, main 30.0%, idle 60.0%\n"
+		"peak isr 20.0%, main 40.0%, idle 40.0%\n"));
+
+	for (uint8_t i = 0; i < CPU_LOAD_WINDOWS; i++) run_window(0, 1);
+	CpuLoad_begin();
+	Check_advance_ticks(2000UL * CLOCK_TICKS_PER_MS);
+	CpuLoad_end();
+
+	Check_capture_start();
+	CpuLoad_print();
+	const char* text = Check_capture_stop();
+	CHECK(!strncmp(text, "CPU load, 1000 ms windows:\n    isr 0.0%, main 100.0%, idle 0.0%\n", 64));
+	CHECK(strstr(text, "isr 20.0%") == 0 && strstr(text, "isr 10.0%") == 0);
+	CHECK(strstr(text, "    isr 0.0%, main 10.0%, idle 90.0%\n") != 0);
+	CHECK(strstr(text, "peak isr 0.0%, main 100.0%, idle 0.0%\n") != 0);
+
+	uint8_t lines = 0;
+	for (const char* c = text; *c; c++) if (*c == '\n') lines++;
+	CHECK(lines == CPU_LOAD_WINDOWS + 2);
+	CpuLoad_reset();
+#endif /* CPU_LOAD_ENABLED */
+	return;
+}
+
+#ifdef CPU_LOAD_ENABLED
+/******************************************************************************
+* Funktionen run_window simulerar ett mätfönster om 100 varv à 10 ms, där
+* varje varv inleds med vilotid, följt av huvudloopen i main_ms
+* millisekunder, varav en avbrottsrutin i isr_ms millisekunder.
+******************************************************************************/
+static void run_window(const uint32_t isr_ms, const uint32_t main_ms)
+{
+	for (uint8_t i = 0; i < 100; i++)
+	{
+		Check_advance_ticks((10 - main_ms) * CLOCK_TICKS_PER_MS);
+		CpuLoad_begin();
+		Check_advance_ticks((main_ms - isr_ms) * CLOCK_TICKS_PER_MS);
+		const uint16_t start = Clock_now16();
+		Check_advance_ticks(isr_ms * CLOCK_TICKS_PER_MS);
+		CpuLoad_interrupt(start);
+		CpuLoad_end();
+	}
+
+	return;
+}
+#endif /* CPU_LOAD_ENABLED */
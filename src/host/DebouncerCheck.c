@@ -0,0 +1,68 @@
+// Inkluderingsdirektiv:
+#include "Check.h"
+#include "../Debouncer.h"
+#include "../PinChange.h"
+
+/******************************************************************************
+* Kontroller av den periodiska avläsningen av tryckknappar med vertikala
+* räknare (se Debouncer.h).
+******************************************************************************/
+
+static uint32_t pressed_count[2], released_count[2];	// Anrop av callbackfunktioner för PIN 2 respektive PIN 3.
+
+// Statiska funktioner:
+static void pressed0(void);
+static void released0(void);
+static void pressed1(void);
+static void released1(void);
+
+/******************************************************************************
+* Funktionen check_debouncer kontrollerar att studsar kortare än
+* DEBOUNCE_SAMPLES avläsningar ignoreras och att en stabil nivå ger
+* exakt en nedtryckning respektive ett släpp, utan anrop för PIN 2 på
+* samma port.
+******************************************************************************/
+void check_debouncer(void)
+{
+	Simulator_set_pin('D', 2, 0);
+	Simulator_set_pin('D', 3, 0);
+	PinChange_attach(IO_PORTD, 2, pressed0, released0);
+	PinChange_attach(IO_PORTD, 3, pressed1, released1);
+	init_Debouncer();
+	Simulator_advance_ms(10);
+
+	Simulator_set_pin('D', 3, 1);
+	Simulator_advance_ms(2);
+	Simulator_set_pin('D', 3, 0);
+	Simulator_advance_ms(10);
+	CHECK(pressed_count[1] == 0 && released_count[1] == 0);
+
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		Simulator_set_pin('D', 3, 1);
+		Simulator_advance_ms(1);
+		Simulator_set_pin('D', 3, 0);
+		Simulator_advance_ms(1);
+	}
+
+	Simulator_set_pin('D', 3, 1);
+	Simulator_advance_ms(DEBOUNCE_SAMPLES * DEBOUNCE_PERIOD + 2);
+	CHECK(pressed_count[1] == 1 && released_count[1] == 0);
+	Simulator_advance_ms(50);
+	CHECK(pressed_count[1] == 1);
+
+	Simulator_set_pin('D', 3, 0);
+	Simulator_advance_ms(1);
+	Simulator_set_pin('D', 3, 1);
+	Simulator_advance_ms(1);
+	Simulator_set_pin('D', 3, 0);
+	Simulator_advance_ms(DEBOUNCE_SAMPLES * DEBOUNCE_PERIOD + 2);
+	CHECK(pressed_count[1] == 1 && released_count[1] == 1);
+	CHECK(pressed_count[0] == 0 && released_count[0] == 0);
+	return;
+}
+
+static void pressed0(void) { pressed_count[0]++; }
+static void released0(void) { released_count[0]++; }
+static void pressed1(void) { pressed_count[1]++; }
+static void released1(void) { released_count[1]++; }
@@ -0,0 +1,127 @@
+// Inkluderingsdirektiv:
+#include "Check.h"
+#include "../DynamicTimer.h"
+
+/******************************************************************************
+* Kontroller av den dynamiska timerns uppdatering från avbrottsrutinen,
+* omskalning av pågående period samt utskrift från huvudloopen (se
+* DynamicTimer.h).
+******************************************************************************/
+
+#if DYNAMIC_TIMER_UPDATE == UPDATE_RESCALE
+// Statiska funktioner:
+static uint32_t random_bits(const uint8_t bits);
+#endif /* DYNAMIC_TIMER_UPDATE */
+
+/******************************************************************************
+* Funktionen check_dynamic_timer_report kontrollerar att DynamicTimer_update
+* inte skriver ut något, att summan i DynamicTimer_snapshot motsvarar
+* vektorns summa även efter att äldsta intervall har skrivits över och
+* kapaciteten har minskats, samt att start och ändrad kapacitet skrivs ut en
+* gång från huvudloopen via DynamicTimer_report.
+******************************************************************************/
+void check_dynamic_timer_report(void)
+{
+	struct DynamicTimer timer = new_DynamicTimer(TIMER1, 20);
+	uint32_t mismatches = 0;
+	char expected[64];
+
+	Check_capture_start();
+	DynamicTimer_update(&timer);
+	CHECK(*Check_capture_stop() == '\0');
+
+	Check_capture_start();
+	DynamicTimer_report(&timer);
+	CHECK(strstr(Check_capture_stop(), "Dynamic timer initiated!") != NULL);
+	Check_capture_start();
+	DynamicTimer_report(&timer);
+	CHECK(*Check_capture_stop() == '\0');
+
+	Check_capture_start();
+
+	for (uint8_t i = 0; i < 30; i++)
+	{
+		timer.interrupt_counter = Check_random() % 500 + 1;
+		DynamicTimer_update(&timer);
+		if (DynamicTimer_snapshot(&timer).sum != Vector_sum(&timer.interrupt_vector)) mismatches++;
+	}
+
+	CHECK(*Check_capture_stop() == '\0');
+	CHECK(mismatches == 0);
+	CHECK(timer.capacity == 10 && timer.interrupt_vector.elements == 10);
+
+	Check_capture_start();
+	DynamicTimer_report(&timer);
+	const char* output = Check_capture_stop();
+	snprintf(expected, sizeof(expected), "Sum of stored elements: %lu\n", (unsigned long)Vector_sum(&timer.interrupt_vector));
+	CHECK(strstr(output, "Vector capacity resized to 10 elements!") != NULL);
+	CHECK(strstr(output, expected) != NULL);
+	CHECK(strstr(output, "Dynamic timer initiated!") == NULL);
+
+	DynamicTimer_clear(&timer);
+	CHECK(DynamicTimer_snapshot(&timer).sum == 0);
+	return;
+}
+
+/******************************************************************************
+* Funktionen check_dynamic_timer_rescale kontrollerar omskalningen av
+* exekverade avbrott vid UPDATE_RESCALE, där ny fördröjningstid tillämpas
+* via DynamicTimer_set_scale. Resultatet jämförs med exakt 64-bitars
+* beräkning för slumpmässiga värden, där felet högst får uppgå till
+* required / 2^14 plus ett avbrott, och måste alltid understiga den nya
+* fördröjningstiden, även då exekverade avbrott når föregående.
+******************************************************************************/
+void check_dynamic_timer_rescale(void)
+{
+#if DYNAMIC_TIMER_UPDATE == UPDATE_RESCALE
+	struct DynamicTimer timer = new_DynamicTimer(TIMER1, 10);
+	uint32_t mismatches = 0;
+	uint32_t expired = 0;
+
+	for (uint16_t i = 0; i < 2000; i++)
+	{
+		const uint32_t previous = random_bits((uint8_t)(Check_random() % 32 + 1));
+		const uint32_t required = random_bits((uint8_t)(Check_random() % 32 + 1));
+		if (previous < 2 || !required) continue;
+
+		const uint32_t executed = i % 4 ? random_bits(32) % previous : previous - 1;
+		const uint32_t exact = (uint32_t)((uint64_t)executed * required / previous);
+		timer.timer.required_interrupts = previous;
+		timer.timer.executed_interrupts = executed;
+		timer.estimator.estimate = required;
+		DynamicTimer_set_scale(&timer, DYNAMIC_TIMER_SCALE_ONE);
+
+		const uint32_t result = timer.timer.executed_interrupts;
+		const uint32_t error = result > exact ? result - exact : exact - result;
+		if (error > (required >> 14) + 1) mismatches++;
+		if (result >= required || timer.timer.required_interrupts != required) expired++;
+	}
+
+	CHECK(mismatches == 0);
+	CHECK(expired == 0);
+
+	timer.timer.required_interrupts = 1000;
+	timer.timer.executed_interrupts = 250;
+	timer.estimator.estimate = 4000;
+	DynamicTimer_set_scale(&timer, DYNAMIC_TIMER_SCALE_ONE);
+	CHECK(timer.timer.executed_interrupts == 1000);
+	timer.timer.executed_interrupts = 4000;
+	timer.estimator.estimate = 1;
+	DynamicTimer_set_scale(&timer, DYNAMIC_TIMER_SCALE_ONE);
+	CHECK(timer.timer.executed_interrupts == 0);
+	DynamicTimer_clear(&timer);
+#endif /* DYNAMIC_TIMER_UPDATE */
+	return;
+}
+
+#if DYNAMIC_TIMER_UPDATE == UPDATE_RESCALE
+/******************************************************************************
+* Funktionen random_bits returnerar ett pseudoslumptal om högst bits bitar
+* (1 - 32), sammansatt av tre anrop av Check_random.
+******************************************************************************/
+static uint32_t random_bits(const uint8_t bits)
+{
+	const uint32_t value = (Check_random() << 17) ^ (Check_random() << 2) ^ Check_random();
+	return bits < 32 ? value & ((1UL << bits) - 1) : value;
+}
+#endif /* DYNAMIC_TIMER_UPDATE */
@@ -0,0 +1,118 @@
+// Inkluderingsdirektiv:
+#include "Check.h"
+#include "../EepromLog.h"
+#include <stddef.h>
+#include <util/crc16.h>
+
+/******************************************************************************
+* Kontroller av EEPROM-loggen (se EepromLog.h), där poster skrivs direkt
+* till givna platser i EEPROM-minnet innan loggen initieras.
+******************************************************************************/
+
+// Statiska funktioner:
+static void write_slot(const uint8_t slot, const uint16_t sequence, const int16_t value, const bool valid);
+static void erase_log(void);
+static void wait_eeprom(void);
+
+/******************************************************************************
+* Funktionen check_eeprom_log kontrollerar att init_EepromLog fortsätter
+* efter posten med högst sekvensnummer oavsett plats, även när
+* sekvensnumret har slagit runt, att poster med felaktig kontrollsumma
+* hoppas över samt att nästa post skrivs till platsen efter den senaste.
+******************************************************************************/
+void check_eeprom_log(void)
+{
+	struct EepromRecord record;
+
+	erase_log();
+	write_slot(2, 4, 100, true);
+	write_slot(3, 5, 101, true);
+	write_slot(4, 6, 102, true);
+	init_EepromLog();
+	CHECK(!EepromLog_read(0, &record));
+	CHECK(EepromLog_read(EEPROM_LOG_SLOTS - 1, &record) && record.sequence == 6 && record.samples[0].value == 102);
+	CHECK(EepromLog_read(EEPROM_LOG_SLOTS - 3, &record) && record.sequence == 4);
+
+	for (uint8_t i = 0; i < EEPROM_LOG_SAMPLES; i++)
+		EepromLog_append(200 + i);
+
+	for (uint8_t i = 0; i < 200; i++)
+	{
+		EepromLog_process();
+		Simulator_advance_ms(1);
+	}
+
+	Eeprom_read(EEPROM_LOG_ADDRESS + 5 * sizeof(record), &record, sizeof(record));
+	CHECK(record.sequence == 7 && record.count == EEPROM_LOG_SAMPLES && record.samples[5].value == 205);
+	CHECK(EepromLog_read(EEPROM_LOG_SLOTS - 1, &record) && record.sequence == 7);
+
+	erase_log();
+	write_slot(10, 0xFFF0, 300, true);
+	write_slot(0, 0xFFFE, 301, true);
+	write_slot(1, 0xFFFF, 302, true);
+	write_slot(2, 0x0000, 303, true);
+	write_slot(3, 0x0001, 304, true);
+	init_EepromLog();
+	CHECK(EepromLog_read(EEPROM_LOG_SLOTS - 1, &record) && record.sequence == 0x0001);
+	CHECK(!EepromLog_read(0, &record));
+
+	write_slot(3, 0x0001, 304, false);
+	init_EepromLog();
+	CHECK(EepromLog_read(EEPROM_LOG_SLOTS - 1, &record) && record.sequence == 0x0000 && record.samples[0].value == 303);
+	CHECK(!EepromLog_read(0, &record));
+
+	erase_log();
+	init_EepromLog();
+	CHECK(!EepromLog_read(EEPROM_LOG_SLOTS - 1, &record));
+	return;
+}
+
+/******************************************************************************
+* Funktionen write_slot skriver en post med ett mätvärde till en given
+* plats. Kontrollsumman beräknas som i EepromLog.c, där en ogiltig post
+* får en kontrollsumma som inte motsvarar innehållet.
+******************************************************************************/
+static void write_slot(const uint8_t slot, const uint16_t sequence, const int16_t value, const bool valid)
+{
+	struct EepromRecord record;
+	memset(&record, 0, sizeof(record));
+	record.sequence = sequence;
+	record.count = 1;
+	record.samples[0].value = value;
+
+	const uint8_t* data = (const uint8_t*)&record;
+
+	for (uint8_t i = 0; i < sizeof(record); i++)
+	{
+		if (i != offsetof(struct EepromRecord, checksum)) record.checksum = _crc8_ccitt_update(record.checksum, data[i]);
+	}
+
+	if (!valid) record.checksum ^= 0x01;
+	while (!Eeprom_write(EEPROM_LOG_ADDRESS + slot * sizeof(record), &record, sizeof(record))) Simulator_advance_ms(1);
+	wait_eeprom();
+	return;
+}
+
+/******************************************************************************
+* Funktionen erase_log raderar samtliga platser (0xFF), motsvarande ett
+* oanvänt EEPROM-minne.
+******************************************************************************/
+static void erase_log(void)
+{
+	uint8_t erased[sizeof(struct EepromRecord)];
+	memset(erased, 0xFF, sizeof(erased));
+
+	for (uint8_t slot = 0; slot < EEPROM_LOG_SLOTS; slot++)
+	{
+		while (!Eeprom_write(EEPROM_LOG_ADDRESS + slot * sizeof(erased), erased, sizeof(erased))) Simulator_advance_ms(1);
+		wait_eeprom();
+	}
+
+	return;
+}
+
+static void wait_eeprom(void)
+{
+	while (Eeprom_busy()) Simulator_advance_ms(1);
+	return;
+}
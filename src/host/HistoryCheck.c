@@ -0,0 +1,73 @@
+// Inkluderingsdirektiv:
+#include "Check.h"
+#include "../History.h"
+
+/******************************************************************************
+* Kontroller av den deltakomprimerade temperaturhistoriken (se History.h).
+******************************************************************************/
+
+/******************************************************************************
+* Funktionen check_history lagrar mätvärden med upprepningar och ändrade
+* intervall och jämför avkodade mätvärden med lagrade. Därefter lagras
+* varierande mätvärden tills äldsta blocken skrivs över, varvid de
+* senaste History_samples mätvärdena skall kunna läsas ut.
+******************************************************************************/
+void check_history(void)
+{
+	static struct HistorySample stored[400];
+	struct HistorySample sample;
+	uint16_t count = 0;
+	uint16_t read = 0;
+	bool equal = true;
+
+	History_clear();
+	CHECK(History_samples() == 0);
+
+	for (uint8_t i = 0; i < 60; i++)
+	{
+		Simulator_advance_ms(i == 30 ? 5000 : 2000);
+		stored[count].time = Clock_seconds();
+		stored[count].value = 200 + i / 10 - (i == 45 ? 300 : 0);
+		History_append(stored[count++].value);
+	}
+
+	CHECK(History_samples() == count);
+	struct HistoryReader reader = new_HistoryReader();
+
+	while (HistoryReader_next(&reader, &sample))
+	{
+		if (read >= count || sample.time != stored[read].time || sample.value != stored[read].value) equal = false;
+		read++;
+	}
+
+	CHECK(equal && read == count);
+
+	History_clear();
+	count = 0;
+
+	for (uint16_t i = 0; i < 400; i++)
+	{
+		Simulator_advance_ms(1000 + (i % 7 ? 0 : 1000));
+		stored[count].time = Clock_seconds();
+		stored[count].value = (int16_t)((int32_t)Check_random() % 4000 - 2000);
+		History_append(stored[count++].value);
+	}
+
+	const uint32_t samples = History_samples();
+	CHECK(samples > 0 && samples < count);
+	CHECK(History_bytes() <= HISTORY_BLOCKS * HISTORY_BLOCK_SIZE);
+	reader = new_HistoryReader();
+	read = 0;
+	equal = true;
+
+	while (HistoryReader_next(&reader, &sample))
+	{
+		const struct HistorySample* expected = &stored[count - samples + read];
+		if (read >= samples || sample.time != expected->time || sample.value != expected->value) equal = false;
+		read++;
+	}
+
+	CHECK(equal && read == samples);
+	History_clear();
+	return;
+}
@@ -0,0 +1,137 @@
+// Inkluderingsdirektiv:
+#include "Check.h"
+#include "../IntervalEstimator.h"
+
+/******************************************************************************
+* Kontroller av skattningen av intervall mellan knapptryckningar (se
+* IntervalEstimator.h), för samtliga strategier.
+******************************************************************************/
+
+/******************************************************************************
+* Funktionen check_estimators kontrollerar medelvärde, glidande medelvärde,
+* median och kvantil (inklusive omstart efter ESTIMATOR_P2_WINDOW intervall)
+* samt att senaste skattningen behålls vid byte av strategi.
+******************************************************************************/
+void check_estimators(void)
+{
+	struct Vector history = new_Vector();
+	struct IntervalEstimator self = new_IntervalEstimator(INTERVAL_ESTIMATOR);
+	CHECK(self.type == ESTIMATOR_MEAN && IntervalEstimator_uses_history(&self));
+
+	Vector_push(&history, 10);
+	Vector_push(&history, 20);
+	Vector_push(&history, 31);
+	CHECK(IntervalEstimator_update(&self, 31, &history) == 20);
+	Vector_clear(&history);
+
+	IntervalEstimator_set_type(&self, ESTIMATOR_EWMA);
+	CHECK(!IntervalEstimator_uses_history(&self));
+	CHECK(self.estimate == 20);
+	CHECK(IntervalEstimator_update(&self, 100, &history) == 100);
+	CHECK(IntervalEstimator_update(&self, 200, &history) == 125);
+	CHECK(IntervalEstimator_update(&self, 200, &history) == 144);
+
+	IntervalEstimator_set_type(&self, ESTIMATOR_MEDIAN);
+	CHECK(self.estimate == 144);
+
+	for (uint8_t i = 0; i < 20; i++)
+		CHECK(IntervalEstimator_update(&self, 100, &history) == 100);
+
+	self = new_IntervalEstimator(ESTIMATOR_MEDIAN);
+
+	for (uint8_t i = 0; i < 31; i++)
+		IntervalEstimator_update(&self, (uint32_t)(i * 17 % 31 + 1) * 10, &history);
+
+	CHECK(self.estimate >= 140 && self.estimate <= 180);
+
+	IntervalEstimator_set_type(&self, ESTIMATOR_QUANTILE);
+	IntervalEstimator_set_quantile(&self, 90);
+	CHECK(self.quantile == 90);
+
+	for (uint8_t i = 0; i < ESTIMATOR_P2_WINDOW; i++)
+		IntervalEstimator_update(&self, (uint32_t)(i * 13 % 32 + 1) * 10, &history);
+
+	CHECK(self.estimate >= 250 && self.estimate <= 320);
+
+	for (uint8_t i = 0; i < ESTIMATOR_P2_WINDOW + 8; i++)
+		IntervalEstimator_update(&self, 1000, &history);
+
+	CHECK(self.estimate == 1000);
+	IntervalEstimator_set_quantile(&self, 0);
+	IntervalEstimator_set_quantile(&self, 100);
+	CHECK(self.quantile == 90);
+	return;
+}
+
+/******************************************************************************
+* Funktionen check_trimmed_mean matar en vektor, som skrivs över cykliskt
+* precis som den dynamiska timerns, med pseudoslumpade intervall och
+* jämför varje skattning med medelvärdet av sorterade intervall, där
+* en åttondel (minst ett) exkluderas i vardera änden. Den sorterade
+* kopian kontrolleras även efter tömning och IntervalEstimator_sync.
+******************************************************************************/
+void check_trimmed_mean(void)
+{
+	const size_t capacity = 16;
+	struct Vector history = new_Vector();
+	struct IntervalEstimator self = new_IntervalEstimator(ESTIMATOR_TRIMMED_MEAN);
+	uint32_t sorted[16];
+	size_t next = 0;
+	uint32_t mismatches = 0;
+
+	for (uint16_t step = 0; step < 500; step++)
+	{
+		const uint32_t interval = Check_random() % 50 + 1;
+
+		if (history.elements < capacity) Vector_push(&history, interval);
+		else
+		{
+			IntervalEstimator_remove(&self, history.data[next]);
+			Vector_set(&history, next, interval);
+		}
+
+		next = (next + 1) % capacity;
+		const uint32_t estimate = IntervalEstimator_update(&self, interval, &history);
+		const size_t elements = history.elements;
+		memcpy(sorted, history.data, elements * sizeof(uint32_t));
+
+		for (size_t i = 1; i < elements; i++)
+		{
+			const uint32_t value = sorted[i];
+			size_t j = i;
+			for (; j > 0 && sorted[j - 1] > value; j--) sorted[j] = sorted[j - 1];
+			sorted[j] = value;
+		}
+
+		uint32_t expected;
+
+		if (elements < 3) expected = (uint32_t)(Vector_average(&history) + 0.5);
+		else
+		{
+			const size_t trim = elements / ESTIMATOR_TRIM_DIVISOR ? elements / ESTIMATOR_TRIM_DIVISOR : 1;
+			const size_t kept = elements - 2 * trim;
+			uint32_t sum = 0;
+			for (size_t i = trim; i < elements - trim; i++) sum += sorted[i];
+			expected = (sum + kept / 2) / kept;
+		}
+
+		if (estimate != expected || memcmp(self.sorted.data, sorted, elements * sizeof(uint32_t))) mismatches++;
+	}
+
+	CHECK(mismatches == 0);
+
+	Vector_clear(&history);
+	IntervalEstimator_sync(&self, &history);
+	CHECK(self.sorted.elements == 0);
+	Vector_push(&history, 30);
+	Vector_push(&history, 10);
+	Vector_push(&history, 20);
+	IntervalEstimator_sync(&self, &history);
+	CHECK(self.sorted.elements == 3 && self.sorted.data[0] == 10 && self.sorted.data[2] == 30);
+	CHECK(IntervalEstimator_update(&self, 40, &history) == 20);
+
+	IntervalEstimator_set_type(&self, ESTIMATOR_EWMA);
+	CHECK(self.sorted.elements == 0);
+	Vector_clear(&history);
+	return;
+}
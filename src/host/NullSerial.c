@@ -0,0 +1,37 @@
+// Inkluderingsdirektiv:
+#include "../Serial.h"
+
+/******************************************************************************
+* Ersätter Serial.c i simuleringar där utskrifter saknar betydelse, exempelvis
+* vid mätning av den dynamiska timerns anpassning (se press_main.c), så att
+* tiden för utskrifter inte påverkar uppmätt tid per uppdatering.
+******************************************************************************/
+void init_serial(void)
+{
+	return;
+}
+
+void serial_print(const char* s)
+{
+	return;
+}
+
+void serial_print_integer(const char* s, const int32_t number)
+{
+	return;
+}
+
+void serial_print_unsigned(const char* s, const uint32_t number)
+{
+	return;
+}
+
+void serial_print_P(const char* s)
+{
+	return;
+}
+
+void serial_printf_P(const char* format, ...)
+{
+	return;
+}
@@ -0,0 +1,50 @@
+// Inkluderingsdirektiv:
+#include "Check.h"
+#include "../PinChange.h"
+
+/******************************************************************************
+* Kontroller av PCI-avbrottens fördelning till registrerade
+* callbackfunktioner (se PinChange.h).
+******************************************************************************/
+
+static uint32_t pressed_count = 0;	// Anrop av pressed.
+static uint32_t released_count = 0;	// Anrop av released.
+
+// Statiska funktioner:
+static void pressed(void);
+static void released(void);
+
+/******************************************************************************
+* Funktionen check_pin_change kontrollerar att PCI-avbrott anropar pressed
+* vid hög och released vid låg insignal, samt att en ändring medan
+* avbrottet är inaktiverat hanteras när avbrottet återaktiveras.
+******************************************************************************/
+void check_pin_change(void)
+{
+	Simulator_set_pin('D', 2, 0);
+	PinChange_attach(IO_PORTD, 2, pressed, released);
+	CHECK(PinChange_attached(IO_PORTD) == (1 << 2));
+	PinChange_enable(IO_PORTD, 2);
+
+	Simulator_set_pin('D', 2, 1);
+	Simulator_advance_ms(1);
+	CHECK(pressed_count == 1 && released_count == 0);
+	Simulator_set_pin('D', 2, 0);
+	Simulator_advance_ms(1);
+	CHECK(pressed_count == 1 && released_count == 1);
+
+	PinChange_disable(IO_PORTD, 2);
+	Simulator_set_pin('D', 2, 1);
+	Simulator_advance_ms(1);
+	CHECK(pressed_count == 1);
+	PinChange_enable(IO_PORTD, 2);
+	CHECK(pressed_count == 2 && released_count == 1);
+
+	Simulator_set_pin('D', 2, 0);
+	Simulator_advance_ms(1);
+	CHECK(pressed_count == 2 && released_count == 2);
+	return;
+}
+
+static void pressed(void) { pressed_count++; }
+static void released(void) { released_count++; }
@@ -0,0 +1,111 @@
+// Inkluderingsdirektiv:
+#include "PressTrace.h"
+#include <math.h>
+#include <string.h>
+
+// Statiska funktioner:
+static double random_uniform(struct PressTrace* self);
+
+/******************************************************************************
+* Funktionen new_PressTrace returnerar en ny sekvens av given typ med count
+* tryckningar. För inspelade sekvenser sätts instansvariabeln file separat
+* efter att filen har öppnats.
+******************************************************************************/
+struct PressTrace new_PressTrace(const PressTraceMode mode, const double interval_ms, const double second_ms, const uint32_t count)
+{
+	struct PressTrace self;
+	self.mode = mode;
+	self.interval_ms = interval_ms;
+	self.second_ms = second_ms;
+	self.burst_length = 5;
+	self.count = count;
+	self.index = 0x00;
+	self.seed = 2463534242UL;
+	self.file = 0;
+	self.previous_time = -1.0;
+	self.total_time = 0.0;
+	return self;
+}
+
+/******************************************************************************
+* Funktionen PressTrace_next genererar intervallet i millisekunder fram till
+* nästa tryckning, vilket lagras på adressen interval, medan sekvensens sanna
+* intervall lagras på adressen target. Returvärdet är false när sekvensen är slut.
+******************************************************************************/
+bool PressTrace_next(struct PressTrace* self, double* interval, double* target)
+{
+	if (self->index >= self->count) return false;
+
+	if (self->mode == PRESS_TRACE_PERIODIC)
+	{
+		*interval = self->interval_ms;
+		*target = self->interval_ms;
+	}
+
+	else if (self->mode == PRESS_TRACE_BURSTY)
+	{
+		const uint32_t position = self->index % self->burst_length;
+		*interval = position ? self->interval_ms : self->second_ms;
+		*target = ((self->burst_length - 1) * self->interval_ms + self->second_ms) / self->burst_length;
+	}
+
+	else if (self->mode == PRESS_TRACE_POISSON)
+	{
+		*interval = -self->interval_ms * log(1.0 - random_uniform(self));
+		*target = self->interval_ms;
+	}
+
+	else if (self->mode == PRESS_TRACE_DRIFT)
+	{
+		const double progress = self->count > 1 ? (double)self->index / (self->count - 1) : 0.0;
+		*interval = self->interval_ms + (self->second_ms - self->interval_ms) * progress;
+		*target = *interval;
+	}
+
+	else
+	{
+		double time;
+
+		do
+		{
+			if (!self->file || fscanf(self->file, "%lf", &time) != 1) return false;
+			if (self->previous_time < 0) self->previous_time = time, time = -1.0;
+		} while (time < 0);
+
+		*interval = time - self->previous_time;
+		self->previous_time = time;
+		self->total_time += *interval;
+		*target = self->total_time / (self->index + 1);
+	}
+
+	self->index++;
+	return true;
+}
+
+/******************************************************************************
+* Funktionen PressTrace_mode returnerar sekvenstypen för ett givet namn:
+* periodic, bursty, poisson, drift eller file. Okänt namn ger periodisk
+* sekvens.
+******************************************************************************/
+PressTraceMode PressTrace_mode(const char* name)
+{
+	if (!strcmp(name, "bursty")) return PRESS_TRACE_BURSTY;
+	if (!strcmp(name, "poisson")) return PRESS_TRACE_POISSON;
+	if (!strcmp(name, "drift")) return PRESS_TRACE_DRIFT;
+	if (!strcmp(name, "file")) return PRESS_TRACE_FILE;
+	return PRESS_TRACE_PERIODIC;
+}
+
+/******************************************************************************
+* Funktionen random_uniform returnerar ett slumptal i intervallet [0, 1) via
+* slumptalsgeneratorn xorshift32, så att sekvenser är reproducerbara.
+******************************************************************************/
+static double random_uniform(struct PressTrace* self)
+{
+	uint32_t x = self->seed;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	self->seed = x;
+	return (x >> 8) / 16777216.0;
+}
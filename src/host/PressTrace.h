@@ -0,0 +1,56 @@
+
+#ifndef PRESSTRACE_H_
+#define PRESSTRACE_H_
+
+// Inkluderingsdirektiv:
+#include "../definitions.h"
+
+/******************************************************************************
+* Strukten PressTrace genererar tidsintervall mellan knapptryckningar för
+* simulering av den dynamiska timerns anpassning (se press_main.c).
+* Följande typer av sekvenser stöds:
+*
+* - PRESS_TRACE_PERIODIC: konstant intervall interval_ms.
+* - PRESS_TRACE_BURSTY: skurar om burst_length tryckningar med intervallet
+*   interval_ms, åtskilda av pausen second_ms.
+* - PRESS_TRACE_POISSON: exponentialfördelade intervall med medelvärdet
+*   interval_ms (Poissonprocess).
+* - PRESS_TRACE_DRIFT: intervallet ändras linjärt från interval_ms till
+*   second_ms under sekvensens count tryckningar.
+* - PRESS_TRACE_FILE: inspelade tidpunkter i millisekunder, en per rad, från
+*   en fil.
+*
+* Utöver varje intervall anges sekvensens sanna intervall vid aktuell
+* tryckning, det vill säga väntevärdet för genereringen, vilket utgör
+* målvärdet för den dynamiska timerns period. För inspelade sekvenser
+* används medelvärdet av samtliga intervall hittills.
+******************************************************************************/
+typedef enum PressTraceMode
+{
+	PRESS_TRACE_PERIODIC,
+	PRESS_TRACE_BURSTY,
+	PRESS_TRACE_POISSON,
+	PRESS_TRACE_DRIFT,
+	PRESS_TRACE_FILE
+} PressTraceMode;
+
+struct PressTrace
+{
+	PressTraceMode mode;		// Typ av sekvens.
+	double interval_ms;		// Intervall, alternativt medelvärde eller startvärde.
+	double second_ms;		// Paus mellan skurar, alternativt slutvärde vid drift.
+	uint32_t burst_length;		// Antal tryckningar per skur.
+	uint32_t count;			// Antal tryckningar i sekvensen.
+	uint32_t index;			// Index för nästa tryckning.
+	uint32_t seed;			// Tillstånd för slumptalsgeneratorn (xorshift32).
+	FILE* file;			// Fil med inspelade tidpunkter.
+	double previous_time;		// Föregående inspelade tidpunkt.
+	double total_time;		// Summan av inspelade intervall.
+};
+
+// Funktionsdeklarationer:
+struct PressTrace new_PressTrace(const PressTraceMode mode, const double interval_ms, const double second_ms, const uint32_t count);
+bool PressTrace_next(struct PressTrace* self, double* interval, double* target);
+PressTraceMode PressTrace_mode(const char* name);
+
+#endif /* PRESSTRACE_H_ */
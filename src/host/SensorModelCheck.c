@@ -0,0 +1,88 @@
+// Inkluderingsdirektiv:
+#include "Check.h"
+#include "../SensorModel.h"
+
+/******************************************************************************
+* Kontroller av sensormodellerna (se SensorModel.h) samt utskrift av
+* temperaturen via TempSensor_format och print_temperature (se ADC.h).
+******************************************************************************/
+
+/******************************************************************************
+* Funktionen check_sensor_model kontrollerar att varje brytpunkts lutning
+* motsvarar (value1 - value0) * 256 / (ADC_code1 - ADC_code0) avrundat till
+* närmaste heltal, att interpoleringen når nästa brytpunkt med högst en
+* tiondels grads fel, att sista lutningen är noll samt att omvandlingen ger
+* brytpunkternas värden, begränsas utanför tabellen och är monoton.
+******************************************************************************/
+void check_sensor_model(void)
+{
+	const struct SensorModel* models[] = { &tmp36_model, &ntc10k_model };
+
+	for (uint8_t m = 0; m < 2; m++)
+	{
+		const struct SensorModel* model = models[m];
+		const struct SensorPoint* points = model->points;
+		const int8_t direction = points[1].value > points[0].value ? 1 : -1;
+
+		for (uint8_t i = 0; i + 1 < model->size; i++)
+		{
+			const int32_t rise = (int32_t)(points[i + 1].value - points[i].value) * 256;
+			const int32_t run = points[i + 1].ADC_code - points[i].ADC_code;
+			const int32_t slope = (rise + (rise < 0 ? -run : run) / 2) / run;
+			const int32_t end = points[i].value + ((run * points[i].slope) >> 8);
+			CHECK(points[i].slope == slope);
+			CHECK(end - points[i + 1].value <= 1 && end - points[i + 1].value >= -1);
+			CHECK(points[i].ADC_code < points[i + 1].ADC_code);
+		}
+
+		CHECK(points[model->size - 1].slope == 0);
+
+		for (uint8_t i = 0; i < model->size; i++)
+			CHECK(SensorModel_convert(model, points[i].ADC_code) == points[i].value);
+
+		CHECK(SensorModel_convert(model, 0) == points[0].value);
+		CHECK(SensorModel_convert(model, 1023) == points[model->size - 1].value);
+		int16_t previous = SensorModel_convert(model, 0);
+		bool monotonic = true;
+
+		for (uint16_t code = 1; code <= 1023; code++)
+		{
+			const int16_t value = SensorModel_convert(model, code);
+			if (direction > 0 ? value < previous : value > previous) monotonic = false;
+			previous = value;
+		}
+
+		CHECK(monotonic);
+	}
+
+	CHECK(SensorModel_convert(&tmp36_model, 0) == -500);
+	CHECK(SensorModel_convert(&tmp36_model, 154) == 252);
+	CHECK(SensorModel_convert(&tmp36_model, 1023) == 4500);
+	return;
+}
+
+/******************************************************************************
+* Funktionen check_temperature_format kontrollerar avrundningen till hela
+* grader, (t >= 0 ? t + 5 : t - 5) / 10, samt utskriften via
+* print_temperature med simulerat resultat från AD-omvandlaren.
+******************************************************************************/
+void check_temperature_format(void)
+{
+	const int16_t temperatures[] = { 0, 4, 5, 244, 245, -4, -5, -244, -245, 4500, -500 };
+	const int16_t rounded[] = { 0, 0, 1, 24, 25, 0, -1, -24, -25, 450, -50 };
+	char text[SIZE], expected[SIZE];
+
+	for (uint8_t i = 0; i < sizeof(temperatures) / sizeof(temperatures[0]); i++)
+	{
+		TempSensor_format(temperatures[i], text);
+		snprintf(expected, SIZE, "Temperature: %d degrees Celcius\n", rounded[i]);
+		CHECK(!strcmp(text, expected));
+	}
+
+	const struct TempSensor sensor = new_TempSensor(1, &tmp36_model);
+	Simulator_set_adc(1, 154);
+	Check_capture_start();
+	CHECK(print_temperature(&sensor) == 252);
+	CHECK(!strcmp(Check_capture_stop(), "Temperature: 25 degrees Celcius\n"));
+	return;
+}
@@ -0,0 +1,657 @@
+// Inkluderingsdirektiv:
+#include "Simulator.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+/******************************************************************************
+* Registeradresser och bitar som simulatorn använder internt. Dessa
+* motsvarar minnesadresserna i ATmega328P:s datablad.
+******************************************************************************/
+#define ADDRESS_PINB 0x23
+#define ADDRESS_PINC 0x26
+#define ADDRESS_PIND 0x29
+#define ADDRESS_PCIFR 0x3B
+#define ADDRESS_EECR 0x3F
+#define ADDRESS_EEDR 0x40
+#define ADDRESS_SREG 0x5F
+#define ADDRESS_PCICR 0x68
+#define ADDRESS_PCMSK0 0x6B
+#define ADDRESS_ADC 0x78
+#define ADDRESS_ADCSRA 0x7A
+#define ADDRESS_ADMUX 0x7C
+#define ADDRESS_UCSR0A 0xC0
+#define ADDRESS_UCSR0B 0xC1
+#define ADDRESS_UBRR0 0xC4
+#define ADDRESS_UDR0 0xC6
+
+#define SREG_I 7
+#define ADSC_BIT 6
+#define ADEN_BIT 7
+#define ADIF_BIT 4
+#define ADIE_BIT 3
+#define UDRE0_BIT 5
+#define RXC0_BIT 7
+#define RXCIE0_BIT 7
+#define RXEN0_BIT 4
+#define EERE_BIT 0
+#define EEPE_BIT 1
+#define EERIE_BIT 3
+
+#define UDR0_EMPTY 0x100	// Markerar att inget tecken har skrivits till UDR0.
+#define EEPROM_SIZE 1024
+#define ADDRESS_MCUSR 0x54
+#define WDRF_BIT 3
+#define ADC_CHANNELS 16
+
+/******************************************************************************
+* Strukten SimulatorTimer beskriver en timerkrets: adresser för dess
+* register, var CTC Mode väljs, dess bredd samt vektornummer för compare
+* match A, compare match B och overflow.
+******************************************************************************/
+struct SimulatorTimer
+{
+	uint8_t TCCRA;
+	uint8_t TCCRB;
+	uint8_t TCNT;
+	uint8_t OCRA;
+	uint8_t OCRB;
+	uint8_t TIMSK;
+	uint8_t TIFR;
+	uint8_t CTC_register;		// Register som innehåller bit för CTC Mode.
+	uint8_t CTC_mask;		// Bitar som anger waveform generation mode i detta register.
+	uint8_t CTC_value;		// Värde på dessa bitar i CTC Mode.
+	bool wide;			// Indikerar 16-bitars timer.
+	bool timer2;			// Timer 2 har andra prescaleralternativ.
+	uint8_t vector_compare_A;
+	uint8_t vector_compare_B;
+	uint8_t vector_overflow;
+};
+
+static const struct SimulatorTimer timers[3] =
+{
+	{ 0x44, 0x45, 0x46, 0x47, 0x48, 0x6E, 0x35, 0x44, 0x03, 0x02, false, false, 14, 15, 16 },
+	{ 0x80, 0x81, 0x84, 0x88, 0x8A, 0x6F, 0x36, 0x81, 0x18, 0x08, true, false, 11, 12, 13 },
+	{ 0xB0, 0xB1, 0xB2, 0xB3, 0xB4, 0x70, 0x37, 0xB0, 0x03, 0x02, false, true, 7, 8, 9 },
+};
+
+static const uint16_t prescalers[8] = { 0, 1, 8, 64, 256, 1024, 0, 0 };
+static const uint16_t prescalers_timer2[8] = { 0, 1, 8, 32, 64, 128, 256, 1024 };
+
+// Avbrottsvektorer, definierade av programmet via makrot ISR (svaga symboler):
+#define SIMULATOR_VECTOR(n) void Simulator_vector_##n(void) __attribute__((weak));
+SIMULATOR_VECTOR(3) SIMULATOR_VECTOR(4) SIMULATOR_VECTOR(5) SIMULATOR_VECTOR(6)
+SIMULATOR_VECTOR(7) SIMULATOR_VECTOR(8) SIMULATOR_VECTOR(9) SIMULATOR_VECTOR(10)
+SIMULATOR_VECTOR(11) SIMULATOR_VECTOR(12) SIMULATOR_VECTOR(13) SIMULATOR_VECTOR(14)
+SIMULATOR_VECTOR(15) SIMULATOR_VECTOR(16) SIMULATOR_VECTOR(18) SIMULATOR_VECTOR(21)
+SIMULATOR_VECTOR(22)
+
+static void (*const vectors[SIMULATOR_VECTORS])(void) =
+{
+	[3] = Simulator_vector_3, [4] = Simulator_vector_4, [5] = Simulator_vector_5,
+	[6] = Simulator_vector_6, [7] = Simulator_vector_7, [8] = Simulator_vector_8,
+	[9] = Simulator_vector_9, [10] = Simulator_vector_10, [11] = Simulator_vector_11,
+	[12] = Simulator_vector_12, [13] = Simulator_vector_13, [14] = Simulator_vector_14,
+	[15] = Simulator_vector_15, [16] = Simulator_vector_16, [18] = Simulator_vector_18,
+	[21] = Simulator_vector_21, [22] = Simulator_vector_22,
+};
+
+// Simulatorns tillstånd:
+static union
+{
+	uint8_t reg8[0x100];
+	uint16_t reg16[0x80];
+} registers;
+
+static volatile int16_t UDR0_latch = UDR0_EMPTY;	// Senast skrivet tecken till UDR0.
+static bool UDR0_read = false;				// Indikerar att UDR0 lästes av mottagningsavbrottet.
+static char received = 0;				// Senast mottaget tecken.
+static uint8_t eeprom[EEPROM_SIZE];
+static volatile uint16_t EEAR_latch = 0x00;		// Adressregistret EEAR.
+static uint16_t adc_values[ADC_CHANNELS];
+static uint32_t prescaler_remainders[3];
+static uint8_t timer_flags[3];			// Avbrottsflaggor per timerkrets (TIFRn).
+static uint8_t timer_flag_copies[3];		// Kopior av flaggorna för läsning via registernamn.
+static uint64_t cycles = 0;
+static uint64_t busy_cycles = 0;
+static uint32_t transmitted_bytes = 0;
+static uint32_t adc_conversions = 0;
+static uint32_t interrupt_counts[SIMULATOR_VECTORS];
+static bool dispatching = false;
+
+// Statiska funktioner:
+static void default_output(const char data);
+static void synchronize(void);
+static void flush_transmission(void);
+static void dispatch_interrupts(void);
+static int next_pending_interrupt(void);
+static uint32_t timer_prescaler(const struct SimulatorTimer* timer);
+static uint16_t timer_top(const struct SimulatorTimer* timer);
+static uint16_t timer_count(const struct SimulatorTimer* timer);
+static uint16_t timer_compare(const struct SimulatorTimer* timer, const uint8_t address);
+static uint32_t ticks_until(const uint16_t count, const uint16_t target, const uint16_t top);
+static uint32_t timer_ticks_to_event(const struct SimulatorTimer* timer);
+static void timer_advance(const uint8_t index, const uint64_t step);
+
+static SimulatorOutput output = default_output;
+
+/******************************************************************************
+* Funktionerna Simulator_register8 samt Simulator_register16 returnerar en
+* pekare till ett register i registerfilen. Innan pekaren returneras
+* synkroniseras simulatorn, så att effekten av tidigare skrivningar blir
+* synlig, exempelvis att en påbörjad AD-omvandling är slutförd.
+******************************************************************************/
+volatile uint8_t* Simulator_register8(const uint16_t address)
+{
+	synchronize();
+	return &registers.reg8[address];
+}
+
+volatile uint16_t* Simulator_register16(const uint16_t address)
+{
+	synchronize();
+	return &registers.reg16[address / 2];
+}
+
+/******************************************************************************
+* Funktionen Simulator_UDR0 returnerar en pekare till USART:ens dataregister.
+* Registret lagras som ett 16-bitars värde, där UDR0_EMPTY markerar att
+* inget tecken har skrivits, så att även tecken som är identiska med
+* föregående tecken upptäcks. Om ett mottaget tecken väntar på att läsas
+* placeras det i registret, vilket då tolkas som en läsning.
+******************************************************************************/
+volatile int16_t* Simulator_UDR0(void)
+{
+	flush_transmission();
+
+	if (registers.reg8[ADDRESS_UCSR0A] & (1 << RXC0_BIT))
+	{
+		registers.reg8[ADDRESS_UCSR0A] &= ~(1 << RXC0_BIT);
+		UDR0_latch = (uint8_t)received;
+		UDR0_read = true;
+	}
+
+	return &UDR0_latch;
+}
+
+/******************************************************************************
+* Funktionen Simulator_EEAR returnerar en pekare till EEPROM-minnets
+* adressregister. Registret ligger på en udda adress (0x41 - 0x42) och kan
+* därmed inte lagras som ett 16-bitars värde i registerfilen utan att
+* överlappa dataregistret EEDR, varför det lagras separat.
+******************************************************************************/
+volatile uint16_t* Simulator_EEAR(void)
+{
+	synchronize();
+	return &EEAR_latch;
+}
+
+/******************************************************************************
+* Funktionen Simulator_address returnerar minnesadressen för ett register,
+* beräknat utifrån registrets position i registerfilen.
+******************************************************************************/
+uint16_t Simulator_address(volatile const void* sfr)
+{
+	if (sfr == (volatile const void*)&UDR0_latch) return ADDRESS_UDR0;
+	return (uint16_t)((volatile const uint8_t*)sfr - registers.reg8);
+}
+
+/******************************************************************************
+* Funktionen Simulator_timer_flags returnerar en pekare till en kopia av
+* avbrottsflaggorna för en given timerkrets, vilket används vid läsning via
+* registernamnen TIFR0 - TIFR2. Flaggorna nollställs däremot via skrivning
+* till registrets adress (_SFR_MEM8), där en etta nollställer flaggan, då
+* en skrivning av ett oförändrat värde inte kan skiljas från en läsning.
+******************************************************************************/
+volatile uint8_t* Simulator_timer_flags(const uint8_t timer)
+{
+	synchronize();
+	timer_flag_copies[timer] = timer_flags[timer];
+	return &timer_flag_copies[timer];
+}
+
+/******************************************************************************
+* Funktionen Simulator_set_interrupts ettställer eller nollställer I-flaggan
+* i statusregistret SREG, motsvarande instruktionerna SEI samt CLI.
+******************************************************************************/
+void Simulator_set_interrupts(const uint8_t enabled)
+{
+	synchronize();
+	if (enabled) registers.reg8[ADDRESS_SREG] |= (1 << SREG_I);
+	else registers.reg8[ADDRESS_SREG] &= ~(1 << SREG_I);
+	return;
+}
+
+/******************************************************************************
+* Funktionen Simulator_busy registrerar att programmet har förbrukat ett
+* antal klockcykler i en vänteloop. Motsvarande tid flyttas fram vid nästa
+* anrop av Simulator_advance.
+******************************************************************************/
+void Simulator_busy(const uint32_t busy)
+{
+	busy_cycles += busy;
+	return;
+}
+
+/******************************************************************************
+* Funktionen Simulator_reset återställer registerfilen till värdena efter
+* reset, nollställer statistik och raderar EEPROM-minnet (0xFF).
+******************************************************************************/
+void Simulator_reset(void)
+{
+	memset(&registers, 0, sizeof(registers));
+	memset(eeprom, 0xFF, sizeof(eeprom));
+	EEAR_latch = 0x00;
+	memset(adc_values, 0, sizeof(adc_values));
+	memset(prescaler_remainders, 0, sizeof(prescaler_remainders));
+	memset(timer_flags, 0, sizeof(timer_flags));
+	memset(interrupt_counts, 0, sizeof(interrupt_counts));
+	registers.reg8[ADDRESS_UCSR0A] = (1 << UDRE0_BIT);
+	UDR0_latch = UDR0_EMPTY;
+	UDR0_read = false;
+	cycles = 0;
+	busy_cycles = 0;
+	transmitted_bytes = 0;
+	adc_conversions = 0;
+	return;
+}
+
+/******************************************************************************
+* Funktionen Simulator_watchdog_reset simulerar en reset orsakad av
+* watchdog-timern: registerfilen återställs, medan EEPROM-minnet, simulerad
+* tid och statistik behålls. Biten WDRF ettställs i MCUSR, så att programmet
+* kan avgöra orsaken till reset. Programmets globala variabler behålls
+* (motsvarande sektionen .noinit), varför programmet själv initierar om dem
+* via setup.
+******************************************************************************/
+void Simulator_watchdog_reset(void)
+{
+	flush_transmission();
+	memset(&registers, 0, sizeof(registers));
+	memset(timer_flags, 0, sizeof(timer_flags));
+	registers.reg8[ADDRESS_UCSR0A] = (1 << UDRE0_BIT);
+	registers.reg8[ADDRESS_MCUSR] = (1 << WDRF_BIT);
+	EEAR_latch = 0x00;
+	UDR0_latch = UDR0_EMPTY;
+	UDR0_read = false;
+	return;
+}
+
+/******************************************************************************
+* Funktionen Simulator_advance flyttar fram simulerad tid med angivet antal
+* klockcykler. Tiden flyttas fram i steg fram till nästa händelse på någon
+* av timerkretsarna (overflow eller compare match), varefter väntande
+* avbrott exekveras. Klockcykler som har förbrukats i väntelooper läggs
+* till den tid som flyttas fram.
+******************************************************************************/
+void Simulator_advance(const uint64_t duration)
+{
+	uint64_t target = cycles + duration;
+	dispatch_interrupts();
+
+	while (cycles < target || busy_cycles)
+	{
+		target += busy_cycles;
+		busy_cycles = 0;
+
+		uint64_t step = target - cycles;
+
+		for (uint8_t i = 0; i < 3; i++)
+		{
+			const uint32_t prescaler = timer_prescaler(&timers[i]);
+			if (!prescaler) continue;
+			const uint64_t until = (uint64_t)timer_ticks_to_event(&timers[i]) * prescaler - prescaler_remainders[i];
+			if (until < step) step = until;
+		}
+
+		for (uint8_t i = 0; i < 3; i++)
+			timer_advance(i, step);
+
+		cycles += step;
+		dispatch_interrupts();
+	}
+	return;
+}
+
+void Simulator_advance_ms(const uint32_t ms)
+{
+	Simulator_advance((uint64_t)ms * SIMULATOR_CYCLES_PER_MS);
+	return;
+}
+
+uint64_t Simulator_cycles(void)
+{
+	return cycles;
+}
+
+/******************************************************************************
+* Funktionen Simulator_set_adc sätter resultatet för kommande AD-omvandlingar
+* på angiven analog kanal (0 - 1023).
+******************************************************************************/
+void Simulator_set_adc(const uint8_t channel, const uint16_t value)
+{
+	adc_values[channel % ADC_CHANNELS] = value & 0x3FF;
+	return;
+}
+
+/******************************************************************************
+* Funktionen Simulator_set_pin sätter insignalen på en given PIN (0 - 7) på
+* I/O-port B, C eller D. Om insignalen ändras och PCI-avbrott är aktiverat
+* för aktuell PIN i motsvarande maskregister, så ettställs avbrottsflaggan
+* i PCIFR, varefter väntande avbrott exekveras direkt.
+******************************************************************************/
+void Simulator_set_pin(const char port, const uint8_t pin, const uint8_t high)
+{
+	const uint8_t group = port == 'B' ? 0 : port == 'C' ? 1 : 2;
+	const uint8_t address = (uint8_t)(ADDRESS_PINB + 3 * group);
+	const uint8_t previous = registers.reg8[address];
+
+	if (high) registers.reg8[address] |= (1 << pin);
+	else registers.reg8[address] &= ~(1 << pin);
+
+	if ((previous ^ registers.reg8[address]) & registers.reg8[ADDRESS_PCMSK0 + group])
+		registers.reg8[ADDRESS_PCIFR] |= (1 << group);
+
+	dispatch_interrupts();
+	return;
+}
+
+uint8_t Simulator_get_pin(const char port, const uint8_t pin)
+{
+	const uint8_t group = port == 'B' ? 0 : port == 'C' ? 1 : 2;
+	return (registers.reg8[ADDRESS_PINB + 3 * group + 2] >> pin) & 0x01;
+}
+
+/******************************************************************************
+* Funktionen Simulator_receive simulerar att ett tecken tas emot via USART 0.
+* Om mottagning är aktiverad ettställs flaggan RXC0, varefter väntande
+* avbrott exekveras direkt.
+******************************************************************************/
+void Simulator_receive(const char data)
+{
+	if (!(registers.reg8[ADDRESS_UCSR0B] & (1 << RXEN0_BIT))) return;
+	received = data;
+	registers.reg8[ADDRESS_UCSR0A] |= (1 << RXC0_BIT);
+	dispatch_interrupts();
+	return;
+}
+
+void Simulator_set_output(const SimulatorOutput new_output)
+{
+	output = new_output ? new_output : default_output;
+	return;
+}
+
+void Simulator_flush(void)
+{
+	flush_transmission();
+	return;
+}
+
+uint32_t Simulator_transmitted_bytes(void)
+{
+	return transmitted_bytes;
+}
+
+uint32_t Simulator_interrupt_count(const uint8_t vector)
+{
+	return vector < SIMULATOR_VECTORS ? interrupt_counts[vector] : 0;
+}
+
+uint32_t Simulator_adc_conversions(void)
+{
+	return adc_conversions;
+}
+
+/******************************************************************************
+* Standardutfunktion för transmitterade tecken, som skriver till stdout.
+* Nolltecken samt vagnreturer, vilka programmet skickar för terminalens
+* skull, filtreras bort.
+******************************************************************************/
+static void default_output(const char data)
+{
+	if (data != '\0' && data != '\r') putchar(data);
+	return;
+}
+
+/******************************************************************************
+* Funktionen synchronize utför effekten av tidigare skrivningar till
+* registerfilen: ett skrivet tecken i UDR0 transmitteras, en påbörjad
+* AD-omvandling slutförs och EEPROM-läsning samt -skrivning utförs.
+* Dataregistret UDR0 är alltid redo för nästa tecken. Precis som på
+* mikrodatorn nollställs en avbrottsflagga för timerkretsarna genom att en
+* etta skrivs till motsvarande bit i TIFRn. Flaggorna lagras därför separat
+* från registerfilen, där TIFRn:s adress enbart tar emot skrivningar (se
+* Simulator_timer_flags för läsning).
+******************************************************************************/
+static void synchronize(void)
+{
+	flush_transmission();
+
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		timer_flags[i] &= ~registers.reg8[timers[i].TIFR];
+		registers.reg8[timers[i].TIFR] = 0x00;
+	}
+
+	uint8_t* ADCSRA_register = &registers.reg8[ADDRESS_ADCSRA];
+	if ((*ADCSRA_register & (1 << ADEN_BIT)) && (*ADCSRA_register & (1 << ADSC_BIT)))
+	{
+		registers.reg16[ADDRESS_ADC / 2] = adc_values[registers.reg8[ADDRESS_ADMUX] & 0x0F];
+		*ADCSRA_register = (uint8_t)((*ADCSRA_register & ~(1 << ADSC_BIT)) | (1 << ADIF_BIT));
+		adc_conversions++;
+	}
+
+	uint8_t* EECR_register = &registers.reg8[ADDRESS_EECR];
+	const uint16_t EEPROM_address = EEAR_latch % EEPROM_SIZE;
+
+	if (*EECR_register & (1 << EERE_BIT))
+	{
+		registers.reg8[ADDRESS_EEDR] = eeprom[EEPROM_address];
+		*EECR_register &= ~(1 << EERE_BIT);
+	}
+
+	if (*EECR_register & (1 << EEPE_BIT))
+	{
+		eeprom[EEPROM_address] = registers.reg8[ADDRESS_EEDR];
+		*EECR_register &= ~(1 << EEPE_BIT);
+	}
+
+	registers.reg8[ADDRESS_UCSR0A] |= (1 << UDRE0_BIT);
+	return;
+}
+
+/******************************************************************************
+* Funktionen flush_transmission skickar ett tecken som har skrivits till
+* UDR0 till utfunktionen. Transmissionstiden för tecknet (10 bitar vid
+* aktuell bithastighet) registreras som förbrukade klockcykler, eftersom
+* programmet väntar in varje tecken innan nästa skrivs.
+******************************************************************************/
+static void flush_transmission(void)
+{
+	if (UDR0_read)
+	{
+		UDR0_read = false;
+		UDR0_latch = UDR0_EMPTY;
+		return;
+	}
+
+	if (UDR0_latch == UDR0_EMPTY) return;
+	const char data = (char)UDR0_latch;
+	UDR0_latch = UDR0_EMPTY;
+	transmitted_bytes++;
+	busy_cycles += 16UL * (registers.reg16[ADDRESS_UBRR0 / 2] + 1UL) * 10UL;
+	output(data);
+	return;
+}
+
+/******************************************************************************
+* Funktionen dispatch_interrupts exekverar väntande avbrott så länge
+* I-flaggan i SREG är ettställd. Precis som på mikrodatorn nollställs
+* avbrottsflaggan samt I-flaggan när avbrottsrutinen startar, medan
+* I-flaggan ettställs igen efter avbrottsrutinen (RETI).
+******************************************************************************/
+static void dispatch_interrupts(void)
+{
+	if (dispatching) return;
+	dispatching = true;
+	synchronize();
+
+	while (registers.reg8[ADDRESS_SREG] & (1 << SREG_I))
+	{
+		const int vector = next_pending_interrupt();
+		if (vector < 0) break;
+
+		interrupt_counts[vector]++;
+		registers.reg8[ADDRESS_SREG] &= ~(1 << SREG_I);
+		if (vectors[vector]) vectors[vector]();
+		synchronize();
+		registers.reg8[ADDRESS_SREG] |= (1 << SREG_I);
+	}
+
+	dispatching = false;
+	return;
+}
+
+/******************************************************************************
+* Funktionen next_pending_interrupt returnerar vektornumret för det väntande
+* avbrott som har högst prioritet, eller -1 ifall inget avbrott väntar.
+* Avbrottsflaggan nollställs för flankutlösta avbrott.
+******************************************************************************/
+static int next_pending_interrupt(void)
+{
+	uint8_t* reg = registers.reg8;
+
+	for (uint8_t group = 0; group < 3; group++)
+	{
+		if ((reg[ADDRESS_PCIFR] & (1 << group)) && (reg[ADDRESS_PCICR] & (1 << group)))
+		{
+			reg[ADDRESS_PCIFR] &= ~(1 << group);
+			return 3 + group;
+		}
+	}
+
+	const uint8_t order[3] = { 2, 1, 0 };
+
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		const struct SimulatorTimer* timer = &timers[order[i]];
+		uint8_t* flags = &timer_flags[order[i]];
+		const uint8_t pending = *flags & reg[timer->TIMSK];
+		if (pending & (1 << 1)) { *flags &= ~(1 << 1); return timer->vector_compare_A; }
+		if (pending & (1 << 2)) { *flags &= ~(1 << 2); return timer->vector_compare_B; }
+		if (pending & (1 << 0)) { *flags &= ~(1 << 0); return timer->vector_overflow; }
+	}
+
+	if ((reg[ADDRESS_UCSR0A] & (1 << RXC0_BIT)) && (reg[ADDRESS_UCSR0B] & (1 << RXCIE0_BIT)))
+		return 18;
+
+	if ((reg[ADDRESS_ADCSRA] & (1 << ADIF_BIT)) && (reg[ADDRESS_ADCSRA] & (1 << ADIE_BIT)))
+	{
+		reg[ADDRESS_ADCSRA] &= ~(1 << ADIF_BIT);
+		return 21;
+	}
+
+	if ((reg[ADDRESS_EECR] & (1 << EERIE_BIT)) && !(reg[ADDRESS_EECR] & (1 << EEPE_BIT)))
+		return 22;
+
+	return -1;
+}
+
+/******************************************************************************
+* Hjälpfunktioner för timerkretsarna: aktuell prescaler (0 ifall timern är
+* stoppad), maxvärde för uppräkning (OCRA i CTC Mode), räknarvärde samt
+* compare-värden.
+******************************************************************************/
+static uint32_t timer_prescaler(const struct SimulatorTimer* timer)
+{
+	const uint8_t clock_select = registers.reg8[timer->TCCRB] & 0x07;
+	return timer->timer2 ? prescalers_timer2[clock_select] : prescalers[clock_select];
+}
+
+static uint16_t timer_top(const struct SimulatorTimer* timer)
+{
+	if ((registers.reg8[timer->CTC_register] & timer->CTC_mask) == timer->CTC_value)
+		return timer_compare(timer, timer->OCRA);
+	return timer->wide ? 0xFFFF : 0xFF;
+}
+
+static uint16_t timer_count(const struct SimulatorTimer* timer)
+{
+	return timer->wide ? registers.reg16[timer->TCNT / 2] : registers.reg8[timer->TCNT];
+}
+
+static uint16_t timer_compare(const struct SimulatorTimer* timer, const uint8_t address)
+{
+	return timer->wide ? registers.reg16[address / 2] : registers.reg8[address];
+}
+
+/******************************************************************************
+* Funktionen ticks_until returnerar antalet uppräkningar tills räknaren når
+* värdet target, där räknaren nollställs efter värdet top. Om räknaren redan
+* har värdet target returneras en hel period.
+******************************************************************************/
+static uint32_t ticks_until(const uint16_t count, const uint16_t target, const uint16_t top)
+{
+	if (target > count) return (uint32_t)(target - count);
+	return (uint32_t)(top - count) + 1 + target;
+}
+
+/******************************************************************************
+* Funktionen timer_ticks_to_event returnerar antalet uppräkningar tills nästa
+* händelse på en given timer: compare match A, compare match B eller
+* nollställning efter maxvärdet.
+******************************************************************************/
+static uint32_t timer_ticks_to_event(const struct SimulatorTimer* timer)
+{
+	const uint16_t top = timer_top(timer);
+	const uint16_t count = timer_count(timer) > top ? top : timer_count(timer);
+	uint32_t ticks = (uint32_t)(top - count) + 1;
+	const uint16_t compare_A = timer_compare(timer, timer->OCRA);
+	const uint16_t compare_B = timer_compare(timer, timer->OCRB);
+
+	if (compare_A <= top && ticks_until(count, compare_A, top) < ticks) ticks = ticks_until(count, compare_A, top);
+	if (compare_B <= top && ticks_until(count, compare_B, top) < ticks) ticks = ticks_until(count, compare_B, top);
+	return ticks;
+}
+
+/******************************************************************************
+* Funktionen timer_advance flyttar fram en given timer med angivet antal
+* klockcykler, vilket aldrig överstiger tiden till timerns nästa händelse.
+* Om räknaren når ett compare-värde ettställs motsvarande flagga, medan
+* overflow-flaggan ettställs då räknaren slår runt i Normal Mode.
+******************************************************************************/
+static void timer_advance(const uint8_t index, const uint64_t step)
+{
+	const struct SimulatorTimer* timer = &timers[index];
+	const uint32_t prescaler = timer_prescaler(timer);
+	if (!prescaler) return;
+
+	const uint64_t total = prescaler_remainders[index] + step;
+	const uint32_t ticks = (uint32_t)(total / prescaler);
+	prescaler_remainders[index] = (uint32_t)(total % prescaler);
+	if (!ticks) return;
+
+	const uint16_t top = timer_top(timer);
+	const uint16_t count = timer_count(timer) > top ? top : timer_count(timer);
+	const uint32_t wrap = (uint32_t)(top - count) + 1;
+	uint16_t new_count;
+
+	if (ticks >= wrap)
+	{
+		new_count = (uint16_t)((ticks - wrap) % ((uint32_t)top + 1));
+		if (top == (timer->wide ? 0xFFFF : 0xFF)) timer_flags[index] |= (1 << 0);
+	}
+
+	else
+	{
+		new_count = (uint16_t)(count + ticks);
+	}
+
+	if (new_count == timer_compare(timer, timer->OCRA)) timer_flags[index] |= (1 << 1);
+	if (new_count == timer_compare(timer, timer->OCRB)) timer_flags[index] |= (1 << 2);
+
+	if (timer->wide) registers.reg16[timer->TCNT / 2] = new_count;
+	else registers.reg8[timer->TCNT] = (uint8_t)new_count;
+	return;
+}
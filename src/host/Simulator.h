@@ -0,0 +1,69 @@
+
+#ifndef SIMULATOR_H_
+#define SIMULATOR_H_
+
+// Inkluderingsdirektiv:
+#include <stdint.h>
+
+/******************************************************************************
+* Simulatorn möjliggör att programmet kompileras och exekveras som ett
+* vanligt program på PC (HOST_BUILD), så att algoritmer kan testas och
+* mätas utan mikrodator. ATmega328P:s I/O-register lagras i en simulerad
+* registerfil, som programmet läser och skriver via samma registernamn som
+* på mikrodatorn (se host/avr/io.h). Simulatorn hanterar följande:
+*
+* - Timer 0 - 2: räknare, prescaler, Normal Mode samt CTC Mode, med
+*   avbrottsflaggor för overflow och compare match (kanal A och B).
+* - PCI-avbrott: simulerade insignaler på I/O-port B, C och D.
+* - AD-omvandlaren: injicerbart resultat per analog kanal, där en påbörjad
+*   omvandling slutförs direkt.
+* - USART 0: transmitterade tecken skickas till en valbar utfunktion och
+*   mottagna tecken kan injiceras, varpå mottagningsavbrott genereras.
+* - EEPROM-minnet: läsning och skrivning via EECR, EEDR och EEAR, där en
+*   påbörjad skrivning slutförs direkt.
+*
+* Booleska parametrar anges som uint8_t, eftersom programmet definierar
+* en egen datatyp bool i definitions.h.
+*
+* Tiden mäts i klockcykler (16 MHz) och flyttas framåt via Simulator_advance.
+* Avbrottsrutiner exekveras när tiden flyttas framåt, i samma prioritetsordning
+* som på mikrodatorn (lägst vektornummer först), förutsatt att I-flaggan i
+* SREG är ettställd. Avbrottsrutiner exekveras utan att simulerad tid
+* förflyter, med undantag för fördröjningar via _delay_ms och _delay_us.
+******************************************************************************/
+
+#define SIMULATOR_F_CPU 16000000UL		// Simulerad klockfrekvens.
+#define SIMULATOR_CYCLES_PER_MS (SIMULATOR_F_CPU / 1000UL)
+#define SIMULATOR_VECTORS 26			// Antal avbrottsvektorer på ATmega328P.
+
+typedef void (*SimulatorOutput)(const char data);
+
+// Registeråtkomst, används av host/avr/io.h:
+volatile uint8_t* Simulator_register8(const uint16_t address);
+volatile uint16_t* Simulator_register16(const uint16_t address);
+volatile int16_t* Simulator_UDR0(void);
+volatile uint16_t* Simulator_EEAR(void);
+uint16_t Simulator_address(volatile const void* sfr);
+volatile uint8_t* Simulator_timer_flags(const uint8_t timer);
+void Simulator_set_interrupts(const uint8_t enabled);
+void Simulator_busy(const uint32_t cycles);
+
+// Styrning av simuleringen:
+void Simulator_reset(void);
+void Simulator_watchdog_reset(void);
+void Simulator_advance(const uint64_t cycles);
+void Simulator_advance_ms(const uint32_t ms);
+uint64_t Simulator_cycles(void);
+void Simulator_set_adc(const uint8_t channel, const uint16_t value);
+void Simulator_set_pin(const char port, const uint8_t pin, const uint8_t high);
+uint8_t Simulator_get_pin(const char port, const uint8_t pin);
+void Simulator_receive(const char data);
+void Simulator_set_output(const SimulatorOutput output);
+void Simulator_flush(void);
+
+// Statistik:
+uint32_t Simulator_transmitted_bytes(void);
+uint32_t Simulator_interrupt_count(const uint8_t vector);
+uint32_t Simulator_adc_conversions(void);
+
+#endif /* SIMULATOR_H_ */
@@ -0,0 +1,122 @@
+// Inkluderingsdirektiv:
+#include "Check.h"
+#include "../TemperatureReport.h"
+
+/******************************************************************************
+* Kontroller av temperaturavläsningen som protothread samt utskrift enbart
+* vid ändring (se TemperatureReport.h). Simulatorn slutför AD-omvandling och transmission
+* direkt, varför varje begärd avläsning slutförs vid ett anrop av
+* TemperatureReport_run.
+******************************************************************************/
+
+static uint32_t measured_count = 0;	// Anrop av measured.
+static int16_t measured_temperature = 0;	// Senast avläst temperatur via measured.
+
+// Statiska funktioner:
+static const char* read_once(struct TemperatureReport* report, const uint16_t ADC_result);
+static void measured(const int16_t temperature);
+
+/******************************************************************************
+* Funktionen check_temperature_report kontrollerar att förloppet väntar
+* utan AD-omvandling tills en avläsning har begärts, att varje begäran ger
+* exakt en avläsning med utskrift och anrop av measured, även om flera
+* begärs innan föregående avläsning är slutförd, samt att antalet begärda
+* avläsningar begränsas till 255.
+******************************************************************************/
+void check_temperature_report(void)
+{
+	struct TempSensor sensor = new_TempSensor(0, &tmp36_model);
+	struct TemperatureReport report = new_TemperatureReport(&sensor, measured);
+	const uint32_t conversions = Simulator_adc_conversions();
+
+	Check_capture_start();
+	CHECK(TemperatureReport_run(&report) == PT_WAITING);
+	CHECK(TemperatureReport_run(&report) == PT_WAITING);
+	CHECK(!strcmp(Check_capture_stop(), ""));
+	CHECK(Simulator_adc_conversions() == conversions);
+	CHECK(measured_count == 0);
+
+	Simulator_set_adc(0, 154);
+	TemperatureReport_request(&report);
+	Check_capture_start();
+	CHECK(TemperatureReport_run(&report) == PT_ENDED);
+	CHECK(!strcmp(Check_capture_stop(), "Temperature: 25 degrees Celcius\n"));
+	CHECK(Simulator_adc_conversions() == conversions + 1);
+	CHECK(measured_count == 1 && measured_temperature == 252);
+	CHECK(TemperatureReport_run(&report) == PT_WAITING);
+
+	TemperatureReport_request(&report);
+	TemperatureReport_request(&report);
+	Check_capture_start();
+	CHECK(TemperatureReport_run(&report) == PT_ENDED);
+	Simulator_set_adc(0, 256);
+	CHECK(TemperatureReport_run(&report) == PT_ENDED);
+	CHECK(TemperatureReport_run(&report) == PT_WAITING);
+	CHECK(!strcmp(Check_capture_stop(), "Temperature: 25 degrees Celcius\nTemperature: 75 degrees Celcius\n"));
+	CHECK(measured_count == 3 && measured_temperature == TempSensor_convert(&sensor, 256));
+
+	for (uint16_t i = 0; i < 300; i++) TemperatureReport_request(&report);
+	CHECK(report.requests == UINT8_MAX);
+	Check_capture_start();
+	uint16_t readings = 0;
+	while (TemperatureReport_run(&report) == PT_ENDED) readings++;
+	Check_capture_stop();
+	CHECK(readings == UINT8_MAX);
+	CHECK(measured_count == 3 + UINT8_MAX);
+	return;
+}
+
+/******************************************************************************
+* Funktionen check_temperature_report_change kontrollerar utskrift enbart
+* vid ändring: första avläsningen skrivs alltid ut, ändringar inom
+* hysteresen undertrycks och räknas, medan en större ändring eller
+* utlöpt heartbeat ger utskrift med antalet undertryckta avläsningar.
+* Callbackfunktionen measured anropas för samtliga avläsningar. Utan
+* heartbeat undertrycks oförändrade avläsningar oavsett tid, medan
+* TemperatureReport_set_all återställer utskrift av samtliga avläsningar.
+******************************************************************************/
+void check_temperature_report_change(void)
+{
+	struct TempSensor sensor = new_TempSensor(0, &tmp36_model);
+	struct TemperatureReport report = new_TemperatureReport(&sensor, measured);
+	const uint32_t count = measured_count;
+	CHECK(TempSensor_convert(&sensor, 155) - TempSensor_convert(&sensor, 154) == 5);
+	CHECK(TempSensor_convert(&sensor, 154) - TempSensor_convert(&sensor, 153) == 5);
+
+	TemperatureReport_set_change(&report, 5, 10);
+	CHECK(!strcmp(read_once(&report, 154), "Temperature: 25 degrees Celcius, 0 skipped\n"));
+	CHECK(!strcmp(read_once(&report, 155), ""));
+	CHECK(!strcmp(read_once(&report, 153), ""));
+	CHECK(!strcmp(read_once(&report, 156), "Temperature: 26 degrees Celcius, 2 skipped\n"));
+	CHECK(measured_count == count + 4 && measured_temperature == TempSensor_convert(&sensor, 156));
+
+	Simulator_advance_ms(9000);
+	CHECK(!strcmp(read_once(&report, 156), ""));
+	Simulator_advance_ms(1000);
+	CHECK(!strcmp(read_once(&report, 156), "Temperature: 26 degrees Celcius, 1 skipped\n"));
+
+	TemperatureReport_set_all(&report);
+	CHECK(!strcmp(read_once(&report, 156), "Temperature: 26 degrees Celcius\n"));
+
+	TemperatureReport_set_change(&report, 5, 0);
+	CHECK(!strcmp(read_once(&report, 156), "Temperature: 26 degrees Celcius, 0 skipped\n"));
+	Simulator_advance_ms(100000);
+	CHECK(!strcmp(read_once(&report, 155), ""));
+	CHECK(measured_count == count + 9);
+	return;
+}
+
+/******************************************************************************
+* Funktionen read_once begär och slutför en avläsning med givet resultat
+* från AD-omvandlaren och returnerar utskriven text.
+******************************************************************************/
+static const char* read_once(struct TemperatureReport* report, const uint16_t ADC_result)
+{
+	Simulator_set_adc(report->sensor->PIN, ADC_result);
+	TemperatureReport_request(report);
+	Check_capture_start();
+	CHECK(TemperatureReport_run(report) == PT_ENDED);
+	return Check_capture_stop();
+}
+
+static void measured(const int16_t temperature) { measured_count++; measured_temperature = temperature; }
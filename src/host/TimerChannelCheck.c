@@ -0,0 +1,62 @@
+// Inkluderingsdirektiv:
+#include "Check.h"
+#include "../TimerChannel.h"
+
+/******************************************************************************
+* Kontroller av schemaläggningen av compare-kanaler (se TimerChannel.h) på
+* Timer 2, vars räknare drivs av klockan (256 uppräkningar per varv).
+******************************************************************************/
+
+#define TIMER2_COMPA_VECTOR 7	// Vektornummer för compare match A på Timer 2.
+
+static uint32_t callbacks = 0;	// Antal anrop av callbackfunktionen.
+
+// Statiska funktioner:
+static void count_callback(void);
+
+/******************************************************************************
+* Funktionen check_timer_channel kontrollerar att en fördröjning på exakt
+* ett varv schemaläggs som två halva varv, så att första deadline inte
+* infaller direkt, samt att en fördröjning över flera varv ger ett avbrott
+* per varv och deadline på exakt rätt uppräkning, även för nästa period.
+******************************************************************************/
+void check_timer_channel(void)
+{
+	struct TimerChannel channel = new_TimerChannel(TIMER2, CHANNEL_A, 1.024, count_callback);
+	Simulator_advance_ms(1);
+	callbacks = 0;
+
+	uint32_t interrupts = Simulator_interrupt_count(TIMER2_COMPA_VECTOR);
+	TimerChannel_on(&channel);
+	CHECK(channel.enabled && channel.period == 256 && channel.wrap == 256);
+	CHECK(channel.remaining == 128 && OCR2A == (uint8_t)(TCNT2 + 128));
+
+	Check_advance_ticks(128);
+	CHECK(callbacks == 0 && Simulator_interrupt_count(TIMER2_COMPA_VECTOR) == interrupts + 1);
+	Check_advance_ticks(127);
+	CHECK(callbacks == 0);
+	Check_advance_ticks(1);
+	CHECK(callbacks == 1 && Simulator_interrupt_count(TIMER2_COMPA_VECTOR) == interrupts + 2);
+	Check_advance_ticks(256);
+	CHECK(callbacks == 2 && TimerChannel_expirations(&channel) == 2);
+	TimerChannel_off(&channel);
+
+	channel = new_TimerChannel(TIMER2, CHANNEL_A, 10, count_callback);
+	callbacks = 0;
+	interrupts = Simulator_interrupt_count(TIMER2_COMPA_VECTOR);
+	TimerChannel_on(&channel);
+	CHECK(channel.period == 2500 && channel.remaining == 2500 - 128);
+
+	Check_advance_ticks(2499);
+	CHECK(callbacks == 0 && Simulator_interrupt_count(TIMER2_COMPA_VECTOR) == interrupts + 10);
+	Check_advance_ticks(1);
+	CHECK(callbacks == 1 && Simulator_interrupt_count(TIMER2_COMPA_VECTOR) == interrupts + 11);
+	Check_advance_ticks(2499);
+	CHECK(callbacks == 1);
+	Check_advance_ticks(1);
+	CHECK(callbacks == 2 && Simulator_interrupt_count(TIMER2_COMPA_VECTOR) == interrupts + 21);
+	TimerChannel_off(&channel);
+	return;
+}
+
+static void count_callback(void) { callbacks++; }
@@ -0,0 +1,39 @@
+// Inkluderingsdirektiv:
+#include "Check.h"
+#include "../Timer.h"
+
+/******************************************************************************
+* Kontroller av timerkretsarnas tid mellan avbrott samt att Timer 2, som
+* används av klockan, inte kan konfigureras via strukten Timer (se Timer.h).
+******************************************************************************/
+
+/******************************************************************************
+* Funktionen check_timer kontrollerar att tiden mellan avbrott beräknas från
+* respektive timerkrets beskrivning, att fördröjningstiden räknas om till
+* antal avbrott för rätt timerkrets samt att new_Timer och Timer_on lämnar
+* klockans prescaler och overflow-avbrott på Timer 2 orörda.
+******************************************************************************/
+void check_timer(void)
+{
+	struct TimerDescriptor descriptor;
+	TimerDescriptor_get(TIMER2, &descriptor);
+	CHECK(TimerDescriptor_interrupt_time(&descriptor) == 1.024f);
+
+	struct Timer timer1 = new_Timer(TIMER1, 1000);
+	CHECK(timer1.interrupt_time == 32.768f && timer1.interrupt_time == INTERRUPT_TIME);
+	CHECK(timer1.required_interrupts == 31);
+	Timer_set(&timer1, 65536);
+	CHECK(Timer_required(&timer1) == 2000);
+
+	struct Timer timer0 = new_Timer(TIMER0, 2);
+	CHECK(timer0.interrupt_time == 0.016f);
+	CHECK(timer0.required_interrupts == 125);
+
+	const uint8_t TCCR2A_value = TCCR2A, TCCR2B_value = TCCR2B, TIMSK2_value = TIMSK2;
+	struct Timer timer2 = new_Timer(TIMER2, 1000);
+	Timer_on(&timer2);
+	CHECK(!timer2.enabled);
+	CHECK(TCCR2A == TCCR2A_value && TCCR2B == TCCR2B_value && TIMSK2 == TIMSK2_value);
+	CHECK(TCCR2B == (1 << CS22) && (TIMSK2 & (1 << TOIE2)));
+	return;
+}
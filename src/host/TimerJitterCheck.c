@@ -0,0 +1,40 @@
+// Inkluderingsdirektiv:
+#include "Check.h"
+#include "../TimerJitter.h"
+
+/******************************************************************************
+* Kontroller av histogrammet över timerns avvikelser (se TimerJitter.h).
+******************************************************************************/
+
+/******************************************************************************
+* Funktionen check_timer_jitter kontrollerar histogrammets avvikelser vid
+* exakt, sen och tidig utlöpning, där tiden flyttas fram ett exakt antal
+* uppräkningar. En utlöpning med ändrad fördröjningstid lagras inte.
+* Tiden flyttas först fram en millisekund, så att föregående utskrifters
+* överföringstid inte påverkar första perioden.
+******************************************************************************/
+void check_timer_jitter(void)
+{
+#ifdef TIMER_JITTER_ENABLED
+	const uint32_t ticks = (uint32_t)(INTERRUPT_TIME * 1000 + 0.5f) / CLOCK_TICK_US;
+	Simulator_advance_ms(1);
+	TimerJitter_reset();
+	TimerJitter_expiry(1);
+	Check_advance_ticks(ticks);
+	TimerJitter_expiry(1);
+	Check_advance_ticks(ticks + 10);
+	TimerJitter_expiry(1);
+	Check_advance_ticks(ticks);
+	TimerJitter_expiry(2);
+	Check_advance_ticks(2 * ticks - 3);
+	TimerJitter_expiry(2);
+
+	Check_capture_start();
+	TimerJitter_print();
+	const char* text = Check_capture_stop();
+	CHECK(!strncmp(text, "Timer jitter, 3 periods (us):\nmin -12, max 40\n", 46));
+	CHECK(strstr(text, "     0: 1\n") != 0);
+	CHECK(strstr(text, "p99 < 64\n") != 0);
+#endif /* TIMER_JITTER_ENABLED */
+	return;
+}
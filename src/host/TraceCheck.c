@@ -0,0 +1,45 @@
+// Inkluderingsdirektiv:
+#include "Check.h"
+#include "../Trace.h"
+
+/******************************************************************************
+* Kontroller av spårbufferten (se Trace.h).
+******************************************************************************/
+
+/******************************************************************************
+* Funktionen check_trace kontrollerar att ringbufferten behåller de
+* TRACE_CAPACITY senaste posterna, äldsta först, samt att bufferten
+* behålls vid omstart utan power-on reset.
+******************************************************************************/
+void check_trace(void)
+{
+	char line[32];
+	const char* text;
+	Trace_clear();
+
+	for (uint16_t i = 0; i < TRACE_CAPACITY + 8; i++)
+		Trace_record(TRACE_BUTTON, i);
+
+	Check_capture_start();
+	Trace_print();
+	text = Check_capture_stop();
+	snprintf(line, sizeof(line), "Trace: %u records", TRACE_CAPACITY);
+	CHECK(!strncmp(text, line, strlen(line)));
+	CHECK(!strstr(text, " BUTTON 7\n"));
+	const char* first = strstr(text, " BUTTON 8\n");
+	snprintf(line, sizeof(line), " BUTTON %u\n", TRACE_CAPACITY + 7);
+	const char* last = strstr(text, line);
+	CHECK(first && last && first < last);
+
+	CHECK(Trace_init(0));
+	Check_capture_start();
+	Trace_print();
+	CHECK(strstr(Check_capture_stop(), " RESET 0\n") != 0);
+
+	CHECK(!Trace_init(1 << PORF));
+	Check_capture_start();
+	Trace_print();
+	text = Check_capture_stop();
+	CHECK(!strncmp(text, "Trace: 1 records", 16) && strstr(text, " RESET 1\n"));
+	return;
+}
@@ -0,0 +1,178 @@
+// Inkluderingsdirektiv:
+#include "Check.h"
+#include "../TypedVector.h"
+
+/******************************************************************************
+* Vektortypen Vector_uint16_t genereras enbart här, så att makrona
+* VECTOR_DECLARE och VECTOR_DEFINE kompileras och kontrolleras trots att
+* programmet inte använder någon genererad vektortyp.
+******************************************************************************/
+VECTOR_DECLARE(uint16_t)
+VECTOR_DEFINE(uint16_t)
+
+#define CHECK_LIMITED_SIZE 4096	// Största block som limited_allocator allokerar.
+
+static uint32_t reallocations = 0;	// Antal anrop av limited_reallocate.
+static size_t requested_size = 0;	// Storlek vid första anropet av limited_reallocate.
+
+// Statiska funktioner:
+static void* limited_allocate(const size_t size);
+static void* limited_reallocate(void* block, const size_t size);
+static void limited_deallocate(void* block);
+
+static const struct Allocator limited_allocator = { limited_allocate, limited_reallocate, limited_deallocate, 0 };
+
+/******************************************************************************
+* Funktionen check_vector kontrollerar tillväxt, tillägg av vektorns egna
+* element (även när blocket flyttas vid omallokering), att minskning behåller
+* kapaciteten tills Vector_shrink_to_fit anropas samt att Vector_set
+* ignorerar index utanför vektorn.
+******************************************************************************/
+void check_vector(void)
+{
+	const struct AllocatorStatistics before = *DEFAULT_ALLOCATOR->statistics;
+	struct Vector self = new_Vector();
+	CHECK(self.allocator == DEFAULT_ALLOCATOR);
+
+	for (uint32_t i = 1; i <= 5; i++)
+		CHECK(Vector_push(&self, i));
+
+	CHECK(self.elements == 5 && self.capacity >= 5);
+	CHECK(Vector_push_many(&self, self.data, self.elements));
+	CHECK(self.elements == 10 && self.capacity >= 10);
+
+	for (uint32_t i = 0; i < 10; i++)
+		CHECK(self.data[i] == i % 5 + 1);
+
+	CHECK(Vector_push_many(&self, &self.data[8], 2));
+	CHECK(self.elements == 12 && self.data[10] == 4 && self.data[11] == 5);
+	CHECK(Vector_sum(&self) == 39);
+
+	const size_t capacity = self.capacity;
+	Vector_resize(&self, 3);
+	CHECK(self.elements == 3 && self.capacity == capacity);
+	Vector_shrink_to_fit(&self);
+	CHECK(self.elements == 3 && self.capacity >= 3 && self.capacity < capacity);
+	CHECK(self.data[0] == 1 && self.data[1] == 2 && self.data[2] == 3);
+
+	Vector_set(&self, 1, 20);
+	Vector_set(&self, 3, 30);
+	CHECK(self.elements == 3 && self.data[1] == 20);
+	Vector_resize(&self, 6);
+	CHECK(self.elements == 6 && self.capacity >= 6 && self.data[0] == 1);
+
+	Vector_clear(&self);
+	CHECK(!self.data && !self.elements && !self.capacity);
+	CHECK(DEFAULT_ALLOCATOR->statistics->used_bytes == before.used_bytes);
+
+	struct Vector heap = new_Vector();
+	Vector_set_allocator(&heap, &heap_allocator);
+	CHECK(heap.allocator == &heap_allocator);
+
+	for (uint32_t i = 0; i < 1000; i++)
+		Vector_push(&heap, i);
+
+	CHECK(heap.elements == 1000 && heap.data[999] == 999);
+	CHECK(Vector_average(&heap) == 499.5);
+	Vector_set_allocator(&heap, &limited_allocator);
+	CHECK(heap.allocator == &heap_allocator);
+	Vector_clear(&heap);
+	return;
+}
+
+/******************************************************************************
+* Funktionen check_typed_vector kontrollerar den genererade vektortypen
+* Vector_uint16_t: reservering, tillägg av vektorns egna element när
+* fältet flyttas vid utökning samt Vector_uint16_t_shrink_to_fit.
+******************************************************************************/
+void check_typed_vector(void)
+{
+	struct Vector_uint16_t self = new_Vector_uint16_t();
+	CHECK(!self.data && !self.elements && !self.capacity);
+	CHECK(Vector_uint16_t_reserve(&self, 10));
+	CHECK(self.capacity == 10 && !self.elements);
+	CHECK(Vector_uint16_t_reserve(&self, 5));
+	CHECK(self.capacity == 10);
+
+	for (uint16_t i = 0; i < 10; i++)
+		CHECK(Vector_uint16_t_push(&self, 1000 + i));
+
+	CHECK(self.elements == 10 && self.capacity == 10);
+	CHECK(Vector_uint16_t_push_many(&self, &self.data[2], 5));
+	CHECK(self.elements == 15 && self.capacity >= 15);
+
+	for (uint16_t i = 0; i < 5; i++)
+		CHECK(self.data[10 + i] == 1002 + i);
+
+	CHECK(Vector_uint16_t_push_many(&self, self.data, self.elements));
+	CHECK(self.elements == 30 && self.data[15] == 1000 && self.data[29] == 1006);
+	CHECK(Vector_uint16_t_push_many(&self, self.data, 0));
+	CHECK(self.elements == 30);
+
+	Vector_uint16_t_shrink_to_fit(&self);
+	CHECK(self.capacity == 30 && self.data[29] == 1006);
+	Vector_uint16_t_clear(&self);
+	CHECK(!self.data && !self.elements && !self.capacity);
+	return;
+}
+
+/******************************************************************************
+* Funktionen check_vector_limits kontrollerar att ett fält vars storlek
+* mätt i byte inte ryms i size_t avvisas utan omallokering, att den
+* geometriska utökningen begränsas till största möjliga antal element
+* samt att push_many avvisar ett antal element som inte ryms.
+******************************************************************************/
+void check_vector_limits(void)
+{
+	void* data = 0;
+	size_t capacity = 0;
+
+	CHECK(!Vector_reserve_memory(&limited_allocator, &data, &capacity, SIZE_MAX / 2, 4));
+	CHECK(!Vector_grow_memory(&limited_allocator, &data, &capacity, 16, SIZE_MAX / 16 + 1));
+	CHECK(!data && !capacity && !reallocations);
+
+	capacity = 8;
+	CHECK(!Vector_grow_memory(&limited_allocator, &data, &capacity, SIZE_MAX / 10, 9));
+	CHECK(reallocations == 2 && requested_size == SIZE_MAX / 10 * 10);
+	CHECK(!data && capacity == 8);
+
+	struct Vector_uint16_t self = new_Vector_uint16_t();
+	Vector_uint16_t_set_allocator(&self, &limited_allocator);
+	CHECK(Vector_uint16_t_push(&self, 1));
+	reallocations = 0;
+	CHECK(!Vector_uint16_t_push_many(&self, self.data, SIZE_MAX));
+	CHECK(!reallocations && self.elements == 1);
+	Vector_uint16_t_clear(&self);
+
+	struct Vector vector = new_Vector();
+	Vector_set_allocator(&vector, &limited_allocator);
+	CHECK(Vector_push(&vector, 1));
+	reallocations = 0;
+	CHECK(!Vector_push_many(&vector, vector.data, SIZE_MAX));
+	CHECK(!Vector_reserve(&vector, SIZE_MAX / 2));
+	CHECK(!reallocations && vector.elements == 1);
+	Vector_clear(&vector);
+	return;
+}
+
+/******************************************************************************
+* Allokeraren limited_allocator allokerar via heapen men avvisar block
+* större än CHECK_LIMITED_SIZE, samt räknar anropen av reallocate och
+* lagrar storleken vid första anropet.
+******************************************************************************/
+static void* limited_allocate(const size_t size)
+{
+	return limited_reallocate(0, size);
+}
+
+static void* limited_reallocate(void* block, const size_t size)
+{
+	if (!reallocations++) requested_size = size;
+	return size > CHECK_LIMITED_SIZE ? 0 : heap_allocator.reallocate(block, size);
+}
+
+static void limited_deallocate(void* block)
+{
+	heap_allocator.deallocate(block);
+	return;
+}
@@ -0,0 +1,41 @@
+
+#ifndef HOST_AVR_INTERRUPT_H_
+#define HOST_AVR_INTERRUPT_H_
+
+/******************************************************************************
+* Ersätter avr-libc:s avr/interrupt.h vid kompilering för PC. Avbrottsrutiner
+* deklarerade via makrot ISR blir vanliga funktioner, som anropas av
+* simulatorn när motsvarande avbrottsflagga är ettställd, avbrottet är
+* aktiverat och I-flaggan i SREG är ettställd. Namnen på avbrottsvektorerna
+* motsvarar vektornumren i ATmega328P:s avbrottstabell.
+******************************************************************************/
+
+// Inkluderingsdirektiv:
+#include <avr/io.h>
+
+#define ISR(vector, ...) void vector(void); void vector(void)
+
+#define sei() Simulator_set_interrupts(1)
+#define cli() Simulator_set_interrupts(0)
+
+#define PCINT0_vect Simulator_vector_3
+#define PCINT1_vect Simulator_vector_4
+#define PCINT2_vect Simulator_vector_5
+#define WDT_vect Simulator_vector_6
+#define TIMER2_COMPA_vect Simulator_vector_7
+#define TIMER2_COMPB_vect Simulator_vector_8
+#define TIMER2_OVF_vect Simulator_vector_9
+#define TIMER1_CAPT_vect Simulator_vector_10
+#define TIMER1_COMPA_vect Simulator_vector_11
+#define TIMER1_COMPB_vect Simulator_vector_12
+#define TIMER1_OVF_vect Simulator_vector_13
+#define TIMER0_COMPA_vect Simulator_vector_14
+#define TIMER0_COMPB_vect Simulator_vector_15
+#define TIMER0_OVF_vect Simulator_vector_16
+#define USART_RX_vect Simulator_vector_18
+#define USART_UDRE_vect Simulator_vector_19
+#define USART_TX_vect Simulator_vector_20
+#define ADC_vect Simulator_vector_21
+#define EE_READY_vect Simulator_vector_22
+
+#endif /* HOST_AVR_INTERRUPT_H_ */
@@ -0,0 +1,196 @@
+
+#ifndef HOST_AVR_IO_H_
+#define HOST_AVR_IO_H_
+
+/******************************************************************************
+* Ersätter avr-libc:s avr/io.h vid kompilering för PC (HOST_BUILD). Samtliga
+* register i ATmega328P:s I/O-område mappas mot simulatorns registerfil (se
+* Simulator.h) via samma minnesadresser som på mikrodatorn, så att
+* programmets moduler kan kompileras oförändrade. Varje registeråtkomst sker
+* via ett funktionsanrop, vilket ger simulatorn möjlighet att reagera på
+* skrivningar, exempelvis att slutföra en AD-omvandling eller transmittera
+* ett tecken.
+******************************************************************************/
+
+// Inkluderingsdirektiv:
+#include <stdint.h>
+#include "../Simulator.h"
+
+#define _MMIO_BYTE(address) (*Simulator_register8(address))
+#define _MMIO_WORD(address) (*Simulator_register16(address))
+#define _SFR_MEM8(address) _MMIO_BYTE(address)
+#define _SFR_MEM16(address) _MMIO_WORD(address)
+#define _SFR_MEM_ADDR(sfr) Simulator_address(&(sfr))
+#define _BV(bit) (1 << (bit))
+
+// I/O-portar:
+#define PINB _SFR_MEM8(0x23)
+#define DDRB _SFR_MEM8(0x24)
+#define PORTB _SFR_MEM8(0x25)
+#define PINC _SFR_MEM8(0x26)
+#define DDRC _SFR_MEM8(0x27)
+#define PORTC _SFR_MEM8(0x28)
+#define PIND _SFR_MEM8(0x29)
+#define DDRD _SFR_MEM8(0x2A)
+#define PORTD _SFR_MEM8(0x2B)
+
+// Avbrottsflaggor (timerkretsarnas flaggor läses via simulatorn, se Simulator.c):
+#define TIFR0 (*Simulator_timer_flags(0))
+#define TIFR1 (*Simulator_timer_flags(1))
+#define TIFR2 (*Simulator_timer_flags(2))
+#define PCIFR _SFR_MEM8(0x3B)
+
+// EEPROM, adressregistret EEAR hanteras separat av simulatorn (udda adress):
+#define EECR _SFR_MEM8(0x3F)
+#define EEDR _SFR_MEM8(0x40)
+#define EEAR (*Simulator_EEAR())
+
+// Timer 0:
+#define TCCR0A _SFR_MEM8(0x44)
+#define TCCR0B _SFR_MEM8(0x45)
+#define TCNT0 _SFR_MEM8(0x46)
+#define OCR0A _SFR_MEM8(0x47)
+#define OCR0B _SFR_MEM8(0x48)
+
+// Systemregister:
+#define SMCR _SFR_MEM8(0x53)
+#define MCUSR _SFR_MEM8(0x54)
+#define SP _SFR_MEM16(0x5D)
+#define SREG _SFR_MEM8(0x5F)
+#define WDTCSR _SFR_MEM8(0x60)
+
+// PCI-avbrott samt timeravbrott:
+#define PCICR _SFR_MEM8(0x68)
+#define PCMSK0 _SFR_MEM8(0x6B)
+#define PCMSK1 _SFR_MEM8(0x6C)
+#define PCMSK2 _SFR_MEM8(0x6D)
+#define TIMSK0 _SFR_MEM8(0x6E)
+#define TIMSK1 _SFR_MEM8(0x6F)
+#define TIMSK2 _SFR_MEM8(0x70)
+
+// AD-omvandlare:
+#define ADC _SFR_MEM16(0x78)
+#define ADCSRA _SFR_MEM8(0x7A)
+#define ADCSRB _SFR_MEM8(0x7B)
+#define ADMUX _SFR_MEM8(0x7C)
+
+// Timer 1:
+#define TCCR1A _SFR_MEM8(0x80)
+#define TCCR1B _SFR_MEM8(0x81)
+#define TCCR1C _SFR_MEM8(0x82)
+#define TCNT1 _SFR_MEM16(0x84)
+#define ICR1 _SFR_MEM16(0x86)
+#define OCR1A _SFR_MEM16(0x88)
+#define OCR1B _SFR_MEM16(0x8A)
+
+// Timer 2:
+#define TCCR2A _SFR_MEM8(0xB0)
+#define TCCR2B _SFR_MEM8(0xB1)
+#define TCNT2 _SFR_MEM8(0xB2)
+#define OCR2A _SFR_MEM8(0xB3)
+#define OCR2B _SFR_MEM8(0xB4)
+
+// USART 0, dataregistret UDR0 hanteras separat av simulatorn:
+#define UCSR0A _SFR_MEM8(0xC0)
+#define UCSR0B _SFR_MEM8(0xC1)
+#define UCSR0C _SFR_MEM8(0xC2)
+#define UBRR0 _SFR_MEM16(0xC4)
+#define UDR0 (*Simulator_UDR0())
+
+#define RAMEND 0x8FF
+
+// Bitar i TIFRn samt TIMSKn:
+#define TOV0 0
+#define OCF0A 1
+#define OCF0B 2
+#define TOV1 0
+#define OCF1A 1
+#define OCF1B 2
+#define ICF1 5
+#define TOV2 0
+#define OCF2A 1
+#define OCF2B 2
+#define TOIE0 0
+#define OCIE0A 1
+#define OCIE0B 2
+#define TOIE1 0
+#define OCIE1A 1
+#define OCIE1B 2
+#define ICIE1 5
+#define TOIE2 0
+#define OCIE2A 1
+#define OCIE2B 2
+
+// Bitar i TCCRnA samt TCCRnB:
+#define WGM00 0
+#define WGM01 1
+#define CS00 0
+#define CS01 1
+#define CS02 2
+#define WGM02 3
+#define WGM10 0
+#define WGM11 1
+#define CS10 0
+#define CS11 1
+#define CS12 2
+#define WGM12 3
+#define WGM13 4
+#define WGM20 0
+#define WGM21 1
+#define CS20 0
+#define CS21 1
+#define CS22 2
+#define WGM22 3
+
+// Bitar i PCICR samt PCIFR:
+#define PCIE0 0
+#define PCIE1 1
+#define PCIE2 2
+#define PCIF0 0
+#define PCIF1 1
+#define PCIF2 2
+
+// Bitar i ADMUX samt ADCSRA:
+#define REFS0 6
+#define REFS1 7
+#define ADPS0 0
+#define ADPS1 1
+#define ADPS2 2
+#define ADIE 3
+#define ADIF 4
+#define ADATE 5
+#define ADSC 6
+#define ADEN 7
+
+// Bitar i UCSR0A, UCSR0B samt UCSR0C:
+#define UDRE0 5
+#define TXC0 6
+#define RXC0 7
+#define TXEN0 3
+#define RXEN0 4
+#define UDRIE0 5
+#define TXCIE0 6
+#define RXCIE0 7
+#define UCSZ00 1
+#define UCSZ01 2
+
+// Bitar i EECR:
+#define EERE 0
+#define EEPE 1
+#define EEMPE 2
+#define EERIE 3
+
+// Bitar i SMCR, MCUSR samt WDTCSR:
+#define SE 0
+#define SM0 1
+#define SM1 2
+#define SM2 3
+#define PORF 0
+#define EXTRF 1
+#define BORF 2
+#define WDRF 3
+#define WDE 3
+#define WDCE 4
+#define WDIE 6
+
+#endif /* HOST_AVR_IO_H_ */
@@ -0,0 +1,35 @@
+
+#ifndef HOST_AVR_PGMSPACE_H_
+#define HOST_AVR_PGMSPACE_H_
+
+/******************************************************************************
+* Ersätter avr-libc:s avr/pgmspace.h vid kompilering för PC, där flashminne
+* och RAM delar adressrymd. Konstanter märkta PROGMEM lagras därmed som
+* vanliga konstanter och läses direkt via pekare.
+******************************************************************************/
+
+// Inkluderingsdirektiv:
+#include <stdint.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+
+#define pgm_read_byte(address) (*(const uint8_t*)(address))
+#define pgm_read_word(address) (*(const uint16_t*)(address))
+#define pgm_read_dword(address) (*(const uint32_t*)(address))
+#define pgm_read_ptr(address) (*(void* const*)(address))
+
+#define memcpy_P memcpy
+#define strcmp_P strcmp
+#define strchr_P strchr
+#define strcpy_P strcpy
+#define strlen_P strlen
+#define sprintf_P sprintf
+#define snprintf_P snprintf
+#define vsnprintf_P vsnprintf
+
+#endif /* HOST_AVR_PGMSPACE_H_ */
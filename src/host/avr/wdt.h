@@ -0,0 +1,17 @@
+
+#ifndef HOST_AVR_WDT_H_
+#define HOST_AVR_WDT_H_
+
+/******************************************************************************
+* Ersätter avr-libc:s avr/wdt.h vid kompilering för PC. Simulatorn saknar
+* watchdog-timer, varför makrona för aktivering, inaktivering samt
+* återställning av watchdog-timern inte utför någonting.
+******************************************************************************/
+
+#define WDTO_2S 7	// Timeout på två sekunder.
+
+#define wdt_enable(timeout) ((void)(timeout))
+#define wdt_disable() ((void)0)
+#define wdt_reset() ((void)0)
+
+#endif /* HOST_AVR_WDT_H_ */
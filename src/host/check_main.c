@@ -0,0 +1,46 @@
+// Inkluderingsdirektiv:
+#include "Check.h"
+
+/******************************************************************************
+* Programmets startpunkt för kontroller av programmets moduler vid
+* kompilering för PC (HOST_BUILD), se Check.h. Simulatorn återställs och
+* klockan initieras, varefter respektive moduls kontroller exekveras i tur
+* och ordning. Programmet returnerar 1 ifall någon kontroll misslyckades.
+******************************************************************************/
+
+int main(void)
+{
+	Simulator_reset();
+	init_clock();
+
+	check_sensor_model();
+	check_temperature_format();
+	check_temperature_report();
+	check_temperature_report_change();
+	check_heap_allocator();
+#ifdef ENABLE_POOL_ALLOCATOR
+	check_pool_allocator();
+#endif
+	check_vector();
+	check_typed_vector();
+	check_vector_limits();
+	check_estimators();
+	check_trimmed_mean();
+	check_timer();
+	check_timer_channel();
+	check_dynamic_timer_report();
+	check_dynamic_timer_rescale();
+	check_restore();
+	check_checkpoint();
+	check_trace();
+	check_timer_jitter();
+	check_cpu_load();
+	check_adaptive_sampling();
+	check_history();
+	check_eeprom_log();
+	check_pin_change();
+	check_debouncer();
+
+	printf("%lu checks, %lu failed\n", (unsigned long)Check_count(), (unsigned long)Check_failures());
+	return Check_failures() ? 1 : 0;
+}
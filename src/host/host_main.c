@@ -0,0 +1,174 @@
+// Inkluderingsdirektiv:
+#include "../header.h"
+#include <string.h>
+
+/******************************************************************************
+* Programmets startpunkt vid kompilering för PC (HOST_BUILD). Programmet
+* initieras via funktionen setup, varefter simulerad tid flyttas fram en
+* millisekund i taget, där funktionen loop anropas efter varje millisekund.
+* Ett scenario med knapptryckningar på tryckknappens PIN 13 samt kommandon
+* till konsolen simuleras enligt angivna argument:
+*
+* --presses N      Antal knapptryckningar (standard 5).
+* --interval MS    Tid mellan knapptryckningar i millisekunder (standard 5000).
+* --idle MS        Simulerad tid efter sista knapptryckningen (standard 65000).
+* --adc VALUE      Resultat från AD-omvandlaren, 0 - 1023 (standard 154).
+* --ramp MS        Resultatet från AD-omvandlaren ökas med ett var MS:e
+*                  millisekund, för simulering av en temperaturändring
+*                  (standard 0, oförändrat resultat).
+* --command TEXT   Kommando som skickas till konsolen efter sista
+*                  knapptryckningen, kan anges flera gånger.
+* --reboot         Efter simulerad tid sker en watchdog-reset, varefter
+*                  programmet startar om och körs lika länge igen, med
+*                  bibehållet EEPROM-minne.
+* --quiet          Transmitterade tecken skrivs inte ut.
+*
+* Avslutningsvis skrivs statistik ut, såsom simulerad tid, antalet
+* transmitterade tecken samt antalet exekverade avbrott per vektor.
+******************************************************************************/
+
+#define HOST_MAX_COMMANDS 8
+#define HOST_PRESS_TIME 50	// Tid i millisekunder som tryckknappen hålls nedtryckt.
+
+static uint16_t adc = 154;	// Aktuellt resultat från AD-omvandlaren.
+static uint32_t ramp = 0;	// Millisekunder mellan ökningar av resultatet, 0 för oförändrat.
+static uint32_t elapsed = 0;	// Simulerad tid sedan start mätt i millisekunder.
+static uint64_t deadline = 0;	// Simulerad tid i klockcykler då föregående anrop av run skulle avslutas.
+
+// Statiska funktioner:
+static void quiet_output(const char data);
+static void run(const uint32_t ms);
+static void resume(void);
+static void send_command(const char* command);
+static void print_statistics(void);
+
+int main(int argc, char** argv)
+{
+	uint32_t presses = 5;
+	uint32_t interval = 5000;
+	uint32_t idle = 65000;
+	const char* commands[HOST_MAX_COMMANDS];
+	uint8_t number_of_commands = 0;
+	bool reboot = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char* value = i + 1 < argc ? argv[i + 1] : "0";
+
+		if (!strcmp(argv[i], "--presses")) presses = (uint32_t)strtoul(value, 0, 10), i++;
+		else if (!strcmp(argv[i], "--interval")) interval = (uint32_t)strtoul(value, 0, 10), i++;
+		else if (!strcmp(argv[i], "--idle")) idle = (uint32_t)strtoul(value, 0, 10), i++;
+		else if (!strcmp(argv[i], "--adc")) adc = (uint16_t)strtoul(value, 0, 10), i++;
+		else if (!strcmp(argv[i], "--ramp")) ramp = (uint32_t)strtoul(value, 0, 10), i++;
+		else if (!strcmp(argv[i], "--command") && number_of_commands < HOST_MAX_COMMANDS) commands[number_of_commands++] = value, i++;
+		else if (!strcmp(argv[i], "--reboot")) reboot = true;
+		else if (!strcmp(argv[i], "--quiet")) Simulator_set_output(quiet_output);
+
+		else
+		{
+			fprintf(stderr, "Usage: %s [--presses N] [--interval MS] [--idle MS] [--adc VALUE] [--ramp MS] [--command TEXT] [--reboot] [--quiet]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	Simulator_reset();
+	Simulator_set_adc(1, adc);
+	setup();
+
+	for (uint32_t i = 0; i < presses; i++)
+	{
+		run(interval - HOST_PRESS_TIME);
+		Simulator_set_pin('B', 5, 1);
+		run(HOST_PRESS_TIME);
+		Simulator_set_pin('B', 5, 0);
+	}
+
+	for (uint8_t i = 0; i < number_of_commands; i++)
+		send_command(commands[i]);
+
+	resume();
+	run(idle);
+
+	if (reboot)
+	{
+		Simulator_watchdog_reset();
+		setup();
+		resume();
+		run(idle);
+	}
+
+	Simulator_flush();
+	print_statistics();
+	return 0;
+}
+
+static void quiet_output(const char data)
+{
+	return;
+}
+
+/******************************************************************************
+* Funktionen run flyttar fram simulerad tid ett givet antal millisekunder,
+* där funktionen loop anropas efter varje millisekund. Tiden räknas från
+* föregående anrops sluttid, så att tid som programmet förbrukar i
+* väntelooper (exempelvis seriell överföring) inte förskjuter efterföljande
+* knapptryckningar. Resultatet från AD-omvandlaren ökas enligt argumentet
+* --ramp.
+******************************************************************************/
+static void run(const uint32_t ms)
+{
+	deadline += (uint64_t)ms * SIMULATOR_CYCLES_PER_MS;
+
+	while (Simulator_cycles() < deadline)
+	{
+		Simulator_advance_ms(1);
+		if (ramp && ++elapsed % ramp == 0 && adc < 1023) Simulator_set_adc(1, ++adc);
+		loop();
+	}
+	return;
+}
+
+/******************************************************************************
+* Funktionen resume låter nästa anrop av run räknas från aktuell simulerad
+* tid, ifall tidigare utskrifter har dragit över föregående anrops sluttid.
+* Används efter knapptryckningarna, så att kommandon och vilotid får
+* angiven längd.
+******************************************************************************/
+static void resume(void)
+{
+	if (deadline < Simulator_cycles()) deadline = Simulator_cycles();
+	return;
+}
+
+/******************************************************************************
+* Funktionen send_command skickar en kommandorad till konsolen tecken för
+* tecken, följt av radslut, och låter programmet exekvera kommandot.
+******************************************************************************/
+static void send_command(const char* command)
+{
+	resume();
+
+	while (*command)
+	{
+		Simulator_receive(*command++);
+	}
+
+	Simulator_receive('\n');
+	run(1);
+	return;
+}
+
+static void print_statistics(void)
+{
+	fflush(stdout);
+	fprintf(stderr, "\nSimulated time: %llu ms\n", (unsigned long long)(Simulator_cycles() / SIMULATOR_CYCLES_PER_MS));
+	fprintf(stderr, "Transmitted bytes: %lu\n", (unsigned long)Simulator_transmitted_bytes());
+	fprintf(stderr, "ADC conversions: %lu\n", (unsigned long)Simulator_adc_conversions());
+
+	for (uint8_t i = 0; i < SIMULATOR_VECTORS; i++)
+	{
+		if (Simulator_interrupt_count(i))
+			fprintf(stderr, "Interrupt vector %u: %lu\n", i, (unsigned long)Simulator_interrupt_count(i));
+	}
+	return;
+}
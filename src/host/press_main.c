@@ -0,0 +1,156 @@
+// Inkluderingsdirektiv:
+#include "../DynamicTimer.h"
+#include "PressTrace.h"
+#include <string.h>
+#include <time.h>
+
+/******************************************************************************
+* Simulering av den dynamiska timerns anpassning i accelererad tid. I stället
+* för att vänta in timergenererade avbrott mellan knapptryckningar räknas
+* antalet avbrott som skulle ha ägt rum fram till varje tryckning direkt
+* (intervall / timerns tid mellan avbrott), varefter DynamicTimer_update anropas precis
+* som i avbrottsrutinen för tryckknappen. Utskrifter ersätts av tomma
+* funktioner (se NullSerial.c). Följande argument kan anges:
+*
+* --mode MODE        Sekvenstyp: periodic, bursty, poisson, drift eller
+*                    file (standard periodic), se PressTrace.h.
+* --presses N        Antal tryckningar (standard 1000000).
+* --interval MS      Intervall, medelvärde eller startvärde (standard 5000).
+* --second MS        Paus mellan skurar eller slutvärde vid drift
+*                    (standard 20000).
+* --burst N          Antal tryckningar per skur (standard 5).
+* --seed N           Startvärde för slumptalsgeneratorn.
+* --file PATH        Fil med inspelade tidpunkter i millisekunder.
+* --capacity N       Den dynamiska timerns kapacitet (standard 60000).
+* --estimator NAME   Strategi för skattning av fördröjningstiden: mean,
+*                    trim, ewma, median eller qNN (se IntervalEstimator.h),
+*                    standard enligt INTERVAL_ESTIMATOR.
+* --report-every N   Skriver ut var N:e tryckning (standard 0, ingen).
+*
+* Vid utskrift per tryckning anges tryckningens index, simulerad tid i
+* sekunder, timerns period samt sant intervall i millisekunder och
+* periodens relativa fel i procent. Avslutningsvis skrivs en sammanfattning
+* ut: slutligt fel, genomsnittligt absolutfel, index efter vilket felet
+* varaktigt understiger PRESS_SETTLED_ERROR procent samt genomsnittlig tid
+* per uppdatering.
+******************************************************************************/
+
+#define PRESS_SETTLED_ERROR 10.0	// Felgräns i procent för insvängd period.
+
+// Statiska funktioner:
+static double period_ms(const struct DynamicTimer* self);
+static double now_ns(void);
+
+int main(int argc, char** argv)
+{
+	const char* mode = "periodic";
+	const char* path = 0;
+	uint32_t presses = 1000000;
+	double interval = 5000.0;
+	double second = 20000.0;
+	uint32_t burst_length = 5;
+	uint32_t seed = 0;
+	size_t capacity = 60000;
+	uint32_t report_every = 0;
+	const char* estimator = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char* value = i + 1 < argc ? argv[i + 1] : "0";
+
+		if (!strcmp(argv[i], "--mode")) mode = value, i++;
+		else if (!strcmp(argv[i], "--presses")) presses = (uint32_t)strtoul(value, 0, 10), i++;
+		else if (!strcmp(argv[i], "--interval")) interval = strtod(value, 0), i++;
+		else if (!strcmp(argv[i], "--second")) second = strtod(value, 0), i++;
+		else if (!strcmp(argv[i], "--burst")) burst_length = (uint32_t)strtoul(value, 0, 10), i++;
+		else if (!strcmp(argv[i], "--seed")) seed = (uint32_t)strtoul(value, 0, 10), i++;
+		else if (!strcmp(argv[i], "--file")) path = value, i++;
+		else if (!strcmp(argv[i], "--capacity")) capacity = (size_t)strtoul(value, 0, 10), i++;
+		else if (!strcmp(argv[i], "--estimator")) estimator = value, i++;
+		else if (!strcmp(argv[i], "--report-every")) report_every = (uint32_t)strtoul(value, 0, 10), i++;
+
+		else
+		{
+			fprintf(stderr, "Usage: %s [--mode periodic|bursty|poisson|drift|file] [--presses N] [--interval MS] "
+				"[--second MS] [--burst N] [--seed N] [--file PATH] [--capacity N] [--estimator NAME] [--report-every N]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	struct PressTrace trace = new_PressTrace(PressTrace_mode(mode), interval, second, presses);
+	if (burst_length) trace.burst_length = burst_length;
+	if (seed) trace.seed = seed;
+
+	if (trace.mode == PRESS_TRACE_FILE && !(trace.file = fopen(path ? path : "", "r")))
+	{
+		fprintf(stderr, "Could not read %s\n", path ? path : "(no file)");
+		return 1;
+	}
+
+	Simulator_reset();
+	struct DynamicTimer timer = new_DynamicTimer(TIMER1, capacity);
+	DynamicTimer_update(&timer);
+
+	if (estimator)
+	{
+		if (!strcmp(estimator, "mean")) DynamicTimer_set_estimator(&timer, ESTIMATOR_MEAN, 0);
+		else if (!strcmp(estimator, "trim")) DynamicTimer_set_estimator(&timer, ESTIMATOR_TRIMMED_MEAN, 0);
+		else if (!strcmp(estimator, "ewma")) DynamicTimer_set_estimator(&timer, ESTIMATOR_EWMA, 0);
+		else if (!strcmp(estimator, "median")) DynamicTimer_set_estimator(&timer, ESTIMATOR_MEDIAN, 0);
+		else if (estimator[0] == 'q') DynamicTimer_set_estimator(&timer, ESTIMATOR_QUANTILE, (uint8_t)atoi(estimator + 1));
+	}
+
+	fprintf(stderr, "Estimator: %s\n", IntervalEstimator_name(DynamicTimer_settings(&timer).estimator));
+	double elapsed_ns = 0.0;
+	double time_s = 0.0;
+	double error = 0.0;
+	double error_sum = 0.0;
+	uint32_t settled = 0;
+	uint32_t updates = 0;
+	double press_interval, target;
+
+	while (PressTrace_next(&trace, &press_interval, &target))
+	{
+		Atomic_add32(&timer.interrupt_counter, (uint32_t)(press_interval / timer.timer.interrupt_time + 0.5));
+		Atomic_add32(&timer.timer.executed_interrupts, (uint32_t)(press_interval / timer.timer.interrupt_time + 0.5));
+
+		const double start = now_ns();
+		DynamicTimer_update(&timer);
+		elapsed_ns += now_ns() - start;
+
+		time_s += press_interval / 1000.0;
+		error = (period_ms(&timer) - target) / target * 100.0;
+		error_sum += error < 0 ? -error : error;
+		if ((error < 0 ? -error : error) > PRESS_SETTLED_ERROR) settled = updates + 1;
+		updates++;
+
+		if (report_every && !(updates % report_every))
+			printf("%lu %.3f %.1f %.1f %.2f\n", (unsigned long)updates, time_s, period_ms(&timer), target, error);
+	}
+
+	if (trace.file) fclose(trace.file);
+	if (!updates) return 0;
+
+	fprintf(stderr, "Updates: %lu (%.1f simulated hours)\n", (unsigned long)updates, time_s / 3600.0);
+	fprintf(stderr, "Final period: %.1f ms (true interval %.1f ms, error %.2f %%)\n", period_ms(&timer), target, error);
+	fprintf(stderr, "Mean absolute error: %.2f %%\n", error_sum / updates);
+	fprintf(stderr, "Settled within %.0f %% after press: %lu\n", PRESS_SETTLED_ERROR, (unsigned long)settled);
+	fprintf(stderr, "Update cost: %.1f ns (%.2f million updates per second)\n", elapsed_ns / updates, updates / elapsed_ns * 1000.0);
+	return 0;
+}
+
+/******************************************************************************
+* Funktionen period_ms returnerar den dynamiska timerns aktuella period i
+* millisekunder, det vill säga tiden mellan temperaturmätningar.
+******************************************************************************/
+static double period_ms(const struct DynamicTimer* self)
+{
+	return self->timer.required_interrupts * (double)self->timer.interrupt_time;
+}
+
+static double now_ns(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec * 1e9 + time.tv_nsec;
+}
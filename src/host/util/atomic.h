@@ -0,0 +1,42 @@
+
+#ifndef HOST_UTIL_ATOMIC_H_
+#define HOST_UTIL_ATOMIC_H_
+
+/******************************************************************************
+* Ersätter avr-libc:s util/atomic.h vid kompilering för PC. Precis som på
+* mikrodatorn inaktiveras avbrott i början av blocket, medan statusregistret
+* SREG återställs vid blockets slut via attributet cleanup, även ifall
+* blocket lämnas via return eller break.
+******************************************************************************/
+
+// Inkluderingsdirektiv:
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+static inline uint8_t Simulator_atomic_begin(void)
+{
+	const uint8_t sreg = SREG;
+	cli();
+	return sreg;
+}
+
+static inline void Simulator_atomic_restore(const uint8_t* sreg)
+{
+	SREG = *sreg;
+	return;
+}
+
+static inline void Simulator_atomic_force_on(const uint8_t* sreg)
+{
+	sei();
+	return;
+}
+
+#define ATOMIC_RESTORESTATE uint8_t sreg_save __attribute__((__cleanup__(Simulator_atomic_restore))) = Simulator_atomic_begin()
+#define ATOMIC_FORCEON uint8_t sreg_save __attribute__((__cleanup__(Simulator_atomic_force_on))) = Simulator_atomic_begin()
+#define NONATOMIC_RESTORESTATE uint8_t sreg_save __attribute__((__cleanup__(Simulator_atomic_restore))) = SREG
+
+#define ATOMIC_BLOCK(type) for (type, atomic_todo = 1; atomic_todo; atomic_todo = 0)
+#define NONATOMIC_BLOCK(type) for (type, atomic_todo = 1; atomic_todo; atomic_todo = 0)
+
+#endif /* HOST_UTIL_ATOMIC_H_ */
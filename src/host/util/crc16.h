@@ -0,0 +1,46 @@
+
+#ifndef HOST_UTIL_CRC16_H_
+#define HOST_UTIL_CRC16_H_
+
+/******************************************************************************
+* Ersätter avr-libc:s util/crc16.h vid kompilering för PC, där
+* funktionerna implementeras i C enligt avr-libc:s dokumentation i stället
+* för optimerad assemblerkod. Resultaten är identiska med mikrodatorns.
+******************************************************************************/
+
+// Inkluderingsdirektiv:
+#include <stdint.h>
+
+/******************************************************************************
+* Funktionen _crc16_update uppdaterar en CRC-16 (polynom x^16 + x^15 + x^2
+* + 1, reflekterat 0xA001) med en byte data.
+******************************************************************************/
+static inline uint16_t _crc16_update(uint16_t crc, const uint8_t data)
+{
+	crc ^= data;
+
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		crc = (crc & 0x01) ? (uint16_t)((crc >> 1) ^ 0xA001) : (uint16_t)(crc >> 1);
+	}
+
+	return crc;
+}
+
+/******************************************************************************
+* Funktionen _crc8_ccitt_update uppdaterar en CRC-8 enligt CCITT
+* (polynom x^8 + x^2 + x + 1) med en byte data.
+******************************************************************************/
+static inline uint8_t _crc8_ccitt_update(uint8_t crc, const uint8_t data)
+{
+	crc ^= data;
+
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+	}
+
+	return crc;
+}
+
+#endif /* HOST_UTIL_CRC16_H_ */
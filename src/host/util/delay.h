@@ -0,0 +1,16 @@
+
+#ifndef HOST_UTIL_DELAY_H_
+#define HOST_UTIL_DELAY_H_
+
+/******************************************************************************
+* Ersätter avr-libc:s util/delay.h vid kompilering för PC. Fördröjningar
+* räknas som förbrukade klockcykler i simulatorn.
+******************************************************************************/
+
+// Inkluderingsdirektiv:
+#include "../Simulator.h"
+
+#define _delay_ms(ms) Simulator_busy((uint32_t)((ms) * (F_CPU / 1000UL)))
+#define _delay_us(us) Simulator_busy((uint32_t)((us) * (F_CPU / 1000000UL)))
+
+#endif /* HOST_UTIL_DELAY_H_ */
@@ -1,73 +1,276 @@
 // Inkluderingsdirektiv:
 #include "header.h"
 
+// Statiska funktioner:
+static void debounce_button(const bool pressed);
+static void measure_temperature(void);
+static inline uint16_t timer1_latency(void);
+
 /******************************************************************************
-* Avbrottsrutin för PCI-avbrott för I/O-port B. Vid aktivering av denna
-* avbrottsrutin inaktiveras PCI-avbrott på tryckknappens PIN 13, vilket i
-* detta fall är enda källan till PCI-avbrott på I/O-porten i fråga. Detta görs
-* för att förhindra påverkan av kontaktstudsar, som annars kan medför att 
-* multipla avbrott äger rum kort efter varandra när knappen studsar. Timer 0
-* aktiveras för att efter 300 ms återaktivera PCI-avbrott på PIN 13. Ifall
-* nedtryckning av tryckknappen orsakade aktuellt avbrott, så mäts aktuell
-* rumstemperatur och skrivs ut i en seriell terminal. För att indikera att
-* temperaturavläsning genomförs så togglas led1. Samtidigt nollställs Timer 1.
+* Avbrottsrutiner för PCI-avbrott för I/O-port B, C respektive D. Varje
+* avbrottsvektor delas av portens samtliga PINs, varför ändrade PINs
+* avgörs via PinChange_interrupt, som anropar registrerade
+* callbackfunktioner för respektive PIN (se PinChange.h). Tryckknappen på
+* PIN 13 är ansluten till I/O-port B, där nedtryckning hanteras av
+* funktionen button_pressed och släpp av funktionen button_released.
 ******************************************************************************/
 
 ISR (PCINT0_vect)
 {
-	Button_disable_interrupt(&button); 
-	Timer_on(&timer0); 
-	
-	if (Button_is_pressed(&button)) 
-	{
-		DynamicTimer_update(&timer1);
-		print_temperature(&tempSensor);		
-		Led_toggle(&led1);	
-	}
-	
+	CPU_LOAD_ENTER();
+	PROFILER_ENTER(PROFILER_PCINT0, 0);
+	PinChange_interrupt(IO_PORTB);
+	PROFILER_EXIT(PROFILER_PCINT0);
+	CPU_LOAD_EXIT();
+	return;
+}
+
+ISR (PCINT1_vect)
+{
+	CPU_LOAD_ENTER();
+	PinChange_interrupt(IO_PORTC);
+	CPU_LOAD_EXIT();
+	return;
+}
+
+ISR (PCINT2_vect)
+{
+	CPU_LOAD_ENTER();
+	PinChange_interrupt(IO_PORTD);
+	CPU_LOAD_EXIT();
 	return;
 }
 
 /******************************************************************************
-* Avbrottsrutin för Timer 0 i Normal Mode, vilket sker var 0.016:e millisekund
-* då timern i fråga är aktiverad. Denna avbrottsrutin används för att generera 
-* en bouncetid på 300 ms, där PCI-avbrott på PIN 13 hålls inaktiverat efter ett 
-* givet avbrott för att förhindra att multipla äger rum på grund av 
-* kontakstudsar. När tillräckligt många avbrott har ägt rum så att timern har 
-* löpt ut, så inaktiveras Timer 0 och PCI-avbrott på PIN 13 återaktiveras.
+* Funktionen button_pressed anropas från avbrottsrutinen vid nedtryckning
+* av tryckknappen, varvid bouncetiden startas. Därefter mäts aktuell
+* rumstemperatur via anrop av funktionen measure_temperature. Samtidigt
+* nollställs Timer 1.
 ******************************************************************************/
 
-ISR (TIMER0_OVF_vect)
+void button_pressed(void)
 {
-	Timer_count(&timer0);
-	
-	if (Timer_elapsed(&timer0)) 
-	{
-		Timer_off(&timer0); 
-		Button_enable_interrupt(&button); 	
-	}
-	
+	debounce_button(true);
+	DynamicTimer_update(&timer1);
+	measure_temperature();
 	return;
 }
 
 /******************************************************************************
-* Avbrottsrutin för Timer 1 i CTC Mode, vilket sker var 0.016:e millisekund då
+* Funktionen button_released anropas från avbrottsrutinen vid släpp av
+* tryckknappen, varvid bouncetiden startas.
+******************************************************************************/
+
+void button_released(void)
+{
+	debounce_button(false);
+	return;
+}
+
+/******************************************************************************
+* Funktionen debounce_button inaktiverar PCI-avbrott på tryckknappens PIN 13.
+* Detta görs för att förhindra påverkan av kontaktstudsar, som annars kan
+* medföra att multipla avbrott äger rum kort efter varandra när knappen
+* studsar. Kanalen debounce aktiveras för att efter 300 ms återaktivera
+* PCI-avbrott på PIN 13. Vid kompilering med makrot ENABLE_SAMPLED_DEBOUNCE
+* är händelsen redan filtrerad (se Debouncer.h), varför enbart händelsen
+* lagras i spårbufferten.
+******************************************************************************/
+
+static void debounce_button(const bool pressed)
+{
+#ifndef ENABLE_SAMPLED_DEBOUNCE
+	Button_disable_interrupt(&button);
+	TimerChannel_on(&debounce);
+#endif
+	TRACE(TRACE_BUTTON, pressed ? 1 : 0);
+	return;
+}
+
+/******************************************************************************
+* Avbrottsrutin för compare match A på Timer 2, vilket används av kanalen
+* debounce för att generera en bouncetid på 300 ms, där PCI-avbrott på PIN 13
+* hålls inaktiverat efter ett givet avbrott för att förhindra att multipla
+* äger rum på grund av kontaktstudsar. Eftersom Timer 2 räknar upp var
+* fjärde mikrosekund sker avbrott enbart en gång per varv (1.024 ms) tills
+* bouncetiden har löpt ut, då funktionen debounce_elapsed anropas.
+******************************************************************************/
+
+ISR (TIMER2_COMPA_vect)
+{
+	CPU_LOAD_ENTER();
+	PROFILER_ENTER(PROFILER_TIMER2_COMPA, (uint8_t)(TCNT2 - OCR2A));
+	TimerChannel_interrupt(TIMER2, CHANNEL_A);
+	PROFILER_EXIT(PROFILER_TIMER2_COMPA);
+	CPU_LOAD_EXIT();
+	return;
+}
+
+/******************************************************************************
+* Funktionen debounce_elapsed anropas från avbrottsrutinen då bouncetiden
+* har löpt ut, varvid kanalen debounce inaktiveras och PCI-avbrott på PIN 13
+* återaktiveras. Om tryckknappen har tryckts ned eller släppts under
+* bouncetiden anropas button_pressed respektive button_released direkt.
+******************************************************************************/
+
+void debounce_elapsed(void)
+{
+	TRACE(TRACE_DEBOUNCE, 0);
+	TimerChannel_off(&debounce);
+	Button_enable_interrupt(&button);
+	return;
+}
+
+/******************************************************************************
+* Avbrottsrutiner för övriga compare-kanaler, vilka anropar callbackfunktionen
+* för eventuell aktiverad kanal (se TimerChannel.h). Kanal A på Timer 1
+* saknas, då OCR1A utgör maxvärde för uppräkning i CTC Mode.
+* Vid kompilering med makrot ENABLE_SAMPLED_DEBOUNCE används kanal B på
+* Timer 2 för periodisk avläsning av tryckknapparna (se Debouncer.h).
+******************************************************************************/
+
+ISR (TIMER2_COMPB_vect)
+{
+	CPU_LOAD_ENTER();
+	TimerChannel_interrupt(TIMER2, CHANNEL_B);
+	CPU_LOAD_EXIT();
+	return;
+}
+
+ISR (TIMER1_COMPB_vect)
+{
+	CPU_LOAD_ENTER();
+	TimerChannel_interrupt(TIMER1, CHANNEL_B);
+	CPU_LOAD_EXIT();
+	return;
+}
+
+ISR (TIMER0_COMPA_vect)
+{
+	CPU_LOAD_ENTER();
+	TimerChannel_interrupt(TIMER0, CHANNEL_A);
+	CPU_LOAD_EXIT();
+	return;
+}
+
+ISR (TIMER0_COMPB_vect)
+{
+	CPU_LOAD_ENTER();
+	TimerChannel_interrupt(TIMER0, CHANNEL_B);
+	CPU_LOAD_EXIT();
+	return;
+}
+
+/******************************************************************************
+* Avbrottsrutin för Timer 1 i CTC Mode, vilket sker var 32.768:e millisekund då
 * timern i fråga är aktiverad. Denna avbrottsrutin används för att mäta
 * rumstemperaturen var 60:e sekund, alternativt 60 sekunder efter senaste
 * knapptryckning. Varje gång denna rutin aktiveras så räknas antalet exekverade 
 * avbrott upp. När tillräckligt många avbrott har ägt rum så att timern har löpt 
-* ut, så mäts rumstemperaturen och skrivs ut i terminalen. För att indikera att 
-* temperaturmätning genomförs så togglas lysdioden. 
+* ut, så mäts rumstemperaturen via anrop av funktionen measure_temperature.
+* Tidpunkten för utlöpningen lagras även för mätning av periodens
+* noggrannhet (se TimerJitter.h).
 ******************************************************************************/
 
 ISR (TIMER1_COMPA_vect)
 {
+	CPU_LOAD_ENTER();
+	PROFILER_ENTER(PROFILER_TIMER1_COMPA, timer1_latency());
 	DynamicTimer_count(&timer1);	
 	
 	if (DynamicTimer_elapsed(&timer1)) 
 	{
-		print_temperature(&tempSensor); 
-		Led_toggle(&led1); 
+		TRACE(TRACE_MEASUREMENT, 0);
+		TIMER_JITTER_EXPIRY(Timer_required(&timer1.timer));
+		measure_temperature();
 	}
+	
+	PROFILER_EXIT(PROFILER_TIMER1_COMPA);
+	CPU_LOAD_EXIT();
+	return;
+}
+
+/******************************************************************************
+* Funktionen timer1_latency returnerar antalet uppräkningar för Timer 1
+* sedan compare match, det vill säga avbrottets fördröjning för
+* profileraren. Räknaren nollställs vid compare match, varför värdet
+* utgörs av TCNT1 plus ett, där maxvärdet OCR1A motsvarar noll. Jämförelse
+* används i stället för modulo, så att ingen division sker i
+* avbrottsrutinen.
+******************************************************************************/
+static inline uint16_t timer1_latency(void)
+{
+	const uint16_t count = TCNT1 + 1;
+	return count > OCR1A ? 0 : count;
+}
+
+/******************************************************************************
+* Avbrottsrutin för overflow på Timer 2, vilket sker var 1.024:e millisekund.
+* Timer 2 används som fritt löpande klocka för tidsmätning, där antalet
+* overflow räknas upp i denna avbrottsrutin. Rutinen ingår inte i mätningen
+* av processorns belastning (se CpuLoad.h), eftersom klockan inte kan läsas
+* korrekt innan uppräkningen, och rutinen enbart räknar upp en variabel.
+******************************************************************************/
+
+ISR (TIMER2_OVF_vect)
+{
+	Clock_overflow();
+	return;
+}
+
+/******************************************************************************
+* Avbrottsrutin för seriell mottagning, vilket sker för varje tecken som tas
+* emot från PC. Mottaget tecken läses från dataregistret UDR0 och passeras
+* till konsolen, där tecknen lagras tills en hel kommandorad har tagits emot.
+******************************************************************************/
+
+ISR (USART_RX_vect)
+{
+	CPU_LOAD_ENTER();
+	Console_receive(UDR0);
+	CPU_LOAD_EXIT();
+	return;
+}
+
+/******************************************************************************
+* Avbrottsrutin för EEPROM Ready, vilket sker när EEPROM-minnet är redo för
+* nästa skrivning under en pågående asynkron skrivning (se Eeprom.h).
+******************************************************************************/
+
+ISR (EE_READY_vect)
+{
+	CPU_LOAD_ENTER();
+	Eeprom_interrupt();
+	CPU_LOAD_EXIT();
+	return;
+}
+
+/******************************************************************************
+* Funktionen measure_temperature begär en avläsning av aktuell
+* rumstemperatur, vilken utförs från huvudloopen utan att avbrottsrutinen
+* blockeras (se TemperatureReport.h).
+******************************************************************************/
+
+static void measure_temperature(void)
+{
+	TemperatureReport_request(&report);
+	return;
+}
+
+/******************************************************************************
+* Funktionen temperature_measured anropas från huvudloopen efter att
+* aktuell rumstemperatur har lästs av och skrivits ut i terminalen, varefter
+* mätvärdet lagras i historiken i RAM samt i EEPROM-loggen. Mätvärdet matas
+* även in i den adaptiva avläsningen, vars skalfaktor tillämpas på den
+* dynamiska timern när den ändras. För att indikera att temperaturmätning
+* genomförs så togglas led1.
+******************************************************************************/
+
+void temperature_measured(const int16_t temperature)
+{
+	History_append(temperature);
+	EepromLog_append(temperature);
+	if (AdaptiveSampling_update(&adaptive, temperature)) DynamicTimer_set_scale(&timer1, adaptive.scale);
+	Led_toggle(&led1);
 	return;
 }
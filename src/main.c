@@ -1,17 +1,25 @@
 // Inkluderingsdirektiv:
 #include "header.h"
+#include <avr/sleep.h>
 
 /******************************************************************************
 * Funktionen main utgör programmets start- och slutpunkt. Programmets globala
 * variabler initieras via anrop av funktionen setup. En while-sats används för
-* att hålla igång programmet så länge matningsspänning tillförs.
+* att hålla igång programmet så länge matningsspänning tillförs, där 
+* funktionen loop anropas kontinuerligt. Mellan varven sätts processorn i
+* viloläge (Idle), där timerkretsar, seriell överföring och AD-omvandlaren
+* fortsätter, tills nästa avbrott väcker processorn. Eftersom klockans
+* overflow sker var 1.024:e millisekund väntar huvudloopen som längst så
+* länge. Tiden i viloläge ingår i vilotiden (se CpuLoad.h).
 ******************************************************************************/
 int main(void)
 {	
 	setup();	
+	set_sleep_mode(SLEEP_MODE_IDLE);
     while(true)
 	{
-			
+		loop();
+		sleep_mode();
 	}
 	return 0;
 }
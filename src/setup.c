@@ -1,6 +1,29 @@
 /* Inkluderingsdirektiv: */
 #include "header.h"
 
+/******************************************************************************
+* Funktionen loop utgör ett varv i programmets huvudloop, där kommandon
+* mottagna via seriell överföring exekveras. Därefter fortsätter begärda
+* temperaturavläsningar (se TemperatureReport.h) utan att vänta. Tiden i
+* huvudloopen mäts via makrona CPU_LOAD_BEGIN samt CPU_LOAD_END (se
+* CpuLoad.h). Funktionen anropas kontinuerligt från main, samt periodiskt
+* från simulatorn vid kompilering för PC.
+******************************************************************************/
+void loop(void)
+{
+	CPU_LOAD_BEGIN();
+#ifdef ENABLE_WATCHDOG
+	wdt_reset();
+#endif
+	Console_process();
+	TemperatureReport_run(&report);
+	EepromLog_process();
+	DynamicTimer_report(&timer1);
+	Checkpoint_process(&timer1);
+	CPU_LOAD_END();
+	return;
+}
+
 static void init_GPIO(void);
 static void init_timers(void);
 static void init_analog(void);
@@ -11,25 +34,55 @@ static void init_analog(void);
 * som döps till led1. Sedan implementeras en tryckknapp på PIN 13 via ett 
 * objekt av struken Button, som döps till button. PCI-avbrott aktiveras på 
 * tryckknappens PIN för avläsning av aktuell rumstemperatur, där lysdioden
-* togglas vid varje avläsning.
+* togglas vid varje avläsning. Funktionerna button_pressed samt
+* button_released registreras för nedtryckning respektive släpp. Vid
+* kompilering med makrot ENABLE_SAMPLED_DEBOUNCE avläses tryckknappen i
+* stället periodiskt (se Debouncer.h), varvid PCI-avbrott inte aktiveras.
 * 
-* Därefter implementeras timerkretsen Timer 0, som används för att generera
-* en bouncetid på 300 ms efter nedtryckning av tryckknappar för att förhindra
-* att kontaktstudsar orsakar multipla avbrott. Ytterligare en timerkrets, 
+* Därefter implementeras compare-kanal A på Timer 2 (som även driver
+* klockan), som används för att generera en bouncetid på 300 ms efter
+* nedtryckning av tryckknappar för att förhindra att kontaktstudsar orsakar
+* multipla avbrott. Ytterligare en timerkrets, 
 * Timer 1, används för att mäta temperaturen med ett visst intervall, vilket
-* vid start är 60 sekunder. Därmed aktiveras denna timer direkt.
+* vid start är 60 sekunder. Därmed aktiveras denna timer direkt. Om en
+* giltig kontrollpunkt finns i EEPROM-minnet (se Checkpoint.h) återupptas
+* timerns inlärda fördröjningstid och skattning i stället.
 * Slutligen initeras seriell överföring via anrop av funktionen serial, 
 * vilket möjliggör transmission till PC.
+*
+* Allra först läses orsaken till senaste reset ur MCUSR, som sedan nollställs
+* och watchdog-timern inaktiveras (den förblir annars aktiv efter en
+* watchdog-reset). Om spårbufferten har behållits över reset skrivs den ut
+* efter startmeddelandet, så att förloppet fram till reset kan analyseras.
+* Vid kompilering med makrot ENABLE_WATCHDOG aktiveras därefter watchdog-
+* timern med två sekunders timeout, vilken återställs i huvudloopen.
 ******************************************************************************/
 
 void setup(void)
 {
+	const uint8_t reset_cause = MCUSR;
+	MCUSR = 0x00;
+	wdt_disable();
+	const bool retained = Trace_init(reset_cause);
+
 	init_serial();
+	init_clock();
 	init_GPIO();
 	init_timers();
 	init_analog();
+	init_EepromLog();
 	
 	serial_print("Dynamic temperature measurement system!\n");
+
+	if (retained)
+	{
+		serial_print("Trace before reset:\n");
+		Trace_print();
+	}
+
+#ifdef ENABLE_WATCHDOG
+	wdt_enable(WDTO_2S);
+#endif
 	return;
 }
 
@@ -37,25 +90,36 @@ static void init_GPIO(void)
 {
 	led1 = new_Led(9);	// I variabeln led1 lagras den instansierade struktmedlemmen self av datatypen struct Led. Variabeln led1 är global och har deklarerats i header.h.
 	button = new_Button(13);
+	Button_attach(&button, button_pressed, button_released);
+#ifdef ENABLE_SAMPLED_DEBOUNCE
+	init_Debouncer();
+#else
 	Button_enable_interrupt(&button);
+#endif
 	return;
 }
 
 static void init_timers(void)
 {
-	timer0 = new_Timer(TIMER0, 300);
+	debounce = new_TimerChannel(TIMER2, CHANNEL_A, 300, debounce_elapsed);
 	timer1 = new_DynamicTimer(TIMER1, 60000);
+	Checkpoint_restore(&timer1);
 	DynamicTimer_on(&timer1);
 	return;
 }
 
 /******************************************************************************
 * Deklarerar en temperatursensor ansluten till analog PIN A1 via ett objekt.
-* av strukten tempSensor.
+* av strukten tempSensor, där linjär sensormodell (tmp36_model) används.
+* Avläsningar sker via report, som anropar temperature_measured efter
+* varje avläsning. Adaptiv avläsning (se AdaptiveSampling.h) är avstängd
+* vid start.
 ******************************************************************************/
 static void init_analog(void)
 {
-	tempSensor = new_TempSensor(1);
+	tempSensor = new_TempSensor(1, &tmp36_model);
+	report = new_TemperatureReport(&tempSensor, temperature_measured);
+	adaptive = new_AdaptiveSampling();
 	return;
 }
 